@@ -71,11 +71,24 @@ public class BMesh : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"MeshDescription",
+				"StaticMeshDescription",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
 		
 		
+		// FDynamicMesh3 and UDynamicMesh are part of the engine runtime since UE5
+		if (Target.Version.MajorVersion >= 5)
+		{
+			PrivateDependencyModuleNames.AddRange(new string[] { "GeometryCore", "GeometryFramework" });
+			PublicDefinitions.Add("WITH_BMESH_DYNAMIC_MESH=1");
+		}
+		else
+		{
+			PublicDefinitions.Add("WITH_BMESH_DYNAMIC_MESH=0");
+		}
+		
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
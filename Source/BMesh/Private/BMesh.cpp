@@ -33,9 +33,20 @@
 #include "BMeshEdge.h"
 #include "BMeshLoop.h"
 #include "BMeshFace.h"
+#include "BMeshOperators.h"
 
 #include "BMeshLog.h"
 
+namespace
+{
+	// Constant time membership test, as elements know their position in their mesh's containers
+	template <typename T>
+	bool IsInContainer(const TArray<T*>& Container, const T* Element)
+	{
+		return Element != nullptr && Container.IsValidIndex(Element->Index) && Container[Element->Index] == Element;
+	}
+}
+
 UBMesh::UBMesh()
 {
 	VertexClass = UBMeshVertex::StaticClass();
@@ -47,7 +58,7 @@ UBMesh::UBMesh()
 UBMeshVertex* UBMesh::AddVertex(UBMeshVertex* vert)
 {
 	check(vert->GetOuter() == this);
-	Vertices.Add(vert);
+	AddToContainer(vert);
 	return vert;
 }
 
@@ -73,35 +84,11 @@ UBMeshEdge* UBMesh::AddEdge(UBMeshVertex* vert1, UBMeshVertex* vert2)
 	if (edge != nullptr) return edge;
 
 	edge = UBMeshEdge::MakeEdge(EdgeClass, vert1, vert2);
-	Edges.Add(edge);
+	AddToContainer(edge);
 
-	// Insert in vert1's edge list
-	if (vert1->Edge == nullptr)
-	{
-		vert1->Edge = edge;
-		edge->Next1 = edge->Prev1 = edge;
-	}
-	else
-	{
-		edge->Next1 = vert1->Edge->Next(vert1);
-		edge->Prev1 = vert1->Edge;
-		edge->Next1->SetPrev(vert1, edge);
-		edge->Prev1->SetNext(vert1, edge);
-	}
-
-	// Same for vert2 -- TODO avoid code duplication
-	if (vert2->Edge == nullptr)
-	{
-		vert2->Edge = edge;
-		edge->Next2 = edge->Prev2 = edge;
-	}
-	else
-	{
-		edge->Next2 = vert2->Edge->Next(vert2);
-		edge->Prev2 = vert2->Edge;
-		edge->Next2->SetPrev(vert2, edge);
-		edge->Prev2->SetNext(vert2, edge);
-	}
+	// Insert in both vertices' edge lists
+	edge->AppendToDisk(vert1);
+	edge->AppendToDisk(vert2);
 
 	return edge;
 }
@@ -118,7 +105,7 @@ UBMeshEdge* UBMesh::K2_AddEdge(UBMeshVertex* vert1, UBMeshVertex* vert2)
 		UE_LOG(LogBMesh, Error, TEXT("Can't make edge with invalid vertex"));
 		return nullptr;
 	}
-	if (!Vertices.Contains(vert1) || !Vertices.Contains(vert2))
+	if (!IsInContainer(Vertices, vert1) || !IsInContainer(Vertices, vert2))
 	{
 		UE_LOG(LogBMesh, Error, TEXT("One or both of the vertices are not owned by this mesh"));
 		return nullptr;
@@ -144,12 +131,12 @@ UBMeshFace* UBMesh::AddFace(TArrayView<UBMeshVertex* const> fVerts)
 	}
 
 	UBMeshFace* f = NewObject<UBMeshFace>(this, *FaceClass);
-	Faces.Add(f);
+	AddToContainer(f);
 
 	for (i = 0; i < fVerts.Num(); ++i)
 	{
 		UBMeshLoop* loop = UBMeshLoop::MakeLoop(LoopClass, fVerts[i], fEdges[i], f);
-		Loops.Add(loop);
+		AddToContainer(loop);
 	}
 
 	f->VertCount = fVerts.Num();
@@ -279,18 +266,18 @@ UBMeshEdge* UBMesh::K2_FindEdge(UBMeshVertex* vert1, UBMeshVertex* vert2)
 
 void UBMesh::RemoveVertex(UBMeshVertex* v)
 {
-	check(Vertices.Contains(v));
+	check(IsRemovalDeferred() || IsInContainer(Vertices, v));
 	while (v->Edge != nullptr)
 	{
 		RemoveEdge(v->Edge);
 	}
 
-	Vertices.Remove(v);
+	RemoveFromContainer(v);
 }
 
 bool UBMesh::K2_RemoveVertex(UBMeshVertex* v)
 {
-	if (Vertices.Contains(v))
+	if (IsInContainer(Vertices, v))
 	{
 		RemoveVertex(v);
 		return true;
@@ -301,29 +288,22 @@ bool UBMesh::K2_RemoveVertex(UBMeshVertex* v)
 
 void UBMesh::RemoveEdge(UBMeshEdge* e)
 {
-	check(Edges.Contains(e));
+	check(IsRemovalDeferred() || IsInContainer(Edges, e));
 	while (e->Loop != nullptr)
 	{
 		RemoveLoop(e->Loop);
 	}
 
-	// Remove reference in vertices
-	if (e == e->Vert1->Edge) e->Vert1->Edge = (e->Next1 != e ? e->Next1 : nullptr);
-	if (e == e->Vert2->Edge) e->Vert2->Edge = (e->Next2 != e ? e->Next2 : nullptr);
-
-	// Remove from linked lists
-	e->Prev1->SetNext(e->Vert1, e->Next1);
-	e->Next1->SetPrev(e->Vert1, e->Prev1);
+	// Remove from linked lists, and reference in vertices
+	e->RemoveFromDisk(e->Vert1);
+	e->RemoveFromDisk(e->Vert2);
 
-	e->Prev2->SetNext(e->Vert2, e->Next2);
-	e->Next2->SetPrev(e->Vert2, e->Prev2);
-
-	Edges.Remove(e);
+	RemoveFromContainer(e);
 }
 
 bool UBMesh::K2_RemoveEdge(UBMeshEdge* e)
 {
-	if (Edges.Contains(e))
+	if (IsInContainer(Edges, e))
 	{
 		RemoveEdge(e);
 		return true;
@@ -361,12 +341,12 @@ void UBMesh::RemoveLoop(UBMeshLoop* l)
 	l->Next = nullptr;
 	l->Prev = nullptr;
 
-	Loops.Remove(l);
+	RemoveFromContainer(l);
 }
 
 void UBMesh::RemoveFace(UBMeshFace* f)
 {
-	check(Faces.Contains(f));
+	check(IsRemovalDeferred() || IsInContainer(Faces, f));
 	UBMeshLoop* l = f->FirstLoop;
 	UBMeshLoop* nextL = nullptr;
 	while (nextL != f->FirstLoop)
@@ -376,12 +356,12 @@ void UBMesh::RemoveFace(UBMeshFace* f)
 		RemoveLoop(l);
 		l = nextL;
 	}
-	Faces.Remove(f);
+	RemoveFromContainer(f);
 }
 
 bool UBMesh::K2_RemoveFace(UBMeshFace* f)
 {
-	if (Faces.Contains(f))
+	if (IsInContainer(Faces, f))
 	{
 		RemoveFace(f);
 		return true;
@@ -390,6 +370,197 @@ bool UBMesh::K2_RemoveFace(UBMeshFace* f)
 	return false;
 }
 
+namespace
+{
+	template <typename T>
+	void AppendElement(TArray<T*>& Container, T* Element)
+	{
+		Element->Index = Container.Add(Element);
+	}
+
+	template <typename T>
+	void UpdateIndices(TArray<T*>& Container, int32 First)
+	{
+		for (int32 Index = First; Index < Container.Num(); ++Index)
+		{
+			Container[Index]->Index = Index;
+		}
+	}
+
+	template <typename T>
+	void RemoveOrDefer(TArray<T*>& Container, FBMeshAttributeLayers& Layers, TSet<T*>& DeferredRemovals, T* Element, bool bDefer)
+	{
+		if (bDefer)
+		{
+			DeferredRemovals.Add(Element);
+			return;
+		}
+		// The index can only be stale if the container was written to directly
+		int32 Index = Element->Index;
+		if (!Container.IsValidIndex(Index) || Container[Index] != Element)
+		{
+			Index = Container.Find(Element);
+		}
+		if (Index != INDEX_NONE)
+		{
+			Container.RemoveAt(Index);
+			Layers.RemoveElementAt(Index);
+			UpdateIndices(Container, Index);
+		}
+		Element->Index = INDEX_NONE;
+	}
+
+	template <typename T>
+	void FlushDeferred(TArray<T*>& Container, FBMeshAttributeLayers& Layers, TSet<T*>& DeferredRemovals)
+	{
+		if (DeferredRemovals.Num() > 0)
+		{
+			// Compact the container and renumber what is left in the same pass, layers are compacted afterwards
+			TArray<int32> KeptIndices;
+			int32 NumKept = 0;
+			for (int32 Index = 0; Index < Container.Num(); ++Index)
+			{
+				T* Element = Container[Index];
+				if (DeferredRemovals.Contains(Element))
+				{
+					Element->Index = INDEX_NONE;
+					continue;
+				}
+				if (!Layers.IsEmpty())
+				{
+					KeptIndices.Add(Index);
+				}
+				Element->Index = NumKept;
+				Container[NumKept++] = Element;
+			}
+			Container.SetNum(NumKept);
+			Layers.Gather(KeptIndices);
+			DeferredRemovals.Reset();
+		}
+	}
+}
+
+void UBMesh::AddToContainer(UBMeshVertex* v)
+{
+	AppendElement(Vertices, v);
+	VertexLayers.AddElement();
+	MarkTopologyChanged();
+	VertexSlots.Allocate(v);
+}
+
+void UBMesh::AddToContainer(UBMeshEdge* e)
+{
+	AppendElement(Edges, e);
+	EdgeLayers.AddElement();
+	MarkTopologyChanged();
+}
+
+void UBMesh::AddToContainer(UBMeshLoop* l)
+{
+	AppendElement(Loops, l);
+	LoopLayers.AddElement();
+	MarkTopologyChanged();
+}
+
+void UBMesh::AddToContainer(UBMeshFace* f)
+{
+	AppendElement(Faces, f);
+	FaceLayers.AddElement();
+	MarkTopologyChanged();
+	FaceSlots.Allocate(f);
+}
+
+void UBMesh::UpdateElementIndices()
+{
+	UpdateIndices(Vertices, 0);
+	UpdateIndices(Edges, 0);
+	UpdateIndices(Loops, 0);
+	UpdateIndices(Faces, 0);
+	MarkTopologyChanged();
+}
+
+FBMeshVertexHandle UBMesh::GetVertexHandle(const UBMeshVertex* v) const
+{
+	FBMeshVertexHandle Handle;
+	if (IsInContainer(Vertices, v))
+	{
+		Handle.Slot = v->Slot;
+		Handle.Generation = VertexSlots.GetGeneration(v);
+	}
+	return Handle;
+}
+
+UBMeshVertex* UBMesh::ResolveVertexHandle(FBMeshVertexHandle Handle) const
+{
+	return VertexSlots.Resolve(Handle.Slot, Handle.Generation);
+}
+
+FBMeshFaceHandle UBMesh::GetFaceHandle(const UBMeshFace* f) const
+{
+	FBMeshFaceHandle Handle;
+	if (IsInContainer(Faces, f))
+	{
+		Handle.Slot = f->Slot;
+		Handle.Generation = FaceSlots.GetGeneration(f);
+	}
+	return Handle;
+}
+
+UBMeshFace* UBMesh::ResolveFaceHandle(FBMeshFaceHandle Handle) const
+{
+	return FaceSlots.Resolve(Handle.Slot, Handle.Generation);
+}
+
+void UBMesh::RemoveFromContainer(UBMeshVertex* v)
+{
+	VertexSlots.Release(v);
+	MarkTopologyChanged();
+	RemoveOrDefer(Vertices, VertexLayers, DeferredVertexRemovals, v, IsRemovalDeferred());
+}
+
+void UBMesh::RemoveFromContainer(UBMeshEdge* e)
+{
+	MarkTopologyChanged();
+	RemoveOrDefer(Edges, EdgeLayers, DeferredEdgeRemovals, e, IsRemovalDeferred());
+}
+
+void UBMesh::RemoveFromContainer(UBMeshLoop* l)
+{
+	MarkTopologyChanged();
+	RemoveOrDefer(Loops, LoopLayers, DeferredLoopRemovals, l, IsRemovalDeferred());
+}
+
+void UBMesh::RemoveFromContainer(UBMeshFace* f)
+{
+	FaceSlots.Release(f);
+	MarkTopologyChanged();
+	RemoveOrDefer(Faces, FaceLayers, DeferredFaceRemovals, f, IsRemovalDeferred());
+}
+
+void UBMesh::FlushDeferredRemovals()
+{
+	FlushDeferred(Vertices, VertexLayers, DeferredVertexRemovals);
+	FlushDeferred(Edges, EdgeLayers, DeferredEdgeRemovals);
+	FlushDeferred(Loops, LoopLayers, DeferredLoopRemovals);
+	FlushDeferred(Faces, FaceLayers, DeferredFaceRemovals);
+}
+
+FBMeshDeferredRemovalScope::FBMeshDeferredRemovalScope(UBMesh* InMesh)
+	: Mesh(InMesh)
+{
+	check(Mesh);
+	++Mesh->DeferredRemovalDepth;
+}
+
+FBMeshDeferredRemovalScope::~FBMeshDeferredRemovalScope()
+{
+	check(Mesh->DeferredRemovalDepth > 0);
+	if (--Mesh->DeferredRemovalDepth == 0)
+	{
+		Mesh->FlushDeferredRemovals();
+	}
+}
+
 UBMesh::FMakeParams::FMakeParams()
 {
 	VertexClass = UBMeshVertex::StaticClass();
@@ -407,3 +578,15 @@ UBMesh* UBMesh::Make(UObject* Outer, FMakeParams Params)
 	NewMesh->FaceClass = Params.FaceClass;
 	return NewMesh;
 }
+
+UBMesh* UBMesh::Clone(UObject* Outer) const
+{
+	UBMesh* NewMesh = NewObject<UBMesh>(Outer ? Outer : GetTransientPackage(), GetClass());
+	NewMesh->VertexClass = VertexClass;
+	NewMesh->EdgeClass = EdgeClass;
+	NewMesh->LoopClass = LoopClass;
+	NewMesh->FaceClass = FaceClass;
+	// Merge only reads from the meshes it adds
+	FBMeshOperators::Merge(NewMesh, const_cast<UBMesh*>(this));
+	return NewMesh;
+}
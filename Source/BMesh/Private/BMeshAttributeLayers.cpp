@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshAttributeLayers.h"
+
+#include "Async/ParallelFor.h"
+
+#include "BMesh.h"
+#include "BMeshLog.h"
+
+namespace
+{
+	// Lerps per task of LerpBatch, small batches run on the calling thread
+	constexpr int32 LerpBatchSize = 4096;
+
+	template <typename T>
+	TArray<T> GetLayerValues(const UBMesh* Mesh, EBMeshElementType ElementType, FName Name)
+	{
+		if (const TBMeshAttributeLayer<T>* Layer = Mesh->GetAttributeLayers(ElementType).Find<T>(Name))
+		{
+			return Layer->Values;
+		}
+		UE_LOG(LogBMesh, Warning, TEXT("%s has no attribute layer %s of this type"), *Mesh->GetName(), *Name.ToString());
+		return TArray<T>();
+	}
+
+	template <typename T>
+	bool SetLayerValues(UBMesh* Mesh, EBMeshElementType ElementType, FName Name, const TArray<T>& Values)
+	{
+		TBMeshAttributeLayer<T>* Layer = Mesh->GetAttributeLayers(ElementType).Find<T>(Name);
+		if (Layer == nullptr)
+		{
+			UE_LOG(LogBMesh, Error, TEXT("%s has no attribute layer %s of this type"), *Mesh->GetName(), *Name.ToString());
+			return false;
+		}
+		if (Values.Num() != Layer->Num())
+		{
+			UE_LOG(LogBMesh, Error, TEXT("Can't set attribute layer %s with %d values, it has %d elements"), *Name.ToString(), Values.Num(), Layer->Num());
+			return false;
+		}
+		Layer->Values = Values;
+		return true;
+	}
+}
+
+TUniquePtr<FBMeshAttributeLayer> FBMeshAttributeLayer::Make(FName Name, EBMeshAttributeType Type)
+{
+	switch (Type)
+	{
+	case EBMeshAttributeType::Float: return MakeUnique<TBMeshAttributeLayer<float>>(Name);
+	case EBMeshAttributeType::Int: return MakeUnique<TBMeshAttributeLayer<int32>>(Name);
+	case EBMeshAttributeType::Vector: return MakeUnique<TBMeshAttributeLayer<FVector>>(Name);
+	case EBMeshAttributeType::Vector2D: return MakeUnique<TBMeshAttributeLayer<FVector2D>>(Name);
+	case EBMeshAttributeType::Vector4: return MakeUnique<TBMeshAttributeLayer<FVector4>>(Name);
+	case EBMeshAttributeType::LinearColor: return MakeUnique<TBMeshAttributeLayer<FLinearColor>>(Name);
+	}
+	return nullptr;
+}
+
+FBMeshAttributeLayer* FBMeshAttributeLayers::Add(FName Name, EBMeshAttributeType Type, int32 NumElements)
+{
+	if (FBMeshAttributeLayer* Existing = Find(Name))
+	{
+		if (Existing->GetType() != Type)
+		{
+			UE_LOG(LogBMesh, Error, TEXT("Attribute layer %s already exists with another type"), *Name.ToString());
+			return nullptr;
+		}
+		return Existing;
+	}
+	TUniquePtr<FBMeshAttributeLayer> Layer = FBMeshAttributeLayer::Make(Name, Type);
+	if (!Layer)
+		return nullptr;
+	Layer->SetNum(NumElements);
+	return Layers.Add_GetRef(MoveTemp(Layer)).Get();
+}
+
+FBMeshAttributeLayer* FBMeshAttributeLayers::Find(FName Name) const
+{
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		if (Layer->GetName() == Name)
+			return Layer.Get();
+	}
+	return nullptr;
+}
+
+bool FBMeshAttributeLayers::Remove(FName Name)
+{
+	return Layers.RemoveAll([Name](const TUniquePtr<FBMeshAttributeLayer>& Layer) { return Layer->GetName() == Name; }) > 0;
+}
+
+void FBMeshAttributeLayers::AddElement()
+{
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		Layer->SetNum(Layer->Num() + 1);
+	}
+}
+
+void FBMeshAttributeLayers::RemoveElementAt(int32 Index)
+{
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		Layer->RemoveAt(Index);
+	}
+}
+
+void FBMeshAttributeLayers::Gather(const TArray<int32>& Sources)
+{
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		Layer->Gather(Sources);
+	}
+}
+
+void FBMeshAttributeLayers::Copy(int32 Destination, int32 Source)
+{
+	if (Destination == INDEX_NONE || Source == INDEX_NONE)
+		return;
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		Layer->Copy(Destination, Source);
+	}
+}
+
+void FBMeshAttributeLayers::Lerp(int32 Destination, int32 A, int32 B, float Alpha)
+{
+	if (Destination == INDEX_NONE || A == INDEX_NONE || B == INDEX_NONE)
+		return;
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		Layer->Lerp(Destination, A, B, Alpha);
+	}
+}
+
+void FBMeshAttributeLayers::LerpBatch(TArrayView<const FBMeshAttributeLerp> Lerps)
+{
+	const int32 NumBatches = FMath::DivideAndRoundUp(Lerps.Num(), LerpBatchSize);
+	for (const TUniquePtr<FBMeshAttributeLayer>& Layer : Layers)
+	{
+		ParallelFor(NumBatches, [&](int32 Batch)
+		{
+			const int32 First = Batch * LerpBatchSize;
+			Layer->LerpBatch(Lerps.Slice(First, FMath::Min(LerpBatchSize, Lerps.Num() - First)));
+		}, NumBatches == 1);
+	}
+}
+
+void FBMeshAttributeLayers::Append(const FBMeshAttributeLayers& Other, int32 FirstElement, int32 NumElements)
+{
+	for (const TUniquePtr<FBMeshAttributeLayer>& OtherLayer : Other.Layers)
+	{
+		FBMeshAttributeLayer* Layer = Find(OtherLayer->GetName());
+		if (Layer == nullptr)
+		{
+			Layer = Add(OtherLayer->GetName(), OtherLayer->GetType(), FirstElement + NumElements);
+		}
+		if (Layer->GetType() != OtherLayer->GetType() || !ensure(OtherLayer->Num() == NumElements))
+			continue;
+		for (int32 i = 0; i < NumElements; ++i)
+		{
+			Layer->CopyFrom(*OtherLayer, FirstElement + i, i);
+		}
+	}
+}
+
+void FBMeshAttributeLayers::Serialize(FArchive& Ar, int32 NumElements)
+{
+	int32 NumLayers = Layers.Num();
+	Ar << NumLayers;
+	if (Ar.IsLoading())
+	{
+		Layers.Reset();
+	}
+	for (int32 i = 0; i < NumLayers && !Ar.IsError(); ++i)
+	{
+		FName Name;
+		uint8 Type = 0;
+		if (Ar.IsSaving())
+		{
+			Name = Layers[i]->GetName();
+			Type = uint8(Layers[i]->GetType());
+		}
+		Ar << Name << Type;
+		if (!Ar.IsLoading())
+		{
+			Layers[i]->Serialize(Ar);
+			continue;
+		}
+
+		TUniquePtr<FBMeshAttributeLayer> Layer = FBMeshAttributeLayer::Make(Name, EBMeshAttributeType(Type));
+		if (!Layer)
+		{
+			UE_LOG(LogBMesh, Error, TEXT("%s: attribute layer %s has an unknown type, the following layers are discarded"), *Ar.GetArchiveName(), *Name.ToString());
+			Ar.SetError();
+			return;
+		}
+		Layer->Serialize(Ar);
+		if (Layer->Num() != NumElements)
+		{
+			UE_LOG(LogBMesh, Warning, TEXT("%s: attribute layer %s doesn't match its elements, its values are discarded"), *Ar.GetArchiveName(), *Name.ToString());
+			continue;
+		}
+		Layers.Add(MoveTemp(Layer));
+	}
+}
+
+FBMeshAttributeLayers& UBMesh::GetAttributeLayers(EBMeshElementType ElementType)
+{
+	return const_cast<FBMeshAttributeLayers&>(static_cast<const UBMesh*>(this)->GetAttributeLayers(ElementType));
+}
+
+const FBMeshAttributeLayers& UBMesh::GetAttributeLayers(EBMeshElementType ElementType) const
+{
+	switch (ElementType)
+	{
+	case EBMeshElementType::Vertex: return VertexLayers;
+	case EBMeshElementType::Edge: return EdgeLayers;
+	case EBMeshElementType::Loop: return LoopLayers;
+	default: return FaceLayers;
+	}
+}
+
+int32 UBMesh::GetNumElements(EBMeshElementType ElementType) const
+{
+	switch (ElementType)
+	{
+	case EBMeshElementType::Vertex: return Vertices.Num();
+	case EBMeshElementType::Edge: return Edges.Num();
+	case EBMeshElementType::Loop: return Loops.Num();
+	default: return Faces.Num();
+	}
+}
+
+bool UBMesh::AddAttributeLayer(EBMeshElementType ElementType, FName Name, EBMeshAttributeType Type)
+{
+	return GetAttributeLayers(ElementType).Add(Name, Type, GetNumElements(ElementType)) != nullptr;
+}
+
+bool UBMesh::RemoveAttributeLayer(EBMeshElementType ElementType, FName Name)
+{
+	return GetAttributeLayers(ElementType).Remove(Name);
+}
+
+bool UBMesh::HasAttributeLayer(EBMeshElementType ElementType, FName Name) const
+{
+	return GetAttributeLayers(ElementType).Find(Name) != nullptr;
+}
+
+TArray<float> UBMesh::GetFloatAttribute(EBMeshElementType ElementType, FName Name) const
+{
+	return GetLayerValues<float>(this, ElementType, Name);
+}
+
+TArray<int32> UBMesh::GetIntAttribute(EBMeshElementType ElementType, FName Name) const
+{
+	return GetLayerValues<int32>(this, ElementType, Name);
+}
+
+TArray<FVector> UBMesh::GetVectorAttribute(EBMeshElementType ElementType, FName Name) const
+{
+	return GetLayerValues<FVector>(this, ElementType, Name);
+}
+
+TArray<FVector2D> UBMesh::GetVector2DAttribute(EBMeshElementType ElementType, FName Name) const
+{
+	return GetLayerValues<FVector2D>(this, ElementType, Name);
+}
+
+TArray<FVector4> UBMesh::GetVector4Attribute(EBMeshElementType ElementType, FName Name) const
+{
+	return GetLayerValues<FVector4>(this, ElementType, Name);
+}
+
+TArray<FLinearColor> UBMesh::GetLinearColorAttribute(EBMeshElementType ElementType, FName Name) const
+{
+	return GetLayerValues<FLinearColor>(this, ElementType, Name);
+}
+
+bool UBMesh::SetFloatAttribute(EBMeshElementType ElementType, FName Name, const TArray<float>& Values)
+{
+	return SetLayerValues(this, ElementType, Name, Values);
+}
+
+bool UBMesh::SetIntAttribute(EBMeshElementType ElementType, FName Name, const TArray<int32>& Values)
+{
+	return SetLayerValues(this, ElementType, Name, Values);
+}
+
+bool UBMesh::SetVectorAttribute(EBMeshElementType ElementType, FName Name, const TArray<FVector>& Values)
+{
+	return SetLayerValues(this, ElementType, Name, Values);
+}
+
+bool UBMesh::SetVector2DAttribute(EBMeshElementType ElementType, FName Name, const TArray<FVector2D>& Values)
+{
+	return SetLayerValues(this, ElementType, Name, Values);
+}
+
+bool UBMesh::SetVector4Attribute(EBMeshElementType ElementType, FName Name, const TArray<FVector4>& Values)
+{
+	return SetLayerValues(this, ElementType, Name, Values);
+}
+
+bool UBMesh::SetLinearColorAttribute(EBMeshElementType ElementType, FName Name, const TArray<FLinearColor>& Values)
+{
+	return SetLayerValues(this, ElementType, Name, Values);
+}
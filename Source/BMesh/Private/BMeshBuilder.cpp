@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshBuilder.h"
+
+#include "BMeshCore.h"
+
+FBMeshBuilder::FBMeshBuilder(UBMesh* InMesh)
+	: Mesh(InMesh)
+{
+	check(Mesh);
+	EdgeMap.Reserve(Mesh->Edges.Num());
+	for (UBMeshEdge* Edge : Mesh->Edges)
+	{
+		EdgeMap.Add(MakeEdgeKey(Edge->Vert1, Edge->Vert2), Edge);
+	}
+}
+
+void FBMeshBuilder::Reserve(int32 NumVertices, int32 NumEdges, int32 NumLoops, int32 NumFaces)
+{
+	Mesh->Vertices.Reserve(Mesh->Vertices.Num() + NumVertices);
+	Mesh->Edges.Reserve(Mesh->Edges.Num() + NumEdges);
+	Mesh->Loops.Reserve(Mesh->Loops.Num() + NumLoops);
+	Mesh->Faces.Reserve(Mesh->Faces.Num() + NumFaces);
+	EdgeMap.Reserve(EdgeMap.Num() + NumEdges);
+}
+
+UBMeshVertex* FBMeshBuilder::AddVertex(const FVector& Location)
+{
+	return Mesh->AddVertex(Location);
+}
+
+UBMeshEdge* FBMeshBuilder::AddEdge(UBMeshVertex* Vertex1, UBMeshVertex* Vertex2)
+{
+	check(Vertex1 != Vertex2);
+	check(Vertex1->GetOuter() == Mesh && Vertex2->GetOuter() == Mesh);
+
+	UBMeshEdge*& Edge = EdgeMap.FindOrAdd(MakeEdgeKey(Vertex1, Vertex2));
+	if (Edge == nullptr)
+	{
+		Edge = UBMeshEdge::MakeEdge(Mesh->EdgeClass, Vertex1, Vertex2);
+		Mesh->AddToContainer(Edge);
+		Edge->AppendToDisk(Vertex1);
+		Edge->AppendToDisk(Vertex2);
+	}
+	return Edge;
+}
+
+UBMeshEdge* FBMeshBuilder::AddEdge(int32 Vertex1, int32 Vertex2)
+{
+	return AddEdge(Mesh->Vertices[Vertex1], Mesh->Vertices[Vertex2]);
+}
+
+UBMeshFace* FBMeshBuilder::AddFace(TArrayView<UBMeshVertex* const> FaceVertices)
+{
+	check(FaceVertices.Num() >= 2);
+
+	TArray<UBMeshEdge*, TInlineAllocator<8>> FaceEdges;
+	FaceEdges.SetNumUninitialized(FaceVertices.Num());
+	for (int32 i = 0, i_prev = FaceVertices.Num() - 1; i < FaceVertices.Num(); i_prev = i++)
+	{
+		FaceEdges[i_prev] = AddEdge(FaceVertices[i_prev], FaceVertices[i]);
+	}
+
+	UBMeshFace* Face = NewObject<UBMeshFace>(Mesh, *Mesh->FaceClass);
+	Mesh->AddToContainer(Face);
+	for (int32 i = 0; i < FaceVertices.Num(); ++i)
+	{
+		Mesh->AddToContainer(UBMeshLoop::MakeLoop(Mesh->LoopClass, FaceVertices[i], FaceEdges[i], Face));
+	}
+	Face->VertCount = FaceVertices.Num();
+	return Face;
+}
+
+UBMeshFace* FBMeshBuilder::AddFace(TArrayView<const int32> VertexIndices)
+{
+	FaceVertexBuffer.Reset();
+	for (int32 Index : VertexIndices)
+	{
+		FaceVertexBuffer.Add(Mesh->Vertices[Index]);
+	}
+	return AddFace(FaceVertexBuffer);
+}
@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshConversion.h"
+
+#include "Async/ParallelFor.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#if WITH_EDITOR
+#include "Engine/StaticMesh.h"
+#endif
+#include "Runtime/Launch/Resources/Version.h"
+#if WITH_BMESH_DYNAMIC_MESH
+#include "DynamicMesh/DynamicMesh3.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "UDynamicMesh.h"
+#endif
+
+#include "BMeshCore.h"
+#include "BMeshLog.h"
+#include "BMeshTriangulation.h"
+#include "BMeshBuilder.h"
+
+namespace
+{
+	// Mesh descriptions store single precision attributes since large world coordinates
+#if ENGINE_MAJOR_VERSION >= 5
+	using FDescriptionVector2 = FVector2f;
+	using FDescriptionVector = FVector3f;
+	using FDescriptionVector4 = FVector4f;
+#else
+	using FDescriptionVector2 = FVector2D;
+	using FDescriptionVector = FVector;
+	using FDescriptionVector4 = FVector4;
+#endif
+
+	/**
+	 * A struct attribute of each loop, from the loop class if it has it or else from the vertex class,
+	 * so that per vertex attributes can be converted without duplicating them on loops.
+	 */
+	template <typename T>
+	class TLoopAttribute
+	{
+	public:
+		TLoopAttribute(const UBMesh* Mesh, FName Name, bool bSearchLoopClass = true)
+		{
+			if (Name.IsNone())
+				return;
+			if (bSearchLoopClass)
+			{
+				Property = FindTypedProperty(Mesh->LoopClass, Name);
+			}
+			if (!Property)
+			{
+				Property = FindTypedProperty(Mesh->VertexClass, Name);
+				bOnVertex = Property != nullptr;
+			}
+		}
+
+		explicit operator bool() const { return Property != nullptr; }
+
+		const T& Get(const UBMeshLoop* Loop) const
+		{
+			const UObject* Owner = bOnVertex ? static_cast<const UObject*>(Loop->Vert) : Loop;
+			return *Property->ContainerPtrToValuePtr<T>(Owner);
+		}
+
+		const T& Get(const UBMeshVertex* Vertex) const
+		{
+			check(bOnVertex);
+			return *Property->ContainerPtrToValuePtr<T>(Vertex);
+		}
+
+		T& GetMutable(UObject* Element) const
+		{
+			return *Property->ContainerPtrToValuePtr<T>(Element);
+		}
+
+		bool IsOnVertex() const { return bOnVertex; }
+
+	private:
+		static const FStructProperty* FindTypedProperty(UClass* Class, FName Name)
+		{
+			const FStructProperty* Found = Class ? CastField<FStructProperty>(Class->FindPropertyByName(Name)) : nullptr;
+			return Found && Found->Struct == TBaseStructure<T>::Get() ? Found : nullptr;
+		}
+
+		const FStructProperty* Property = nullptr;
+		bool bOnVertex = false;
+	};
+
+	TArray<int32> GetLoopVertexIndices(const UBMesh* Mesh, const FBMeshTriangulation& Triangulation)
+	{
+		TArray<int32> LoopVertices;
+		LoopVertices.SetNumUninitialized(Triangulation.Loops.Num());
+		ParallelFor(LoopVertices.Num(), [&](int32 i)
+		{
+			LoopVertices[i] = Triangulation.Loops[i]->Vert->Index;
+		});
+		return LoopVertices;
+	}
+
+	template <typename TAttributesRef>
+	int32 GetNumChannels(const TAttributesRef& Attribute)
+	{
+#if ENGINE_MAJOR_VERSION >= 5
+		return Attribute.GetNumChannels();
+#else
+		return Attribute.GetNumIndices();
+#endif
+	}
+
+	/**
+	 * Fill a buffer with one value per buffer vertex, read from loops or vertices depending on the split
+	 */
+	template <typename TValue, typename TAttribute, typename TConvert>
+	void ReadSectionAttribute(const UBMesh* Mesh, const FBMeshTriangulation& Triangulation, bool bPerLoop, const TLoopAttribute<TAttribute>& Reader, TArray<TValue>& Values, TConvert Convert)
+	{
+		const int32 Num = bPerLoop ? Triangulation.Loops.Num() : Mesh->Vertices.Num();
+		Values.SetNumUninitialized(Num);
+		ParallelFor(Num, [&](int32 i)
+		{
+			Values[i] = Convert(bPerLoop ? Reader.Get(Triangulation.Loops[i]) : Reader.Get(Mesh->Vertices[i]));
+		});
+	}
+}
+
+void FBMeshConversion::ToMeshDescription(const UBMesh* Mesh, FMeshDescription& MeshDescription, const FBMeshConversionOptions& Options)
+{
+	check(Mesh);
+	const FBMeshTriangulation Triangulation = FBMeshTriangulation::Build(Mesh);
+	const TArray<int32> LoopVertices = GetLoopVertexIndices(Mesh, Triangulation);
+	const int32 NumVertices = Mesh->Vertices.Num();
+	const int32 NumLoops = Triangulation.Loops.Num();
+	const int32 NumTriangles = Triangulation.Triangles.Num();
+
+	MeshDescription.Empty();
+	FStaticMeshAttributes Attributes(MeshDescription);
+	Attributes.Register();
+
+	MeshDescription.ReserveNewVertices(NumVertices);
+	MeshDescription.ReserveNewVertexInstances(NumLoops);
+	// Mesh edges plus the diagonals added by the triangulation
+	MeshDescription.ReserveNewEdges(Mesh->Edges.Num() + NumTriangles - Triangulation.NumFaces());
+	MeshDescription.ReserveNewTriangles(NumTriangles);
+	MeshDescription.ReserveNewPolygons(NumTriangles);
+
+	// IDs of an empty description are allocated in order, so element i gets ID i, and attributes
+	// can be written in parallel once the topology is created
+	for (int32 i = 0; i < NumVertices; ++i)
+	{
+		MeshDescription.CreateVertex();
+	}
+	for (int32 i = 0; i < NumLoops; ++i)
+	{
+		MeshDescription.CreateVertexInstance(FVertexID(LoopVertices[i]));
+	}
+	const FPolygonGroupID PolygonGroup = MeshDescription.CreatePolygonGroup();
+	Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = TEXT("BMesh");
+	for (const FIntVector& Triangle : Triangulation.Triangles)
+	{
+		const FVertexInstanceID Corners[3] = { FVertexInstanceID(Triangle.X), FVertexInstanceID(Triangle.Y), FVertexInstanceID(Triangle.Z) };
+		MeshDescription.CreateTriangle(PolygonGroup, MakeArrayView(Corners));
+	}
+
+	auto Positions = Attributes.GetVertexPositions();
+	ParallelFor(NumVertices, [&](int32 i)
+	{
+		Positions[FVertexID(i)] = FDescriptionVector(Mesh->Vertices[i]->Location);
+	});
+
+	const TLoopAttribute<FVector2D> UVReader(Mesh, Options.UVAttribute);
+	const TLoopAttribute<FVector> NormalReader(Mesh, Options.NormalAttribute);
+	const TLoopAttribute<FLinearColor> ColorReader(Mesh, Options.ColorAttribute);
+	auto UVs = Attributes.GetVertexInstanceUVs();
+	auto Normals = Attributes.GetVertexInstanceNormals();
+	auto Colors = Attributes.GetVertexInstanceColors();
+	ParallelFor(NumLoops, [&](int32 i)
+	{
+		const UBMeshLoop* Loop = Triangulation.Loops[i];
+		const FVertexInstanceID VertexInstance(i);
+		if (UVReader)
+		{
+			UVs.Set(VertexInstance, 0, FDescriptionVector2(UVReader.Get(Loop)));
+		}
+		if (NormalReader)
+		{
+			Normals[VertexInstance] = FDescriptionVector(NormalReader.Get(Loop));
+		}
+		if (ColorReader)
+		{
+			Colors[VertexInstance] = FDescriptionVector4(ColorReader.Get(Loop));
+		}
+	});
+}
+
+void FBMeshConversion::ToMeshSection(const UBMesh* Mesh, FBMeshSectionBuffers& Buffers, const FBMeshSectionOptions& Options)
+{
+	check(Mesh);
+	const FBMeshTriangulation Triangulation = FBMeshTriangulation::Build(Mesh, Options.TriangulationMethod);
+	const TArray<int32> LoopVertices = GetLoopVertexIndices(Mesh, Triangulation);
+	const bool bPerLoop = Options.Split == EBMeshSectionSplit::PerLoop;
+	const int32 NumFaces = Triangulation.NumFaces();
+
+	Buffers.SourceMesh = Mesh;
+	Buffers.MeshTopologyRevision = Mesh->GetTopologyRevision();
+	if (bPerLoop)
+	{
+		Buffers.SourceVertices = LoopVertices;
+	}
+	else
+	{
+		Buffers.SourceVertices.SetNumUninitialized(Mesh->Vertices.Num());
+		for (int32 i = 0; i < Buffers.SourceVertices.Num(); ++i)
+		{
+			Buffers.SourceVertices[i] = i;
+		}
+	}
+	const int32 NumBufferVertices = Buffers.SourceVertices.Num();
+
+	Buffers.Positions.SetNumUninitialized(NumBufferVertices);
+	ParallelFor(NumBufferVertices, [&](int32 i)
+	{
+		Buffers.Positions[i] = Mesh->Vertices[Buffers.SourceVertices[i]]->Location;
+	});
+
+	Buffers.Triangles.SetNumUninitialized(Triangulation.Triangles.Num() * 3);
+	ParallelFor(Triangulation.Triangles.Num(), [&](int32 i)
+	{
+		const FIntVector& Triangle = Triangulation.Triangles[i];
+		for (int32 Corner = 0; Corner < 3; ++Corner)
+		{
+			Buffers.Triangles[i * 3 + Corner] = bPerLoop ? Triangle[Corner] : LoopVertices[Triangle[Corner]];
+		}
+	});
+
+	const TLoopAttribute<FVector2D> UVReader(Mesh, Options.UVAttribute, bPerLoop);
+	const TLoopAttribute<FVector> NormalReader(Mesh, Options.NormalAttribute, bPerLoop);
+	const TLoopAttribute<FLinearColor> ColorReader(Mesh, Options.ColorAttribute, bPerLoop);
+	if (UVReader)
+	{
+		ReadSectionAttribute(Mesh, Triangulation, bPerLoop, UVReader, Buffers.UVs, [](const FVector2D& UV) { return UV; });
+	}
+	else
+	{
+		Buffers.UVs.Reset();
+	}
+	if (ColorReader)
+	{
+		ReadSectionAttribute(Mesh, Triangulation, bPerLoop, ColorReader, Buffers.Colors, [](const FLinearColor& Color) { return Color.ToFColor(true); });
+	}
+	else
+	{
+		Buffers.Colors.Reset();
+	}
+
+	if (NormalReader)
+	{
+		ReadSectionAttribute(Mesh, Triangulation, bPerLoop, NormalReader, Buffers.Normals, [](const FVector& Normal) { return Normal; });
+		return;
+	}
+
+	// Face normals scaled by twice the face area, so that smooth normals are area weighted
+	TArray<FVector> FaceNormals;
+	FaceNormals.SetNumUninitialized(NumFaces);
+	ParallelFor(NumFaces, [&](int32 FaceIndex)
+	{
+		FVector Normal = FVector::ZeroVector;
+		const int32 First = Triangulation.LoopOffsets[FaceIndex];
+		const int32 Last = Triangulation.LoopOffsets[FaceIndex + 1] - 1;
+		for (int32 i = First, i_prev = Last; i <= Last; i_prev = i++)
+		{
+			Normal += Triangulation.Loops[i_prev]->Vert->Location ^ Triangulation.Loops[i]->Vert->Location;
+		}
+		FaceNormals[FaceIndex] = Normal;
+	});
+
+	Buffers.Normals.SetNumUninitialized(NumBufferVertices);
+	if (bPerLoop)
+	{
+		ParallelFor(NumFaces, [&](int32 FaceIndex)
+		{
+			const FVector Normal = FaceNormals[FaceIndex].GetSafeNormal();
+			for (int32 i = Triangulation.LoopOffsets[FaceIndex]; i < Triangulation.LoopOffsets[FaceIndex + 1]; ++i)
+			{
+				Buffers.Normals[i] = Normal;
+			}
+		});
+	}
+	else
+	{
+		FMemory::Memzero(Buffers.Normals.GetData(), NumBufferVertices * sizeof(FVector));
+		for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+		{
+			for (int32 i = Triangulation.LoopOffsets[FaceIndex]; i < Triangulation.LoopOffsets[FaceIndex + 1]; ++i)
+			{
+				Buffers.Normals[LoopVertices[i]] += FaceNormals[FaceIndex];
+			}
+		}
+		ParallelFor(NumBufferVertices, [&](int32 i)
+		{
+			Buffers.Normals[i].Normalize();
+		});
+	}
+}
+
+bool FBMeshConversion::UpdateMeshSectionPositions(const UBMesh* Mesh, FBMeshSectionBuffers& Buffers)
+{
+	check(Mesh);
+	if (Buffers.SourceMesh.Get() != Mesh || Mesh->GetTopologyRevision() != Buffers.MeshTopologyRevision
+		|| Buffers.Positions.Num() != Buffers.SourceVertices.Num())
+		return false;
+
+	ParallelFor(Buffers.Positions.Num(), [&](int32 i)
+	{
+		Buffers.Positions[i] = Mesh->Vertices[Buffers.SourceVertices[i]]->Location;
+	});
+	return true;
+}
+
+UBMesh* FBMeshConversion::FromMeshDescription(const FMeshDescription& MeshDescription, UObject* Outer, UBMesh::FMakeParams Params, const FBMeshConversionOptions& Options)
+{
+	UBMesh* Mesh = UBMesh::Make(Outer, Params);
+	FStaticMeshConstAttributes Attributes(MeshDescription);
+	const auto Positions = Attributes.GetVertexPositions();
+
+	// Vertex IDs can be sparse, so they're remapped to the indices of the new vertices
+	TArray<int32> VertexIndices;
+	VertexIndices.Init(INDEX_NONE, MeshDescription.Vertices().GetArraySize());
+	TArray<FVertexID> VertexIDs;
+	VertexIDs.Reserve(MeshDescription.Vertices().Num());
+	for (const FVertexID VertexID : MeshDescription.Vertices().GetElementIDs())
+	{
+		VertexIndices[VertexID.GetValue()] = VertexIDs.Add(VertexID);
+	}
+
+	int32 NumCorners = 0;
+	for (const FPolygonID PolygonID : MeshDescription.Polygons().GetElementIDs())
+	{
+		NumCorners += MeshDescription.GetNumPolygonVertices(PolygonID);
+	}
+
+	FBMeshBuilder Builder(Mesh);
+	Builder.Reserve(VertexIDs.Num(), MeshDescription.Edges().Num(), NumCorners, MeshDescription.Polygons().Num());
+	for (const FVertexID VertexID : VertexIDs)
+	{
+		Builder.AddVertex(FVector(Positions[VertexID]));
+	}
+
+	// Vertex instance of each loop, loops are added to the mesh in polygon corner order
+	TArray<FVertexInstanceID> LoopInstances;
+	LoopInstances.Reserve(NumCorners);
+	TArray<int32, TInlineAllocator<8>> FaceVertices;
+	int32 NumSkipped = 0;
+	for (const FPolygonID PolygonID : MeshDescription.Polygons().GetElementIDs())
+	{
+		const int32 FirstInstance = LoopInstances.Num();
+		FaceVertices.Reset();
+		for (const FVertexInstanceID InstanceID : MeshDescription.GetPolygonVertexInstances(PolygonID))
+		{
+			FaceVertices.Add(VertexIndices[MeshDescription.GetVertexInstanceVertex(InstanceID).GetValue()]);
+			LoopInstances.Add(InstanceID);
+		}
+
+		bool bIsDegenerate = FaceVertices.Num() < 3;
+		for (int32 i = 0, i_prev = FaceVertices.Num() - 1; i < FaceVertices.Num() && !bIsDegenerate; i_prev = i++)
+		{
+			bIsDegenerate = FaceVertices[i_prev] == FaceVertices[i];
+		}
+		if (bIsDegenerate)
+		{
+			LoopInstances.SetNum(FirstInstance);
+			++NumSkipped;
+			continue;
+		}
+		Builder.AddFace(FaceVertices);
+	}
+	check(LoopInstances.Num() == Mesh->Loops.Num());
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogBMesh, Warning, TEXT("FromMeshDescription: skipped %d degenerate polygons"), NumSkipped);
+	}
+
+	const TLoopAttribute<FVector2D> UVAttribute(Mesh, Options.UVAttribute);
+	const TLoopAttribute<FVector> NormalAttribute(Mesh, Options.NormalAttribute);
+	const TLoopAttribute<FLinearColor> ColorAttribute(Mesh, Options.ColorAttribute);
+	const auto UVs = Attributes.GetVertexInstanceUVs();
+	const auto Normals = Attributes.GetVertexInstanceNormals();
+	const auto Colors = Attributes.GetVertexInstanceColors();
+	const bool bCopyUVs = UVAttribute && UVs.IsValid() && GetNumChannels(UVs) > 0;
+	const bool bCopyNormals = NormalAttribute && Normals.IsValid();
+	const bool bCopyColors = ColorAttribute && Colors.IsValid();
+
+	auto CopyAttributes = [&](bool bToVertex, UObject* Element, FVertexInstanceID InstanceID)
+	{
+		if (bCopyUVs && UVAttribute.IsOnVertex() == bToVertex)
+		{
+			UVAttribute.GetMutable(Element) = FVector2D(UVs.Get(InstanceID, 0));
+		}
+		if (bCopyNormals && NormalAttribute.IsOnVertex() == bToVertex)
+		{
+			NormalAttribute.GetMutable(Element) = FVector(Normals[InstanceID]);
+		}
+		if (bCopyColors && ColorAttribute.IsOnVertex() == bToVertex)
+		{
+			const auto& Color = Colors[InstanceID];
+			ColorAttribute.GetMutable(Element) = FLinearColor(Color.X, Color.Y, Color.Z, Color.W);
+		}
+	};
+
+	// Vertex and loop properties are written in separate passes, so no element is written by two threads
+	ParallelFor(Mesh->Loops.Num(), [&](int32 i)
+	{
+		CopyAttributes(false, Mesh->Loops[i], LoopInstances[i]);
+	});
+	ParallelFor(Mesh->Vertices.Num(), [&](int32 i)
+	{
+		const auto& Instances = MeshDescription.GetVertexVertexInstances(VertexIDs[i]);
+		if (Instances.Num() > 0)
+		{
+			CopyAttributes(true, Mesh->Vertices[i], Instances[0]);
+		}
+	});
+
+	return Mesh;
+}
+
+#if WITH_EDITOR
+UBMesh* FBMeshConversion::FromStaticMesh(UStaticMesh* StaticMesh, int32 LODIndex, UObject* Outer, UBMesh::FMakeParams Params, const FBMeshConversionOptions& Options)
+{
+	check(StaticMesh);
+	const FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(LODIndex);
+	if (!MeshDescription)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("FromStaticMesh: %s has no mesh description for LOD %d"), *StaticMesh->GetName(), LODIndex);
+		return nullptr;
+	}
+	return FromMeshDescription(*MeshDescription, Outer, Params, Options);
+}
+#endif
+
+#if WITH_BMESH_DYNAMIC_MESH
+void FBMeshConversion::ToDynamicMesh(const UBMesh* Mesh, UE::Geometry::FDynamicMesh3& DynamicMesh, const FBMeshConversionOptions& Options)
+{
+	using namespace UE::Geometry;
+
+	check(Mesh);
+	const FBMeshTriangulation Triangulation = FBMeshTriangulation::Build(Mesh);
+	const TArray<int32> LoopVertices = GetLoopVertexIndices(Mesh, Triangulation);
+	const TLoopAttribute<FVector2D> UVReader(Mesh, Options.UVAttribute);
+	const TLoopAttribute<FVector> NormalReader(Mesh, Options.NormalAttribute);
+	const TLoopAttribute<FLinearColor> ColorReader(Mesh, Options.ColorAttribute);
+
+	DynamicMesh.Clear();
+	DynamicMesh.EnableTriangleGroups();
+	FDynamicMeshUVOverlay* UVOverlay = nullptr;
+	FDynamicMeshNormalOverlay* NormalOverlay = nullptr;
+	FDynamicMeshColorOverlay* ColorOverlay = nullptr;
+	if (UVReader || NormalReader || ColorReader)
+	{
+		DynamicMesh.EnableAttributes();
+		if (UVReader)
+		{
+			UVOverlay = DynamicMesh.Attributes()->GetUVLayer(0);
+		}
+		if (NormalReader)
+		{
+			NormalOverlay = DynamicMesh.Attributes()->PrimaryNormals();
+		}
+		if (ColorReader)
+		{
+			DynamicMesh.Attributes()->EnablePrimaryColors();
+			ColorOverlay = DynamicMesh.Attributes()->PrimaryColors();
+		}
+	}
+
+	for (const UBMeshVertex* Vertex : Mesh->Vertices)
+	{
+		DynamicMesh.AppendVertex(FVector3d(Vertex->Location));
+	}
+
+	// Overlay elements are appended per loop, so element i belongs to loop i
+	for (const UBMeshLoop* Loop : Triangulation.Loops)
+	{
+		if (UVOverlay)
+		{
+			UVOverlay->AppendElement(FVector2f(UVReader.Get(Loop)));
+		}
+		if (NormalOverlay)
+		{
+			NormalOverlay->AppendElement(FVector3f(NormalReader.Get(Loop)));
+		}
+		if (ColorOverlay)
+		{
+			ColorOverlay->AppendElement(FVector4f(ColorReader.Get(Loop)));
+		}
+	}
+
+	int32 NumSkipped = 0;
+	for (int32 FaceIndex = 0; FaceIndex < Triangulation.NumFaces(); ++FaceIndex)
+	{
+		for (int32 i = Triangulation.TriangleOffsets[FaceIndex]; i < Triangulation.TriangleOffsets[FaceIndex + 1]; ++i)
+		{
+			const FIntVector& Triangle = Triangulation.Triangles[i];
+			const FIndex3i Elements(Triangle.X, Triangle.Y, Triangle.Z);
+			const int32 TriangleID = DynamicMesh.AppendTriangle(FIndex3i(LoopVertices[Triangle.X], LoopVertices[Triangle.Y], LoopVertices[Triangle.Z]), FaceIndex);
+			if (TriangleID < 0)
+			{
+				++NumSkipped;
+				continue;
+			}
+			if (UVOverlay)
+			{
+				UVOverlay->SetTriangle(TriangleID, Elements);
+			}
+			if (NormalOverlay)
+			{
+				NormalOverlay->SetTriangle(TriangleID, Elements);
+			}
+			if (ColorOverlay)
+			{
+				ColorOverlay->SetTriangle(TriangleID, Elements);
+			}
+		}
+	}
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogBMesh, Warning, TEXT("ToDynamicMesh: skipped %d triangles that were degenerate or non manifold"), NumSkipped);
+	}
+}
+
+void FBMeshConversion::ToDynamicMesh(const UBMesh* Mesh, UDynamicMesh* DynamicMesh, const FBMeshConversionOptions& Options)
+{
+	check(DynamicMesh);
+	UE::Geometry::FDynamicMesh3 Result;
+	ToDynamicMesh(Mesh, Result, Options);
+	DynamicMesh->SetMesh(MoveTemp(Result));
+}
+#endif
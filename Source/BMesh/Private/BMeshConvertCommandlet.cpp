@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshConvertCommandlet.h"
+
+#include "BMesh.h"
+#include "BMeshFileIO.h"
+#include "BMeshOperators.h"
+#include "BMeshLog.h"
+
+UBMeshConvertCommandlet::UBMeshConvertCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UBMeshConvertCommandlet::Main(const FString& Params)
+{
+	FString InFilename;
+	FString OutFilename;
+	if (!FParse::Value(*Params, TEXT("In="), InFilename) || !FParse::Value(*Params, TEXT("Out="), OutFilename))
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Usage: -run=BMeshConvert -In=<file> -Out=<file> [-Weld=<tolerance>]"));
+		return 1;
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+	UBMesh* Mesh = FBMeshFileIO::Read(InFilename);
+	if (!Mesh)
+		return 1;
+	UE_LOG(LogBMesh, Display, TEXT("Read %s: %d vertices, %d edges, %d faces in %.2fs"), *InFilename,
+	       Mesh->Vertices.Num(), Mesh->Edges.Num(), Mesh->Faces.Num(), FPlatformTime::Seconds() - StartTime);
+
+	float WeldTolerance;
+	if (FParse::Value(*Params, TEXT("Weld="), WeldTolerance))
+	{
+		StartTime = FPlatformTime::Seconds();
+		const int32 NumWelded = FBMeshOperators::WeldVertices(Mesh, WeldTolerance);
+		UE_LOG(LogBMesh, Display, TEXT("Welded %d vertices in %.2fs"), NumWelded, FPlatformTime::Seconds() - StartTime);
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	if (!FBMeshFileIO::Write(Mesh, OutFilename))
+		return 1;
+	UE_LOG(LogBMesh, Display, TEXT("Wrote %s in %.2fs"), *OutFilename, FPlatformTime::Seconds() - StartTime);
+	return 0;
+}
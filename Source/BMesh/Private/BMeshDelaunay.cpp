@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshDelaunay.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	// Exact arithmetic on expansions, sums of doubles of increasing magnitude whose bits don't
+	// overlap (Shewchuk, Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates)
+
+	void TwoSum(double A, double B, double& OutSum, double& OutError)
+	{
+		OutSum = A + B;
+		const double BVirtual = OutSum - A;
+		const double AVirtual = OutSum - BVirtual;
+		OutError = (A - AVirtual) + (B - BVirtual);
+	}
+
+	/**
+	 * Split a double into two halves of 26 bits, whose products are exact
+	 */
+	void Split(double A, double& OutHigh, double& OutLow)
+	{
+		const double Scaled = 134217729.0 * A; // 2^27 + 1
+		const double Big = Scaled - A;
+		OutHigh = Scaled - Big;
+		OutLow = A - OutHigh;
+	}
+
+	void TwoProduct(double A, double B, double& OutProduct, double& OutError)
+	{
+		OutProduct = A * B;
+		double AHigh, ALow, BHigh, BLow;
+		Split(A, AHigh, ALow);
+		Split(B, BHigh, BLow);
+		const double Error1 = OutProduct - AHigh * BHigh;
+		const double Error2 = Error1 - ALow * BHigh;
+		const double Error3 = Error2 - AHigh * BLow;
+		OutError = ALow * BLow - Error3;
+	}
+
+	/**
+	 * Add a double to an expansion, keeping it an expansion
+	 */
+	void GrowExpansion(TArray<double, TInlineAllocator<16>>& Expansion, double Value)
+	{
+		double Sum = Value;
+		for (double& Component : Expansion)
+		{
+			double Error;
+			TwoSum(Sum, Component, Sum, Error);
+			Component = Error;
+		}
+		Expansion.Add(Sum);
+	}
+
+	int32 ExactOrient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+	{
+		// (ax - cx)(by - cy) - (ay - cy)(bx - cx), expanded into products of input coordinates
+		const double Terms[6][2] = {
+			{ A.X, B.Y }, { -A.X, C.Y }, { -C.X, B.Y },
+			{ -A.Y, B.X }, { A.Y, C.X }, { C.Y, B.X },
+		};
+		TArray<double, TInlineAllocator<16>> Expansion;
+		for (const auto& Term : Terms)
+		{
+			double Product, Error;
+			TwoProduct(Term[0], Term[1], Product, Error);
+			GrowExpansion(Expansion, Error);
+			GrowExpansion(Expansion, Product);
+		}
+		// The largest non zero component gives the sign
+		for (int32 i = Expansion.Num() - 1; i >= 0; --i)
+		{
+			if (Expansion[i] != 0)
+				return Expansion[i] > 0 ? 1 : -1;
+		}
+		return 0;
+	}
+
+	double CircumradiusSquared(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+	{
+		const FVector2D D = B - A;
+		const FVector2D E = C - A;
+		const double DD = D.X * D.X + D.Y * D.Y;
+		const double EE = E.X * E.X + E.Y * E.Y;
+		const double Cross = D.X * E.Y - D.Y * E.X;
+		if (Cross == 0)
+			return TNumericLimits<double>::Max();
+		const double X = (E.Y * DD - D.Y * EE) * 0.5 / Cross;
+		const double Y = (D.X * EE - E.X * DD) * 0.5 / Cross;
+		return X * X + Y * Y;
+	}
+
+	/**
+	 * Whether P is strictly inside the circumcircle of the counterclockwise triangle ABC
+	 */
+	bool InCircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& P)
+	{
+		const double DX = A.X - P.X, DY = A.Y - P.Y;
+		const double EX = B.X - P.X, EY = B.Y - P.Y;
+		const double FX = C.X - P.X, FY = C.Y - P.Y;
+		const double AP = DX * DX + DY * DY;
+		const double BP = EX * EX + EY * EY;
+		const double CP = FX * FX + FY * FY;
+		return DX * (EY * CP - BP * FY) - DY * (EX * CP - BP * FX) + AP * (EX * FY - EY * FX) > 0;
+	}
+
+	/**
+	 * Monotonic in the angle of the direction, counterclockwise, in [0, 1)
+	 */
+	double PseudoAngle(double DX, double DY)
+	{
+		if (DX == 0 && DY == 0)
+			return 0;
+		const double P = DX / (FMath::Abs(DX) + FMath::Abs(DY));
+		return (DY > 0 ? 3 - P : 1 + P) / 4;
+	}
+
+	/**
+	 * Triangles and half edges of the sweep. Half edge 3t + k goes from the k-th corner of triangle t
+	 * to the next one, and its opposite half edge is in the adjacent triangle, or INDEX_NONE on the hull.
+	 */
+	class FDelaunaySweep
+	{
+	public:
+		FDelaunaySweep(TArrayView<const FVector2D> InPoints)
+			: Points(InPoints)
+		{
+		}
+
+		bool Run(FBMeshDelaunay& Out);
+
+	private:
+		TArrayView<const FVector2D> Points;
+		TArray<int32> Corners;
+		TArray<int32> HalfEdges;
+		int32 NumHalfEdges = 0;
+
+		TArray<int32> HullPrev;
+		TArray<int32> HullNext;
+		// Half edge from each hull point to the next one, inside its triangle
+		TArray<int32> HullTri;
+		TArray<int32> HullHash;
+		int32 HullStart = 0;
+		FVector2D Center;
+
+		TArray<int32> EdgeStack;
+
+		int32 HashKey(const FVector2D& Point) const
+		{
+			const int32 HashSize = HullHash.Num();
+			return FMath::FloorToInt(PseudoAngle(Point.X - Center.X, Point.Y - Center.Y) * HashSize) % HashSize;
+		}
+
+		// Whether P sees the hull edge from A to B, the hull being counterclockwise
+		bool IsVisible(int32 P, int32 A, int32 B) const
+		{
+			return FBMeshDelaunay::Orient2D(Points[A], Points[B], Points[P]) < 0;
+		}
+
+		void Link(int32 A, int32 B)
+		{
+			HalfEdges[A] = B;
+			if (B != INDEX_NONE)
+			{
+				HalfEdges[B] = A;
+			}
+		}
+
+		int32 AddTriangle(int32 I0, int32 I1, int32 I2, int32 A, int32 B, int32 C)
+		{
+			const int32 T = NumHalfEdges;
+			Corners[T] = I0;
+			Corners[T + 1] = I1;
+			Corners[T + 2] = I2;
+			Link(T, A);
+			Link(T + 1, B);
+			Link(T + 2, C);
+			NumHalfEdges += 3;
+			return T;
+		}
+
+		int32 Legalize(int32 A);
+	};
+
+	int32 FDelaunaySweep::Legalize(int32 A)
+	{
+		int32 AR = 0;
+		EdgeStack.Reset();
+		for (;;)
+		{
+			const int32 B = HalfEdges[A];
+			const int32 A0 = A - A % 3;
+			AR = A0 + (A + 2) % 3;
+
+			// Hull edges can't be flipped
+			if (B == INDEX_NONE)
+			{
+				if (EdgeStack.Num() == 0)
+					break;
+				A = EdgeStack.Pop();
+				continue;
+			}
+
+			const int32 B0 = B - B % 3;
+			const int32 AL = A0 + (A + 1) % 3;
+			const int32 BL = B0 + (B + 2) % 3;
+			const int32 P0 = Corners[AR];
+			const int32 PR = Corners[A];
+			const int32 PL = Corners[AL];
+			const int32 P1 = Corners[BL];
+
+			// Flip the edge if the opposite point is inside the circumcircle, then check the edges
+			// that now face the new triangles
+			if (InCircle(Points[P0], Points[PR], Points[PL], Points[P1]))
+			{
+				Corners[A] = P1;
+				Corners[B] = P0;
+				const int32 HBL = HalfEdges[BL];
+
+				// The flipped edge was on the hull on the other side, fix the hull's reference to it
+				if (HBL == INDEX_NONE)
+				{
+					int32 E = HullStart;
+					do
+					{
+						if (HullTri[E] == BL)
+						{
+							HullTri[E] = A;
+							break;
+						}
+						E = HullPrev[E];
+					}
+					while (E != HullStart);
+				}
+				Link(A, HBL);
+				Link(B, HalfEdges[AR]);
+				Link(AR, BL);
+				EdgeStack.Add(B0 + (B + 1) % 3);
+			}
+			else
+			{
+				if (EdgeStack.Num() == 0)
+					break;
+				A = EdgeStack.Pop();
+			}
+		}
+		return AR;
+	}
+
+	bool FDelaunaySweep::Run(FBMeshDelaunay& Out)
+	{
+		const int32 NumPoints = Points.Num();
+		if (NumPoints < 3)
+			return false;
+
+		// Seed triangle: the point closest to the center of the bounds, the point closest to it, and
+		// the point making the smallest circumcircle with them
+		FBox2D Bounds(ForceInit);
+		for (const FVector2D& Point : Points)
+		{
+			Bounds += Point;
+		}
+		const FVector2D BoundsCenter = Bounds.GetCenter();
+		auto ClosestTo = [&](const FVector2D& Target, int32 Excluded)
+		{
+			int32 Closest = INDEX_NONE;
+			double MinDistance = TNumericLimits<double>::Max();
+			for (int32 i = 0; i < NumPoints; ++i)
+			{
+				const double Distance = FVector2D::DistSquared(Target, Points[i]);
+				if (i != Excluded && Distance < MinDistance && (Excluded == INDEX_NONE || Distance > 0))
+				{
+					Closest = i;
+					MinDistance = Distance;
+				}
+			}
+			return Closest;
+		};
+		const int32 I0 = ClosestTo(BoundsCenter, INDEX_NONE);
+		int32 I1 = ClosestTo(Points[I0], I0);
+		if (I1 == INDEX_NONE)
+			return false;
+		int32 I2 = INDEX_NONE;
+		double MinRadius = TNumericLimits<double>::Max();
+		for (int32 i = 0; i < NumPoints; ++i)
+		{
+			if (i == I0 || i == I1)
+				continue;
+			const double Radius = CircumradiusSquared(Points[I0], Points[I1], Points[i]);
+			if (Radius < MinRadius)
+			{
+				I2 = i;
+				MinRadius = Radius;
+			}
+		}
+		if (I2 == INDEX_NONE)
+			return false;
+		if (FBMeshDelaunay::Orient2D(Points[I0], Points[I1], Points[I2]) < 0)
+		{
+			Swap(I1, I2);
+		}
+		Center = FBMeshDelaunay::Circumcenter(Points[I0], Points[I1], Points[I2]);
+
+		// Sweep order
+		TArray<double> Distances;
+		Distances.SetNumUninitialized(NumPoints);
+		ParallelFor(NumPoints, [&](int32 i)
+		{
+			Distances[i] = FVector2D::DistSquared(Points[i], Center);
+		});
+		TArray<int32> Order;
+		Order.SetNumUninitialized(NumPoints);
+		for (int32 i = 0; i < NumPoints; ++i)
+		{
+			Order[i] = i;
+		}
+		Order.Sort([&](int32 A, int32 B) { return Distances[A] < Distances[B] || (Distances[A] == Distances[B] && A < B); });
+
+		const int32 MaxTriangles = FMath::Max(2 * NumPoints - 5, 0);
+		Corners.SetNumUninitialized(MaxTriangles * 3);
+		HalfEdges.SetNumUninitialized(MaxTriangles * 3);
+		HullPrev.SetNumUninitialized(NumPoints);
+		HullNext.SetNumUninitialized(NumPoints);
+		HullTri.SetNumUninitialized(NumPoints);
+		HullHash.Init(INDEX_NONE, FMath::Max(FMath::CeilToInt(FMath::Sqrt(float(NumPoints))), 1));
+
+		HullStart = I0;
+		HullNext[I0] = HullPrev[I2] = I1;
+		HullNext[I1] = HullPrev[I0] = I2;
+		HullNext[I2] = HullPrev[I1] = I0;
+		HullTri[I0] = 0;
+		HullTri[I1] = 1;
+		HullTri[I2] = 2;
+		HullHash[HashKey(Points[I0])] = I0;
+		HullHash[HashKey(Points[I1])] = I1;
+		HullHash[HashKey(Points[I2])] = I2;
+		AddTriangle(I0, I1, I2, INDEX_NONE, INDEX_NONE, INDEX_NONE);
+
+		FVector2D Previous;
+		for (int32 k = 0; k < NumPoints; ++k)
+		{
+			const int32 I = Order[k];
+			const FVector2D& Point = Points[I];
+
+			// Skip duplicates and the seed points
+			if (k > 0 && FMath::Abs(Point.X - Previous.X) <= DBL_EPSILON && FMath::Abs(Point.Y - Previous.Y) <= DBL_EPSILON)
+				continue;
+			Previous = Point;
+			if (I == I0 || I == I1 || I == I2)
+				continue;
+
+			// Find a visible edge on the hull, starting from a point with a close angle to the center
+			int32 Start = 0;
+			const int32 Key = HashKey(Point);
+			for (int32 j = 0; j < HullHash.Num(); ++j)
+			{
+				Start = HullHash[(Key + j) % HullHash.Num()];
+				if (Start != INDEX_NONE && Start != HullNext[Start])
+					break;
+			}
+			Start = HullPrev[Start];
+			int32 E = Start;
+			while (!IsVisible(I, E, HullNext[E]))
+			{
+				E = HullNext[E];
+				if (E == Start)
+				{
+					E = INDEX_NONE;
+					break;
+				}
+			}
+			// The point is on the hull, only possible with near duplicates
+			if (E == INDEX_NONE)
+				continue;
+
+			// Join the point to the first visible edge, then to the following and preceding ones
+			int32 T = AddTriangle(E, I, HullNext[E], INDEX_NONE, INDEX_NONE, HullTri[E]);
+			HullTri[I] = Legalize(T + 2);
+			HullTri[E] = T;
+
+			int32 N = HullNext[E];
+			for (int32 Q = HullNext[N]; IsVisible(I, N, Q); Q = HullNext[N])
+			{
+				T = AddTriangle(N, I, Q, HullTri[I], INDEX_NONE, HullTri[N]);
+				HullTri[I] = Legalize(T + 2);
+				// Mark as removed from the hull
+				HullNext[N] = N;
+				N = Q;
+			}
+			if (E == Start)
+			{
+				for (int32 Q = HullPrev[E]; IsVisible(I, Q, E); Q = HullPrev[E])
+				{
+					T = AddTriangle(Q, I, E, INDEX_NONE, HullTri[E], HullTri[Q]);
+					Legalize(T + 2);
+					HullTri[Q] = T;
+					HullNext[E] = E;
+					E = Q;
+				}
+			}
+
+			HullStart = HullPrev[I] = E;
+			HullNext[E] = HullPrev[N] = I;
+			HullNext[I] = N;
+			HullHash[HashKey(Point)] = I;
+			HullHash[HashKey(Points[E])] = E;
+		}
+
+		const int32 NumTriangles = NumHalfEdges / 3;
+		Out.Triangles.SetNumUninitialized(NumTriangles);
+		ParallelFor(NumTriangles, [&](int32 Triangle)
+		{
+			Out.Triangles[Triangle] = FIntVector(Corners[Triangle * 3], Corners[Triangle * 3 + 1], Corners[Triangle * 3 + 2]);
+		});
+		int32 E = HullStart;
+		do
+		{
+			Out.Hull.Add(E);
+			E = HullNext[E];
+		}
+		while (E != HullStart);
+		return true;
+	}
+}
+
+FBMeshDelaunay FBMeshDelaunay::Build(TArrayView<const FVector2D> Points)
+{
+	FBMeshDelaunay Delaunay;
+	FDelaunaySweep Sweep(Points);
+	if (!Sweep.Run(Delaunay))
+	{
+		Delaunay.Triangles.Reset();
+		Delaunay.Hull.Reset();
+	}
+	return Delaunay;
+}
+
+FVector2D FBMeshDelaunay::Circumcenter(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	const FVector2D D = B - A;
+	const FVector2D E = C - A;
+	const double DD = D.X * D.X + D.Y * D.Y;
+	const double EE = E.X * E.X + E.Y * E.Y;
+	const double Cross = D.X * E.Y - D.Y * E.X;
+	return FVector2D(A.X + (E.Y * DD - D.Y * EE) * 0.5 / Cross, A.Y + (D.X * EE - E.X * DD) * 0.5 / Cross);
+}
+
+int32 FBMeshDelaunay::Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	const double DetLeft = (double(A.X) - C.X) * (double(B.Y) - C.Y);
+	const double DetRight = (double(A.Y) - C.Y) * (double(B.X) - C.X);
+	const double Det = DetLeft - DetRight;
+	// Error bound of the floating point evaluation, from Shewchuk's orient2d
+	const double ErrorBound = (3.0 + 16.0 * DBL_EPSILON) * DBL_EPSILON * (FMath::Abs(DetLeft) + FMath::Abs(DetRight));
+	if (Det > ErrorBound)
+		return 1;
+	if (-Det > ErrorBound)
+		return -1;
+	return ExactOrient2D(A, B, C);
+}
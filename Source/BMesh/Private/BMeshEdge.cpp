@@ -81,6 +81,35 @@ void UBMeshEdge::SetPrev(const UBMeshVertex* v, UBMeshEdge* other)
 	else Prev2 = other;
 }
 
+void UBMeshEdge::AppendToDisk(UBMeshVertex* v)
+{
+	if (v->Edge == nullptr)
+	{
+		v->Edge = this;
+		SetNext(v, this);
+		SetPrev(v, this);
+	}
+	else
+	{
+		SetNext(v, v->Edge->Next(v));
+		SetPrev(v, v->Edge);
+		Next(v)->SetPrev(v, this);
+		Prev(v)->SetNext(v, this);
+	}
+}
+
+void UBMeshEdge::RemoveFromDisk(UBMeshVertex* v)
+{
+	UBMeshEdge* NextEdge = Next(v);
+	UBMeshEdge* PrevEdge = Prev(v);
+	if (v->Edge == this)
+	{
+		v->Edge = (NextEdge != this ? NextEdge : nullptr);
+	}
+	PrevEdge->SetNext(v, NextEdge);
+	NextEdge->SetPrev(v, PrevEdge);
+}
+
 TArray<UBMeshFace*> UBMeshEdge::NeighborFaces() const
 {
 	TArray<UBMeshFace*> Faces;
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshFaceAutomaton.h"
+
+#include "BMeshVertex.h"
+#include "BMeshEdge.h"
+#include "BMeshLoop.h"
+
+namespace
+{
+	typedef TArray<int32, TInlineAllocator<16>> FNeighborScratch;
+
+	void GatherFaceNeighbors(const UBMeshFace* Face, EBMeshFaceAdjacency Mode, FNeighborScratch& OutNeighbors)
+	{
+		OutNeighbors.Reset();
+		for (UBMeshLoop* Loop : Face->Loops())
+		{
+			if (Mode == EBMeshFaceAdjacency::Edge)
+			{
+				for (UBMeshLoop* Radial = Loop->RadialNext; Radial != Loop; Radial = Radial->RadialNext)
+				{
+					if (Radial->Face != Face)
+					{
+						OutNeighbors.AddUnique(Radial->Face->Index);
+					}
+				}
+			}
+			else
+			{
+				for (UBMeshEdge* Edge : Loop->Vert->EdgesRange())
+				{
+					if (Edge->Loop == nullptr)
+						continue;
+					for (UBMeshFace* Other : Edge->NeighborFacesRange())
+					{
+						if (Other != Face)
+						{
+							OutNeighbors.AddUnique(Other->Index);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+FBMeshFaceAdjacency FBMeshFaceAdjacency::Build(UBMesh* Mesh, EBMeshFaceAdjacency Mode)
+{
+	check(Mesh);
+
+	const int32 NumFaces = Mesh->Faces.Num();
+	FBMeshFaceAdjacency Result;
+	Result.Offsets.SetNumUninitialized(NumFaces + 1);
+
+	// Neighbors are gathered twice, once to count them and once to write them,
+	// so that no per face allocation is needed to build the table
+	ParallelFor(NumFaces, [&](int32 FaceIndex)
+	{
+		FNeighborScratch Scratch;
+		GatherFaceNeighbors(Mesh->Faces[FaceIndex], Mode, Scratch);
+		Result.Offsets[FaceIndex + 1] = Scratch.Num();
+	});
+
+	Result.Offsets[0] = 0;
+	for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+	{
+		Result.Offsets[FaceIndex + 1] += Result.Offsets[FaceIndex];
+	}
+
+	Result.Neighbors.SetNumUninitialized(Result.Offsets[NumFaces]);
+	ParallelFor(NumFaces, [&](int32 FaceIndex)
+	{
+		FNeighborScratch Scratch;
+		GatherFaceNeighbors(Mesh->Faces[FaceIndex], Mode, Scratch);
+		FMemory::Memcpy(Result.Neighbors.GetData() + Result.Offsets[FaceIndex], Scratch.GetData(), Scratch.Num() * sizeof(int32));
+	});
+
+	return Result;
+}
@@ -0,0 +1,801 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshFileIO.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+
+#include "BMeshCore.h"
+#include "BMeshBuilder.h"
+#include "BMeshLog.h"
+
+namespace
+{
+	constexpr int32 StreamBufferSize = 1 << 20;
+
+	/**
+	 * Reads a file through a fixed size buffer, either line by line or as raw bytes
+	 */
+	class FStreamReader
+	{
+	public:
+		explicit FStreamReader(IFileHandle& InFile)
+			: File(InFile)
+			, Remaining(InFile.Size())
+		{
+			Buffer.SetNumUninitialized(StreamBufferSize + 1);
+			Buffer[0] = 0;
+		}
+
+		/**
+		 * Get the next line, without its line break. The line is always followed by a line break or a null
+		 * character, so it can be parsed with functions that stop at them.
+		 */
+		bool ReadLine(const ANSICHAR*& OutBegin, const ANSICHAR*& OutEnd)
+		{
+			for (;;)
+			{
+				const ANSICHAR* Begin = Buffer.GetData() + Position;
+				const ANSICHAR* End = Buffer.GetData() + Length;
+				const ANSICHAR* LineEnd = Begin;
+				while (LineEnd < End && *LineEnd != '\n')
+				{
+					++LineEnd;
+				}
+				if (LineEnd < End || (Remaining == 0 && Begin < End))
+				{
+					Position = LineEnd - Buffer.GetData() + (LineEnd < End ? 1 : 0);
+					OutBegin = Begin;
+					OutEnd = LineEnd > Begin && LineEnd[-1] == '\r' ? LineEnd - 1 : LineEnd;
+					return true;
+				}
+				if (!Refill())
+					return false;
+			}
+		}
+
+		bool Read(void* Destination, int64 Size)
+		{
+			uint8* Out = static_cast<uint8*>(Destination);
+			while (Size > 0)
+			{
+				if (Position == Length && !Refill())
+					return false;
+				const int32 Count = (int32)FMath::Min<int64>(Size, Length - Position);
+				FMemory::Memcpy(Out, &Buffer[Position], Count);
+				Out += Count;
+				Position += Count;
+				Size -= Count;
+			}
+			return true;
+		}
+
+		bool IsError() const { return bError; }
+
+		/** Bytes left to read, buffered or still in the file */
+		int64 NumBytesLeft() const { return Remaining + Length - Position; }
+
+	private:
+		/**
+		 * Move the unread bytes to the front of the buffer and read more after them. The buffer only grows
+		 * for lines longer than it.
+		 */
+		bool Refill()
+		{
+			if (Remaining == 0)
+				return false;
+			const int32 Unread = Length - Position;
+			if (Unread > 0 && Position > 0)
+			{
+				FMemory::Memmove(Buffer.GetData(), &Buffer[Position], Unread);
+			}
+			Position = 0;
+			Length = Unread;
+			if (Length == Buffer.Num() - 1)
+			{
+				Buffer.SetNumUninitialized(Length * 2 + 1);
+			}
+			const int32 Count = (int32)FMath::Min<int64>(Remaining, Buffer.Num() - 1 - Length);
+			if (!File.Read(reinterpret_cast<uint8*>(&Buffer[Length]), Count))
+			{
+				Remaining = 0;
+				bError = true;
+				return false;
+			}
+			Length += Count;
+			Remaining -= Count;
+			Buffer[Length] = 0;
+			return true;
+		}
+
+		IFileHandle& File;
+		TArray<ANSICHAR> Buffer;
+		int32 Position = 0;
+		int32 Length = 0;
+		int64 Remaining;
+		bool bError = false;
+	};
+
+	/**
+	 * Writes a file through a fixed size buffer
+	 */
+	class FStreamWriter
+	{
+	public:
+		explicit FStreamWriter(IFileHandle& InFile)
+			: File(InFile)
+		{
+			Buffer.Reserve(StreamBufferSize);
+		}
+
+		void Write(const void* Data, int32 Size)
+		{
+			if (Buffer.Num() + Size > StreamBufferSize)
+			{
+				Flush();
+			}
+			Buffer.Append(static_cast<const uint8*>(Data), Size);
+		}
+
+		template <typename... ArgTypes>
+		void Printf(const ANSICHAR* Format, ArgTypes... Args)
+		{
+			ANSICHAR Text[128];
+			const int32 Length = snprintf(Text, sizeof(Text), Format, Args...);
+			Write(Text, FMath::Clamp(Length, 0, (int32)sizeof(Text) - 1));
+		}
+
+		bool Flush()
+		{
+			bOk = bOk && (Buffer.Num() == 0 || File.Write(Buffer.GetData(), Buffer.Num()));
+			Buffer.Reset();
+			return bOk;
+		}
+
+	private:
+		IFileHandle& File;
+		TArray<uint8> Buffer;
+		bool bOk = true;
+	};
+
+	bool IsBlank(ANSICHAR Char)
+	{
+		return Char == ' ' || Char == '\t';
+	}
+
+	void SkipBlanks(const ANSICHAR*& Cursor, const ANSICHAR* End)
+	{
+		while (Cursor < End && IsBlank(*Cursor))
+		{
+			++Cursor;
+		}
+	}
+
+	bool ParseFloat(const ANSICHAR*& Cursor, const ANSICHAR* End, double& OutValue)
+	{
+		SkipBlanks(Cursor, End);
+		if (Cursor >= End)
+			return false;
+		ANSICHAR* ParseEnd;
+		OutValue = strtod(Cursor, &ParseEnd);
+		if (ParseEnd == Cursor)
+			return false;
+		Cursor = ParseEnd;
+		return true;
+	}
+
+	/**
+	 * Parse an OBJ vertex reference (e.g. 3, -1 or 3/1/2), turning it into a 0 based index
+	 */
+	bool ParseObjIndex(const ANSICHAR*& Cursor, const ANSICHAR* End, int32 NumVertices, int32& OutIndex)
+	{
+		SkipBlanks(Cursor, End);
+		if (Cursor >= End)
+			return false;
+		ANSICHAR* ParseEnd;
+		const long Value = strtol(Cursor, &ParseEnd, 10);
+		if (ParseEnd == Cursor)
+			return false;
+		Cursor = ParseEnd;
+		while (Cursor < End && !IsBlank(*Cursor))
+		{
+			++Cursor;
+		}
+		OutIndex = Value < 0 ? NumVertices + (int32)Value : (int32)Value - 1;
+		return true;
+	}
+
+	/**
+	 * Whether a polygon read from a file can be added as a face
+	 */
+	bool IsValidPolygon(TArrayView<const int32> Indices, int32 NumVertices)
+	{
+		if (Indices.Num() < 3)
+			return false;
+		for (int32 i = 0, i_prev = Indices.Num() - 1; i < Indices.Num(); i_prev = i++)
+		{
+			if (Indices[i] < 0 || Indices[i] >= NumVertices || Indices[i] == Indices[i_prev])
+				return false;
+		}
+		return true;
+	}
+
+	enum class EPlyType : uint8
+	{
+		Int8,
+		UInt8,
+		Int16,
+		UInt16,
+		Int32,
+		UInt32,
+		Float32,
+		Float64,
+		Invalid,
+	};
+
+	EPlyType ParsePlyType(const FString& Name)
+	{
+		static const TMap<FString, EPlyType> Types = {
+			{TEXT("char"), EPlyType::Int8}, {TEXT("int8"), EPlyType::Int8},
+			{TEXT("uchar"), EPlyType::UInt8}, {TEXT("uint8"), EPlyType::UInt8},
+			{TEXT("short"), EPlyType::Int16}, {TEXT("int16"), EPlyType::Int16},
+			{TEXT("ushort"), EPlyType::UInt16}, {TEXT("uint16"), EPlyType::UInt16},
+			{TEXT("int"), EPlyType::Int32}, {TEXT("int32"), EPlyType::Int32},
+			{TEXT("uint"), EPlyType::UInt32}, {TEXT("uint32"), EPlyType::UInt32},
+			{TEXT("float"), EPlyType::Float32}, {TEXT("float32"), EPlyType::Float32},
+			{TEXT("double"), EPlyType::Float64}, {TEXT("float64"), EPlyType::Float64},
+		};
+		const EPlyType* Type = Types.Find(Name);
+		return Type ? *Type : EPlyType::Invalid;
+	}
+
+	int32 GetPlyTypeSize(EPlyType Type)
+	{
+		static const int32 Sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8, 0 };
+		return Sizes[(uint8)Type];
+	}
+
+	struct FPlyProperty
+	{
+		FString Name;
+		EPlyType Type;
+		// Type of the element count for list properties, Invalid for scalar properties
+		EPlyType CountType;
+	};
+
+	struct FPlyElement
+	{
+		FString Name;
+		int64 Count;
+		TArray<FPlyProperty> Properties;
+
+		int32 FindProperty(const TCHAR* PropertyName) const
+		{
+			return Properties.IndexOfByPredicate([PropertyName](const FPlyProperty& Property) { return Property.Name == PropertyName; });
+		}
+
+		/** Size of the smallest possible record in a binary file, where lists are empty */
+		int64 MinRecordSize() const
+		{
+			int64 Size = 0;
+			for (const FPlyProperty& Property : Properties)
+			{
+				Size += GetPlyTypeSize(Property.CountType != EPlyType::Invalid ? Property.CountType : Property.Type);
+			}
+			return Size;
+		}
+	};
+
+	class FPlyValueReader
+	{
+	public:
+		FPlyValueReader(FStreamReader& InReader, bool bInSwapBytes)
+			: Reader(InReader)
+			, bSwapBytes(bInSwapBytes)
+		{
+		}
+
+		double Read(EPlyType Type)
+		{
+			uint8 Bytes[8];
+			const int32 Size = GetPlyTypeSize(Type);
+			if (!Reader.Read(Bytes, Size))
+			{
+				bOk = false;
+				return 0;
+			}
+			if (bSwapBytes)
+			{
+				for (int32 i = 0; i < Size / 2; ++i)
+				{
+					Swap(Bytes[i], Bytes[Size - 1 - i]);
+				}
+			}
+			switch (Type)
+			{
+			case EPlyType::Int8: return FromBytes<int8>(Bytes);
+			case EPlyType::UInt8: return FromBytes<uint8>(Bytes);
+			case EPlyType::Int16: return FromBytes<int16>(Bytes);
+			case EPlyType::UInt16: return FromBytes<uint16>(Bytes);
+			case EPlyType::Int32: return FromBytes<int32>(Bytes);
+			case EPlyType::UInt32: return FromBytes<uint32>(Bytes);
+			case EPlyType::Float32: return FromBytes<float>(Bytes);
+			case EPlyType::Float64: return FromBytes<double>(Bytes);
+			default: return 0;
+			}
+		}
+
+		bool IsOk() const { return bOk; }
+
+	private:
+		template <typename T>
+		static double FromBytes(const uint8* Bytes)
+		{
+			T Value;
+			FMemory::Memcpy(&Value, Bytes, sizeof(T));
+			return (double)Value;
+		}
+
+		FStreamReader& Reader;
+		bool bSwapBytes;
+		bool bOk = true;
+	};
+}
+
+UBMesh* FBMeshFileIO::Read(const FString& Filename, UObject* Outer, UBMesh::FMakeParams Params)
+{
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension.Equals(TEXT("obj"), ESearchCase::IgnoreCase))
+		return ReadOBJ(Filename, Outer, Params);
+	if (Extension.Equals(TEXT("ply"), ESearchCase::IgnoreCase))
+		return ReadPLY(Filename, Outer, Params);
+	UE_LOG(LogBMesh, Error, TEXT("Unsupported mesh file format: %s"), *Filename);
+	return nullptr;
+}
+
+bool FBMeshFileIO::Write(const UBMesh* Mesh, const FString& Filename)
+{
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension.Equals(TEXT("obj"), ESearchCase::IgnoreCase))
+		return WriteOBJ(Mesh, Filename);
+	if (Extension.Equals(TEXT("ply"), ESearchCase::IgnoreCase))
+		return WritePLY(Mesh, Filename);
+	UE_LOG(LogBMesh, Error, TEXT("Unsupported mesh file format: %s"), *Filename);
+	return false;
+}
+
+UBMesh* FBMeshFileIO::ReadOBJ(const FString& Filename, UObject* Outer, UBMesh::FMakeParams Params)
+{
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't open %s"), *Filename);
+		return nullptr;
+	}
+
+	UBMesh* Mesh = UBMesh::Make(Outer, Params);
+	FBMeshBuilder Builder(Mesh);
+	FStreamReader Reader(*File);
+	TArray<int32, TInlineAllocator<16>> Indices;
+	int32 NumSkipped = 0;
+
+	const ANSICHAR* Line;
+	const ANSICHAR* End;
+	while (Reader.ReadLine(Line, End))
+	{
+		SkipBlanks(Line, End);
+		// Only the single letter keywords v, f and l are read
+		if (End - Line < 2 || !IsBlank(Line[1]))
+			continue;
+
+		const ANSICHAR Keyword = *Line++;
+		if (Keyword == 'v')
+		{
+			double X, Y, Z;
+			if (ParseFloat(Line, End, X) && ParseFloat(Line, End, Y) && ParseFloat(Line, End, Z))
+			{
+				Builder.AddVertex(FVector(X, Y, Z));
+			}
+			else
+			{
+				// Keep the numbering of the following vertices
+				Builder.AddVertex(FVector::ZeroVector);
+				++NumSkipped;
+			}
+		}
+		else if (Keyword == 'f' || Keyword == 'l')
+		{
+			const int32 NumVertices = Mesh->Vertices.Num();
+			Indices.Reset();
+			int32 Index;
+			while (ParseObjIndex(Line, End, NumVertices, Index))
+			{
+				Indices.Add(Index);
+			}
+
+			if (Keyword == 'f')
+			{
+				if (IsValidPolygon(Indices, NumVertices))
+				{
+					Builder.AddFace(Indices);
+				}
+				else
+				{
+					++NumSkipped;
+				}
+			}
+			else
+			{
+				for (int32 i = 1; i < Indices.Num(); ++i)
+				{
+					const int32 Index1 = Indices[i - 1];
+					const int32 Index2 = Indices[i];
+					if (Index1 >= 0 && Index1 < NumVertices && Index2 >= 0 && Index2 < NumVertices && Index1 != Index2)
+					{
+						Builder.AddEdge(Index1, Index2);
+					}
+					else
+					{
+						++NumSkipped;
+					}
+				}
+			}
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Failed reading %s"), *Filename);
+		return nullptr;
+	}
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogBMesh, Warning, TEXT("%s: skipped %d invalid vertices, faces or lines"), *Filename, NumSkipped);
+	}
+	return Mesh;
+}
+
+bool FBMeshFileIO::WriteOBJ(const UBMesh* Mesh, const FString& Filename)
+{
+	check(Mesh);
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't open %s for writing"), *Filename);
+		return false;
+	}
+
+	FStreamWriter Writer(*File);
+	Writer.Printf("# BMesh: %d vertices, %d faces\n", Mesh->Vertices.Num(), Mesh->Faces.Num());
+	for (const UBMeshVertex* Vertex : Mesh->Vertices)
+	{
+		Writer.Printf("v %.9g %.9g %.9g\n", (double)Vertex->Location.X, (double)Vertex->Location.Y, (double)Vertex->Location.Z);
+	}
+	for (const UBMeshFace* Face : Mesh->Faces)
+	{
+		Writer.Write("f", 1);
+		for (const UBMeshVertex* Vertex : Face->Vertices())
+		{
+			Writer.Printf(" %d", Vertex->Index + 1);
+		}
+		Writer.Write("\n", 1);
+	}
+	for (const UBMeshEdge* Edge : Mesh->Edges)
+	{
+		if (Edge->Loop == nullptr)
+		{
+			Writer.Printf("l %d %d\n", Edge->Vert1->Index + 1, Edge->Vert2->Index + 1);
+		}
+	}
+
+	if (!Writer.Flush())
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Failed writing %s"), *Filename);
+		return false;
+	}
+	return true;
+}
+
+UBMesh* FBMeshFileIO::ReadPLY(const FString& Filename, UObject* Outer, UBMesh::FMakeParams Params)
+{
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't open %s"), *Filename);
+		return nullptr;
+	}
+	FStreamReader Reader(*File);
+
+	// Header
+	TArray<FPlyElement> Elements;
+	FString Format;
+	bool bHeaderEnded = false;
+	bool bValidHeader = true;
+	const ANSICHAR* Line;
+	const ANSICHAR* End;
+	for (int32 LineNumber = 0; !bHeaderEnded && bValidHeader && Reader.ReadLine(Line, End); ++LineNumber)
+	{
+		TArray<FString> Tokens;
+		FString(End - Line, Line).ParseIntoArrayWS(Tokens);
+		if (LineNumber == 0)
+		{
+			bValidHeader = Tokens.Num() == 1 && Tokens[0] == TEXT("ply");
+			continue;
+		}
+		if (Tokens.Num() == 0 || Tokens[0] == TEXT("comment") || Tokens[0] == TEXT("obj_info"))
+			continue;
+
+		if (Tokens[0] == TEXT("format") && Tokens.Num() >= 2)
+		{
+			Format = Tokens[1];
+		}
+		else if (Tokens[0] == TEXT("element") && Tokens.Num() == 3)
+		{
+			FPlyElement& Element = Elements.AddDefaulted_GetRef();
+			Element.Name = Tokens[1];
+			Element.Count = FCString::Atoi64(*Tokens[2]);
+			bValidHeader = Element.Count >= 0;
+		}
+		else if (Tokens[0] == TEXT("property") && Elements.Num() > 0)
+		{
+			FPlyProperty Property;
+			if (Tokens.Num() == 5 && Tokens[1] == TEXT("list"))
+			{
+				Property = { Tokens[4], ParsePlyType(Tokens[3]), ParsePlyType(Tokens[2]) };
+				bValidHeader = Property.Type != EPlyType::Invalid && Property.CountType != EPlyType::Invalid;
+			}
+			else if (Tokens.Num() == 3)
+			{
+				Property = { Tokens[2], ParsePlyType(Tokens[1]), EPlyType::Invalid };
+				bValidHeader = Property.Type != EPlyType::Invalid;
+			}
+			else
+			{
+				bValidHeader = false;
+			}
+			Elements.Last().Properties.Add(Property);
+		}
+		else if (Tokens[0] == TEXT("end_header"))
+		{
+			bHeaderEnded = true;
+		}
+		else
+		{
+			bValidHeader = false;
+		}
+	}
+
+	if (!bHeaderEnded || !bValidHeader)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("%s is not a valid PLY file"), *Filename);
+		return nullptr;
+	}
+	if (Format != TEXT("binary_little_endian") && Format != TEXT("binary_big_endian"))
+	{
+		UE_LOG(LogBMesh, Error, TEXT("%s: PLY format %s is not supported, only binary files can be read"), *Filename, *Format);
+		return nullptr;
+	}
+	const bool bFileLittleEndian = Format == TEXT("binary_little_endian");
+	FPlyValueReader Values(Reader, bFileLittleEndian != (PLATFORM_LITTLE_ENDIAN != 0));
+
+	// Counts come from the header and can't be trusted, so reservations are limited to the number of
+	// records the rest of the file can hold, and to what the largest reservation can fit in an int32
+	const int64 NumBytesLeft = Reader.NumBytesLeft();
+	auto NumRecordsToReserve = [NumBytesLeft](const FPlyElement& Element)
+	{
+		const int64 MaxRecords = NumBytesLeft / FMath::Max<int64>(Element.MinRecordSize(), 1);
+		return (int32)FMath::Min3<int64>(Element.Count, MaxRecords, MAX_int32 / 4);
+	};
+
+	UBMesh* Mesh = UBMesh::Make(Outer, Params);
+	FBMeshBuilder Builder(Mesh);
+	for (const FPlyElement& Element : Elements)
+	{
+		if (Element.Name == TEXT("vertex"))
+		{
+			Builder.Reserve(NumRecordsToReserve(Element), 0, 0, 0);
+		}
+		else if (Element.Name == TEXT("face"))
+		{
+			// Most meshes are made of triangles and quads, this is only a hint
+			const int32 NumFaces = NumRecordsToReserve(Element);
+			Builder.Reserve(0, NumFaces * 2, NumFaces * 4, NumFaces);
+		}
+	}
+
+	TArray<int32, TInlineAllocator<16>> Indices;
+	int32 NumSkipped = 0;
+	for (const FPlyElement& Element : Elements)
+	{
+		const bool bVertex = Element.Name == TEXT("vertex");
+		const bool bFace = Element.Name == TEXT("face");
+		const bool bEdge = Element.Name == TEXT("edge");
+		const int32 X = Element.FindProperty(TEXT("x"));
+		const int32 Y = Element.FindProperty(TEXT("y"));
+		const int32 Z = Element.FindProperty(TEXT("z"));
+		int32 VertexIndices = Element.FindProperty(TEXT("vertex_indices"));
+		if (VertexIndices == INDEX_NONE)
+		{
+			VertexIndices = Element.FindProperty(TEXT("vertex_index"));
+		}
+		const int32 Vertex1 = Element.FindProperty(TEXT("vertex1"));
+		const int32 Vertex2 = Element.FindProperty(TEXT("vertex2"));
+
+		for (int64 Record = 0; Record < Element.Count && Values.IsOk(); ++Record)
+		{
+			double Scalars[3] = {};
+			double EdgeVertices[2] = { -1, -1 };
+			Indices.Reset();
+			for (int32 PropertyIndex = 0; PropertyIndex < Element.Properties.Num(); ++PropertyIndex)
+			{
+				const FPlyProperty& Property = Element.Properties[PropertyIndex];
+				if (Property.CountType != EPlyType::Invalid)
+				{
+					const int64 Count = (int64)Values.Read(Property.CountType);
+					for (int64 i = 0; i < Count && Values.IsOk(); ++i)
+					{
+						const double Value = Values.Read(Property.Type);
+						if (PropertyIndex == VertexIndices)
+						{
+							Indices.Add((int32)Value);
+						}
+					}
+					continue;
+				}
+				const double Value = Values.Read(Property.Type);
+				if (PropertyIndex == X) Scalars[0] = Value;
+				else if (PropertyIndex == Y) Scalars[1] = Value;
+				else if (PropertyIndex == Z) Scalars[2] = Value;
+				else if (PropertyIndex == Vertex1) EdgeVertices[0] = Value;
+				else if (PropertyIndex == Vertex2) EdgeVertices[1] = Value;
+			}
+			if (!Values.IsOk())
+				break;
+
+			const int32 NumVertices = Mesh->Vertices.Num();
+			if (bVertex)
+			{
+				Builder.AddVertex(FVector(Scalars[0], Scalars[1], Scalars[2]));
+			}
+			else if (bFace)
+			{
+				if (IsValidPolygon(Indices, NumVertices))
+				{
+					Builder.AddFace(Indices);
+				}
+				else
+				{
+					++NumSkipped;
+				}
+			}
+			else if (bEdge)
+			{
+				const int32 Index1 = (int32)EdgeVertices[0];
+				const int32 Index2 = (int32)EdgeVertices[1];
+				if (Index1 >= 0 && Index1 < NumVertices && Index2 >= 0 && Index2 < NumVertices && Index1 != Index2)
+				{
+					Builder.AddEdge(Index1, Index2);
+				}
+				else
+				{
+					++NumSkipped;
+				}
+			}
+		}
+	}
+
+	if (!Values.IsOk())
+	{
+		UE_LOG(LogBMesh, Error, TEXT("%s is truncated or could not be read"), *Filename);
+		return nullptr;
+	}
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogBMesh, Warning, TEXT("%s: skipped %d invalid faces or edges"), *Filename, NumSkipped);
+	}
+	return Mesh;
+}
+
+bool FBMeshFileIO::WritePLY(const UBMesh* Mesh, const FString& Filename)
+{
+	check(Mesh);
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't open %s for writing"), *Filename);
+		return false;
+	}
+
+	int32 MaxVertCount = 0;
+	for (const UBMeshFace* Face : Mesh->Faces)
+	{
+		MaxVertCount = FMath::Max(MaxVertCount, Face->VertCount);
+	}
+	const bool bByteCounts = MaxVertCount <= MAX_uint8;
+	int32 NumLooseEdges = 0;
+	for (const UBMeshEdge* Edge : Mesh->Edges)
+	{
+		NumLooseEdges += Edge->Loop == nullptr ? 1 : 0;
+	}
+
+	FStreamWriter Writer(*File);
+	Writer.Printf("ply\nformat %s 1.0\ncomment BMesh\n", PLATFORM_LITTLE_ENDIAN ? "binary_little_endian" : "binary_big_endian");
+	Writer.Printf("element vertex %d\nproperty float x\nproperty float y\nproperty float z\n", Mesh->Vertices.Num());
+	Writer.Printf("element face %d\nproperty list %s int vertex_indices\n", Mesh->Faces.Num(), bByteCounts ? "uchar" : "int");
+	if (NumLooseEdges > 0)
+	{
+		Writer.Printf("element edge %d\nproperty int vertex1\nproperty int vertex2\n", NumLooseEdges);
+	}
+	Writer.Printf("end_header\n");
+
+	for (const UBMeshVertex* Vertex : Mesh->Vertices)
+	{
+		const float Position[3] = { (float)Vertex->Location.X, (float)Vertex->Location.Y, (float)Vertex->Location.Z };
+		Writer.Write(Position, sizeof(Position));
+	}
+
+	for (const UBMeshFace* Face : Mesh->Faces)
+	{
+		if (bByteCounts)
+		{
+			const uint8 Count = (uint8)Face->VertCount;
+			Writer.Write(&Count, sizeof(Count));
+		}
+		else
+		{
+			const int32 Count = Face->VertCount;
+			Writer.Write(&Count, sizeof(Count));
+		}
+		for (const UBMeshVertex* Vertex : Face->Vertices())
+		{
+			const int32 Index = Vertex->Index;
+			Writer.Write(&Index, sizeof(Index));
+		}
+	}
+
+	for (const UBMeshEdge* Edge : Mesh->Edges)
+	{
+		if (Edge->Loop == nullptr)
+		{
+			const int32 Indices[2] = { Edge->Vert1->Index, Edge->Vert2->Index };
+			Writer.Write(Indices, sizeof(Indices));
+		}
+	}
+
+	if (!Writer.Flush())
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Failed writing %s"), *Filename);
+		return false;
+	}
+	return true;
+}
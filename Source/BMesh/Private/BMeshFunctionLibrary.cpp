@@ -29,6 +29,7 @@
 #include "BMeshFunctionLibrary.h"
 
 #include "BMesh.h"
+#include "BMeshFace.h"
 #include "BMeshOperators.h"
 #include "BMeshLog.h"
 
@@ -53,6 +54,13 @@ bool UBMeshFunctionLibrary::MergeFaces(UBMesh* mesh, UBMeshEdge* Edge)
 	return FBMeshOperators::MergeFaces(mesh, Edge);
 }
 
+int32 UBMeshFunctionLibrary::MergeRandomTrianglePairs(UBMesh* mesh, int32 Seed, float Ratio)
+{
+	if (!mesh)
+		return 0;
+	return FBMeshOperators::MergeRandomTrianglePairs(mesh, Seed, Ratio);
+}
+
 void UBMeshFunctionLibrary::SquarifyQuads(UBMesh* mesh, float rate, bool uniformLength)
 {
 	if (!mesh)
@@ -92,6 +100,145 @@ void UBMeshFunctionLibrary::SubdivideTriangleFanSingle(UBMeshFace* Face)
 	FBMeshOperators::SubdivideTriangleFan({Face});
 }
 
+void UBMeshFunctionLibrary::Triangulate(UBMesh* mesh)
+{
+	if (!mesh)
+		return;
+	FBMeshOperators::Triangulate(mesh);
+}
+
+void UBMeshFunctionLibrary::TriangulateFaces(UBMesh* mesh, TArray<UBMeshFace*> Faces)
+{
+	if (!mesh)
+		return;
+	for (const auto* Face : Faces)
+	{
+		if (Face == nullptr || Face->GetOuter() != mesh)
+		{
+			UE_LOG(LogBMesh, Error, TEXT("Invalid face, aborting"));
+			return;
+		}
+	}
+	FBMeshOperators::Triangulate(mesh, Faces);
+}
+
+int32 UBMeshFunctionLibrary::WeldVertices(UBMesh* mesh, float Tolerance)
+{
+	if (!mesh)
+		return 0;
+	return FBMeshOperators::WeldVertices(mesh, Tolerance);
+}
+
+void UBMeshFunctionLibrary::Remesh(UBMesh* mesh, float TargetEdgeLength, int32 Iterations)
+{
+	if (!mesh)
+		return;
+	FBMeshOperators::FRemeshParams Params;
+	Params.TargetEdgeLength = TargetEdgeLength;
+	Params.Iterations = Iterations;
+	FBMeshOperators::Remesh(mesh, Params);
+}
+
+namespace
+{
+	bool AreFacesOfMesh(const UBMesh* mesh, const TArray<UBMeshFace*>& Faces)
+	{
+		for (const auto* Face : Faces)
+		{
+			if (Face == nullptr || Face->GetOuter() != mesh)
+			{
+				UE_LOG(LogBMesh, Error, TEXT("Invalid face, aborting"));
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TArray<UBMeshFace*> UBMeshFunctionLibrary::ExtrudeFaces(UBMesh* mesh, TArray<UBMeshFace*> Faces, float Distance, bool bIndividual)
+{
+	if (!mesh || !AreFacesOfMesh(mesh, Faces))
+		return {};
+	return FBMeshOperators::ExtrudeFaces(mesh, Faces, Distance, bIndividual ? EBMeshFaceRegionMode::Individual : EBMeshFaceRegionMode::Region);
+}
+
+TArray<UBMeshFace*> UBMeshFunctionLibrary::InsetFaces(UBMesh* mesh, TArray<UBMeshFace*> Faces, float Thickness, bool bIndividual)
+{
+	if (!mesh || !AreFacesOfMesh(mesh, Faces))
+		return {};
+	return FBMeshOperators::InsetFaces(mesh, Faces, Thickness, bIndividual ? EBMeshFaceRegionMode::Individual : EBMeshFaceRegionMode::Region);
+}
+
+UBMesh* UBMeshFunctionLibrary::Dual(UBMesh* mesh, bool bCloseBoundary)
+{
+	if (!mesh)
+		return nullptr;
+	return FBMeshOperators::Dual(mesh, bCloseBoundary ? EBMeshDualBoundary::Close : EBMeshDualBoundary::Clip);
+}
+
+bool UBMeshFunctionLibrary::Delaunay(UBMesh* mesh, const TArray<FVector2D>& Points)
+{
+	if (!mesh)
+		return false;
+	return FBMeshOperators::Delaunay(mesh, Points);
+}
+
+bool UBMeshFunctionLibrary::Voronoi(UBMesh* mesh, const TArray<FVector2D>& Points)
+{
+	if (!mesh)
+		return false;
+	return FBMeshOperators::Voronoi(mesh, Points);
+}
+
+bool UBMeshFunctionLibrary::SquareGrid(UBMesh* mesh, int32 NumX, int32 NumY, float CellSize)
+{
+	if (!mesh)
+		return false;
+	return FBMeshOperators::SquareGrid(mesh, NumX, NumY, CellSize);
+}
+
+bool UBMeshFunctionLibrary::TriangleGrid(UBMesh* mesh, int32 NumX, int32 NumY, float CellSize)
+{
+	if (!mesh)
+		return false;
+	return FBMeshOperators::TriangleGrid(mesh, NumX, NumY, CellSize);
+}
+
+bool UBMeshFunctionLibrary::HexagonGrid(UBMesh* mesh, int32 Subdivisions, float CellSize)
+{
+	if (!mesh)
+		return false;
+	return FBMeshOperators::HexagonGrid(mesh, Subdivisions, CellSize);
+}
+
+void UBMeshFunctionLibrary::Merge(UBMesh* mesh, TArray<UBMesh*> Others)
+{
+	if (!mesh)
+		return;
+	Others.RemoveAll([mesh](UBMesh* Other) { return Other == nullptr || Other == mesh; });
+	FBMeshOperators::Merge(mesh, Others);
+}
+
+int32 UBMeshFunctionLibrary::ComputeVertexComponents(UBMesh* mesh, TArray<int32>& ComponentIds, TArray<int32>& ComponentSizes)
+{
+	if (!mesh)
+		return 0;
+	FBMeshConnectedComponents Components = FBMeshOperators::ComputeConnectedComponents(mesh, EBMeshConnectivity::Vertex);
+	ComponentIds = MoveTemp(Components.ComponentIds);
+	ComponentSizes = MoveTemp(Components.ComponentSizes);
+	return ComponentSizes.Num();
+}
+
+int32 UBMeshFunctionLibrary::ComputeFaceComponents(UBMesh* mesh, TArray<int32>& ComponentIds, TArray<int32>& ComponentSizes)
+{
+	if (!mesh)
+		return 0;
+	FBMeshConnectedComponents Components = FBMeshOperators::ComputeConnectedComponents(mesh, EBMeshConnectivity::Face);
+	ComponentIds = MoveTemp(Components.ComponentIds);
+	ComponentSizes = MoveTemp(Components.ComponentSizes);
+	return ComponentSizes.Num();
+}
+
 void UBMeshFunctionLibrary::DrawDebugBMesh(UObject* WorldContextObject, FTransform LocalToWorld, UBMesh* mesh)
 {
 	if (!mesh)
@@ -68,6 +68,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
 	static bool MergeFaces(UBMesh* mesh, UBMeshEdge* Edge);
 
+	/**
+	 * Merge random pairs of adjacent triangles into quads, the result only depends on the seed
+	 * @param Ratio probability that each edge between two triangles is considered for merging
+	 * @retval number of merged pairs
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static int32 MergeRandomTrianglePairs(UBMesh* mesh, int32 Seed, float Ratio = 1.0f);
+
 	/**
 	 * Try to make quads as square as possible (may be called iteratively).
 	 * This is not a very common operation but was developed so I keep it here.
@@ -102,6 +110,124 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators", meta = (DisplayName="Subdivide Triangle Fan"))
 	static void SubdivideTriangleFanSingle(UBMeshFace* Face);
+
+	/**
+	 * Split all faces with more than 3 corners into triangles, without adding vertices
+	 * Loop and face attributes are copied to the triangles
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static void Triangulate(UBMesh* mesh);
+
+	/**
+	 * Split the given faces into triangles, without adding vertices
+	 * Loop and face attributes are copied to the triangles
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators", meta = (DisplayName="Triangulate"))
+	static void TriangulateFaces(UBMesh* mesh, TArray<UBMeshFace*> Faces);
+	
+	/**
+	 * Merge vertices that are closer than Tolerance to each other (merge by distance).
+	 * The lowest index vertex of each cluster is kept, and collapsed edges and faces are removed
+	 * Overriding attributes: vertex's id
+	 * @retval number of vertices removed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static int32 WeldVertices(UBMesh* mesh, float Tolerance = 0.001f);
+
+	/**
+	 * Make edge lengths uniform by splitting, collapsing and flipping edges and relaxing vertices.
+	 * The mesh is triangulated first
+	 * @param TargetEdgeLength the mean edge length of the mesh if not positive
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static void Remesh(UBMesh* mesh, float TargetEdgeLength = -1.0f, int32 Iterations = 5);
+
+	/**
+	 * Move faces along their normals, building side walls between them and where they were
+	 * @param bIndividual whether faces sharing edges are extruded separately instead of as one region
+	 * @retval the moved faces
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static TArray<UBMeshFace*> ExtrudeFaces(UBMesh* mesh, TArray<UBMeshFace*> Faces, float Distance, bool bIndividual = false);
+
+	/**
+	 * Shrink faces within their plane, filling the gap with a ring of quads
+	 * @param bIndividual whether faces sharing edges are inset separately instead of as one region
+	 * @retval the inner faces
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static TArray<UBMeshFace*> InsetFaces(UBMesh* mesh, TArray<UBMeshFace*> Faces, float Thickness, bool bIndividual = false);
+
+	/**
+	 * Make the dual of a mesh: faces become vertices and vertices become faces
+	 * @param bCloseBoundary whether boundary vertices get a face closed along their boundary edges
+	 * @retval the dual mesh
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static UBMesh* Dual(UBMesh* mesh, bool bCloseBoundary = false);
+
+	/**
+	 * Add the Delaunay triangulation of 2D points to a mesh, in the XY plane
+	 * @retval false if the points are less than 3 or collinear
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static bool Delaunay(UBMesh* mesh, const TArray<FVector2D>& Points);
+
+	/**
+	 * Add the Voronoi diagram of 2D points to a mesh, in the XY plane, without the unbounded cells
+	 * @retval false if no cell was added
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static bool Voronoi(UBMesh* mesh, const TArray<FVector2D>& Points);
+
+	/**
+	 * Add a grid of square cells to a mesh, in the XY plane and centered on the origin
+	 * @retval false if the grid is empty
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static bool SquareGrid(UBMesh* mesh, int32 NumX, int32 NumY, float CellSize = 1.0f);
+
+	/**
+	 * Add a rectangular patch of equilateral triangles to a mesh, in the XY plane and centered on the origin
+	 * @param NumX the number of edges along each row of vertices
+	 * @param NumY the number of rows of triangles
+	 * @retval false if the grid is empty
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static bool TriangleGrid(UBMesh* mesh, int32 NumX, int32 NumY, float CellSize = 1.0f);
+
+	/**
+	 * Add a regular hexagon made of equilateral triangles to a mesh, in the XY plane and centered on the origin
+	 * @param Subdivisions the number of edges along each side of the hexagon
+	 * @retval false if there are no subdivisions
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static bool HexagonGrid(UBMesh* mesh, int32 Subdivisions, float CellSize = 1.0f);
+
+	/**
+	 * Find the groups of vertices connected to each other by edges.
+	 * ComponentIds has the component of each vertex, in the same order as the mesh's Vertices
+	 * Overriding attributes: vertex's id
+	 * @retval number of components
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static int32 ComputeVertexComponents(UBMesh* mesh, TArray<int32>& ComponentIds, TArray<int32>& ComponentSizes);
+
+	/**
+	 * Find the groups of faces connected to each other by edges (i.e. the islands of the mesh).
+	 * ComponentIds has the component of each face, in the same order as the mesh's Faces
+	 * Overriding attributes: face's id
+	 * @retval number of components
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static int32 ComputeFaceComponents(UBMesh* mesh, TArray<int32>& ComponentIds, TArray<int32>& ComponentSizes);
+
+	/**
+	 * Add copies of all elements of the other meshes to this mesh, along with their attributes
+	 * The other meshes are not modified
+	 */
+	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators")
+	static void Merge(UBMesh* mesh, TArray<UBMesh*> Others);
 	
 	UFUNCTION(BlueprintCallable, Category = "BMesh|Operators", meta=(WorldContext=WorldContextObject))
 	static void DrawDebugBMesh(UObject* WorldContextObject, FTransform LocalToWorld, UBMesh* mesh);
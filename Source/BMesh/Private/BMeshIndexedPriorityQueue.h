@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Binary min-heap of element indices in [0, Num), keyed by a cost. The position of each element in
+ * the heap is tracked, so the cost of any element can be changed, or the element removed, in
+ * O(log n) without searching for it. Used to hold candidate operations (e.g. edge collapses) whose
+ * cost changes as the mesh is edited.
+ */
+class FBMeshIndexedPriorityQueue
+{
+public:
+	explicit FBMeshIndexedPriorityQueue(int32 Num)
+	{
+		Positions.Init(INDEX_NONE, Num);
+		Costs.SetNumZeroed(Num);
+	}
+
+	bool IsEmpty() const { return Heap.Num() == 0; }
+
+	bool Contains(int32 Element) const { return Positions[Element] != INDEX_NONE; }
+
+	int32 Top() const { return Heap[0]; }
+
+	float GetCost(int32 Element) const { return Costs[Element]; }
+
+	/**
+	 * Insert the element, or change its cost if it's already in the queue
+	 */
+	void Update(int32 Element, float Cost)
+	{
+		Costs[Element] = Cost;
+		if (Positions[Element] == INDEX_NONE)
+		{
+			Positions[Element] = Heap.Add(Element);
+			SiftUp(Positions[Element]);
+		}
+		else
+		{
+			SiftDown(SiftUp(Positions[Element]));
+		}
+	}
+
+	void Remove(int32 Element)
+	{
+		const int32 Position = Positions[Element];
+		if (Position == INDEX_NONE)
+			return;
+		Positions[Element] = INDEX_NONE;
+		const int32 Last = Heap.Pop();
+		if (Position < Heap.Num())
+		{
+			Heap[Position] = Last;
+			Positions[Last] = Position;
+			SiftDown(SiftUp(Position));
+		}
+	}
+
+	int32 Pop()
+	{
+		const int32 Element = Heap[0];
+		Remove(Element);
+		return Element;
+	}
+
+private:
+	bool Less(int32 PositionA, int32 PositionB) const
+	{
+		return Costs[Heap[PositionA]] < Costs[Heap[PositionB]];
+	}
+
+	void Swap(int32 PositionA, int32 PositionB)
+	{
+		Heap.Swap(PositionA, PositionB);
+		Positions[Heap[PositionA]] = PositionA;
+		Positions[Heap[PositionB]] = PositionB;
+	}
+
+	int32 SiftUp(int32 Position)
+	{
+		while (Position > 0)
+		{
+			const int32 Parent = (Position - 1) / 2;
+			if (!Less(Position, Parent))
+				break;
+			Swap(Position, Parent);
+			Position = Parent;
+		}
+		return Position;
+	}
+
+	int32 SiftDown(int32 Position)
+	{
+		for (;;)
+		{
+			const int32 Left = Position * 2 + 1;
+			const int32 Right = Left + 1;
+			int32 Smallest = Position;
+			if (Left < Heap.Num() && Less(Left, Smallest))
+			{
+				Smallest = Left;
+			}
+			if (Right < Heap.Num() && Less(Right, Smallest))
+			{
+				Smallest = Right;
+			}
+			if (Smallest == Position)
+				return Position;
+			Swap(Position, Smallest);
+			Position = Smallest;
+		}
+	}
+
+	TArray<int32> Heap;
+	TArray<int32> Positions;
+	TArray<float> Costs;
+};
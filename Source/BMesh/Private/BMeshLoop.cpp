@@ -46,6 +46,73 @@ UBMeshLoop* UBMeshLoop::MakeLoop(TSubclassOf<UBMeshLoop> LoopClass, UBMeshVertex
 	return nullptr;
 }
 
+UBMeshLoop* UBMeshLoop::MakeLoopAfter(TSubclassOf<UBMeshLoop> LoopClass, UBMeshVertex* Vertex, UBMeshEdge* Edge,
+                                      UBMeshLoop* After)
+{
+	check(After && After->Face);
+	if (LoopClass)
+	{
+		UBMeshLoop* NewLoop = NewObject<UBMeshLoop>(Edge->GetOuter(), *LoopClass);
+		NewLoop->Vert = Vertex;
+		NewLoop->SetEdge(Edge);
+		NewLoop->Face = After->Face;
+		NewLoop->Prev = After;
+		NewLoop->Next = After->Next;
+		After->Next->Prev = NewLoop;
+		After->Next = NewLoop;
+		++NewLoop->Face->VertCount;
+		return NewLoop;
+	}
+	return nullptr;
+}
+
+void UBMeshLoop::MoveToEdge(UBMeshEdge* e)
+{
+	RemoveFromRadial();
+	SetEdge(e);
+}
+
+void UBMeshLoop::RemoveFromRadial()
+{
+	check(Edge != nullptr);
+	if (RadialNext == this)
+	{
+		Edge->Loop = nullptr;
+	}
+	else
+	{
+		RadialPrev->RadialNext = RadialNext;
+		RadialNext->RadialPrev = RadialPrev;
+		if (Edge->Loop == this)
+		{
+			Edge->Loop = RadialNext;
+		}
+	}
+	RadialNext = RadialPrev = this;
+	Edge = nullptr;
+}
+
+void UBMeshLoop::RemoveFromFace()
+{
+	check(Face != nullptr);
+	if (Next == this)
+	{
+		Face->FirstLoop = nullptr;
+	}
+	else
+	{
+		Prev->Next = Next;
+		Next->Prev = Prev;
+		if (Face->FirstLoop == this)
+		{
+			Face->FirstLoop = Next;
+		}
+	}
+	--Face->VertCount;
+	Next = Prev = nullptr;
+	Face = nullptr;
+}
+
 void UBMeshLoop::SetFace(UBMeshFace* f)
 {
 	check(Face == nullptr);
@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshMappedFile.h"
+
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+
+#include "BMeshCore.h"
+#include "BMeshBuilder.h"
+#include "BMeshOperators.h"
+#include "BMeshLog.h"
+
+namespace
+{
+	constexpr uint32 MappedFileMagic = 0x464D4D42; // "BMMF"
+	constexpr uint32 MappedFileVersion = 1;
+	constexpr int64 SectionAlignment = 16;
+
+	template <typename T>
+	bool WriteSection(IFileHandle& File, const TArray<T>& Data)
+	{
+		return Data.Num() == 0 || File.Write(reinterpret_cast<const uint8*>(Data.GetData()), Data.Num() * sizeof(T));
+	}
+
+	/**
+	 * Pad the file so the next section starts aligned
+	 * @retval offset of the next section
+	 */
+	int64 AlignSection(IFileHandle& File, bool& bOk)
+	{
+		static const uint8 Zeros[SectionAlignment] = {};
+		const int64 Offset = File.Tell();
+		const int64 Padding = Align(Offset, SectionAlignment) - Offset;
+		bOk = bOk && (Padding == 0 || File.Write(Zeros, Padding));
+		return Offset + Padding;
+	}
+
+	struct FAttributeColumn
+	{
+		FProperty* Property;
+		EBMeshElementType ElementType;
+	};
+
+	void CollectAttributeColumns(UClass* ElementClass, UClass* BaseClass, EBMeshElementType ElementType, TArray<FAttributeColumn>& OutColumns)
+	{
+		const FBMeshOperators::FAttributeLayout Layout(ElementClass, BaseClass);
+		for (int32 i = 0; i < Layout.Num(); ++i)
+		{
+			FProperty* Property = Layout.GetProperty(i);
+			if (!Property->HasAnyPropertyFlags(CPF_IsPlainOldData))
+			{
+				UE_LOG(LogBMesh, Log, TEXT("Attribute %s of %s is not plain old data, it is not written to the mapped file"),
+				       *Property->GetName(), *ElementClass->GetName());
+				continue;
+			}
+			if (Property->GetName().Len() >= UE_ARRAY_COUNT(FBMeshMappedFile::FAttributeHeader::Name)
+				|| Property->GetCPPType().Len() >= UE_ARRAY_COUNT(FBMeshMappedFile::FAttributeHeader::Type))
+			{
+				UE_LOG(LogBMesh, Warning, TEXT("Attribute %s of %s has a name or type too long for the mapped file, it is not written"),
+				       *Property->GetName(), *ElementClass->GetName());
+				continue;
+			}
+			OutColumns.Add({Property, ElementType});
+		}
+	}
+
+	template <typename T>
+	bool WriteColumn(IFileHandle& File, const FProperty* Property, const TArray<T*>& Elements)
+	{
+		const int32 Stride = Property->ElementSize * Property->ArrayDim;
+		TArray<uint8> Values;
+		Values.SetNumUninitialized(Elements.Num() * Stride);
+		for (int32 i = 0; i < Elements.Num(); ++i)
+		{
+			FMemory::Memcpy(&Values[i * Stride], Property->ContainerPtrToValuePtr<void>(Elements[i]), Stride);
+		}
+		return WriteSection(File, Values);
+	}
+
+	template <typename T>
+	bool MapSection(const uint8* Data, int64 FileSize, int64 Offset, int64 Num, TArrayView<const T>& OutView)
+	{
+		if (Offset < (int64)sizeof(FBMeshMappedFile::FHeader) || Offset % alignof(T) != 0 || Num < 0 || Num > MAX_int32
+			|| Offset > FileSize || Num > (FileSize - Offset) / (int64)sizeof(T))
+		{
+			return false;
+		}
+		OutView = TArrayView<const T>(reinterpret_cast<const T*>(Data + Offset), (int32)Num);
+		return true;
+	}
+
+	template <typename T>
+	void CopyAttribute(const FBMeshMappedAttribute& Attribute, UClass* ElementClass, UClass* BaseClass, const TArray<T*>& Elements)
+	{
+		FProperty* Property = ElementClass->FindPropertyByName(Attribute.Name);
+		if (!Property || BaseClass->IsChildOf(Property->GetOwnerClass()) || !Property->HasAnyPropertyFlags(CPF_IsPlainOldData)
+			|| Property->GetCPPType() != Attribute.Type || Property->ElementSize * Property->ArrayDim != Attribute.Stride)
+		{
+			UE_LOG(LogBMesh, Log, TEXT("Attribute %s (%s) has no matching property in %s, it is not copied"),
+			       *Attribute.Name.ToString(), *Attribute.Type, *ElementClass->GetName());
+			return;
+		}
+		check(Elements.Num() == Attribute.Num);
+		for (int32 i = 0; i < Elements.Num(); ++i)
+		{
+			FMemory::Memcpy(Property->ContainerPtrToValuePtr<void>(Elements[i]), Attribute.Data + i * Attribute.Stride, Attribute.Stride);
+		}
+	}
+}
+
+bool FBMeshMappedFile::Write(const UBMesh* Mesh, const FString& Filename)
+{
+	check(Mesh);
+
+	TArray<float> PositionData;
+	PositionData.Reserve(Mesh->Vertices.Num() * 3);
+	for (const UBMeshVertex* Vertex : Mesh->Vertices)
+	{
+		PositionData.Add(Vertex->Location.X);
+		PositionData.Add(Vertex->Location.Y);
+		PositionData.Add(Vertex->Location.Z);
+	}
+
+	// Loops are laid out face by face, in cycle order starting from each face's first loop
+	TArray<int32> FaceOffsetData;
+	TArray<int32> LoopVertexData;
+	TArray<int32> LoopEdgeData;
+	TArray<UBMeshLoop*> OrderedLoops;
+	FaceOffsetData.Reserve(Mesh->Faces.Num() + 1);
+	LoopVertexData.Reserve(Mesh->Loops.Num());
+	LoopEdgeData.Reserve(Mesh->Loops.Num());
+	OrderedLoops.Reserve(Mesh->Loops.Num());
+	FaceOffsetData.Add(0);
+	for (const UBMeshFace* Face : Mesh->Faces)
+	{
+		for (UBMeshLoop* Loop : Face->Loops())
+		{
+			OrderedLoops.Add(Loop);
+			LoopVertexData.Add(Loop->Vert->Index);
+			LoopEdgeData.Add(Loop->Edge->Index);
+		}
+		FaceOffsetData.Add(OrderedLoops.Num());
+	}
+
+	TArray<int32> EdgeVertexData;
+	EdgeVertexData.Reserve(Mesh->Edges.Num() * 2);
+	for (const UBMeshEdge* Edge : Mesh->Edges)
+	{
+		EdgeVertexData.Add(Edge->Vert1->Index);
+		EdgeVertexData.Add(Edge->Vert2->Index);
+	}
+
+	TArray<FAttributeColumn> Columns;
+	CollectAttributeColumns(*Mesh->VertexClass, UBMeshVertex::StaticClass(), EBMeshElementType::Vertex, Columns);
+	CollectAttributeColumns(*Mesh->EdgeClass, UBMeshEdge::StaticClass(), EBMeshElementType::Edge, Columns);
+	CollectAttributeColumns(*Mesh->LoopClass, UBMeshLoop::StaticClass(), EBMeshElementType::Loop, Columns);
+	CollectAttributeColumns(*Mesh->FaceClass, UBMeshFace::StaticClass(), EBMeshElementType::Face, Columns);
+
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't open %s for writing"), *Filename);
+		return false;
+	}
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = MappedFileMagic;
+	Header.Version = MappedFileVersion;
+	Header.NumVertices = Mesh->Vertices.Num();
+	Header.NumEdges = Mesh->Edges.Num();
+	Header.NumLoops = OrderedLoops.Num();
+	Header.NumFaces = Mesh->Faces.Num();
+	Header.NumAttributes = Columns.Num();
+
+	TArray<FAttributeHeader> AttributeHeaders;
+	AttributeHeaders.SetNumZeroed(Columns.Num());
+
+	// The header and attribute table are written again once all section offsets are known
+	bool bOk = File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	Header.PositionsOffset = AlignSection(*File, bOk);
+	bOk = bOk && WriteSection(*File, PositionData);
+	Header.FaceOffsetsOffset = AlignSection(*File, bOk);
+	bOk = bOk && WriteSection(*File, FaceOffsetData);
+	Header.LoopVerticesOffset = AlignSection(*File, bOk);
+	bOk = bOk && WriteSection(*File, LoopVertexData);
+	Header.LoopEdgesOffset = AlignSection(*File, bOk);
+	bOk = bOk && WriteSection(*File, LoopEdgeData);
+	Header.EdgeVerticesOffset = AlignSection(*File, bOk);
+	bOk = bOk && WriteSection(*File, EdgeVertexData);
+	Header.AttributesOffset = AlignSection(*File, bOk);
+	bOk = bOk && WriteSection(*File, AttributeHeaders);
+
+	for (int32 i = 0; i < Columns.Num() && bOk; ++i)
+	{
+		const FProperty* Property = Columns[i].Property;
+		FAttributeHeader& AttributeHeader = AttributeHeaders[i];
+		FCStringAnsi::Strncpy(AttributeHeader.Name, TCHAR_TO_ANSI(*Property->GetName()), UE_ARRAY_COUNT(AttributeHeader.Name));
+		FCStringAnsi::Strncpy(AttributeHeader.Type, TCHAR_TO_ANSI(*Property->GetCPPType()), UE_ARRAY_COUNT(AttributeHeader.Type));
+		AttributeHeader.ElementType = (uint8)Columns[i].ElementType;
+		AttributeHeader.Stride = Property->ElementSize * Property->ArrayDim;
+		AttributeHeader.Offset = AlignSection(*File, bOk);
+		switch (Columns[i].ElementType)
+		{
+		case EBMeshElementType::Vertex: bOk = bOk && WriteColumn(*File, Property, Mesh->Vertices); break;
+		case EBMeshElementType::Edge: bOk = bOk && WriteColumn(*File, Property, Mesh->Edges); break;
+		case EBMeshElementType::Loop: bOk = bOk && WriteColumn(*File, Property, OrderedLoops); break;
+		case EBMeshElementType::Face: bOk = bOk && WriteColumn(*File, Property, Mesh->Faces); break;
+		}
+	}
+
+	bOk = bOk && File->Seek(0) && File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	bOk = bOk && File->Seek(Header.AttributesOffset) && WriteSection(*File, AttributeHeaders);
+	bOk = bOk && File->Flush();
+	if (!bOk)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Failed writing mesh to %s"), *Filename);
+	}
+	return bOk;
+}
+
+TUniquePtr<FBMeshMappedFile> FBMeshMappedFile::Open(const FString& Filename)
+{
+	TUniquePtr<FBMeshMappedFile> File(new FBMeshMappedFile());
+	File->Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!File->Handle)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't map %s"), *Filename);
+		return nullptr;
+	}
+	const int64 FileSize = File->Handle->GetFileSize();
+	if (FileSize < (int64)sizeof(FHeader))
+	{
+		UE_LOG(LogBMesh, Error, TEXT("%s is not a mapped mesh file"), *Filename);
+		return nullptr;
+	}
+	File->Region.Reset(File->Handle->MapRegion(0, FileSize));
+	if (!File->Region)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Can't map %s"), *Filename);
+		return nullptr;
+	}
+
+	const uint8* Data = File->Region->GetMappedPtr();
+	const FHeader* Header = reinterpret_cast<const FHeader*>(Data);
+	if (Header->Magic != MappedFileMagic || Header->Version != MappedFileVersion)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("%s is not a mapped mesh file, or was written by another version"), *Filename);
+		return nullptr;
+	}
+	File->Header = Header;
+
+	TArrayView<const FAttributeHeader> AttributeHeaders;
+	bool bValid = Header->NumVertices >= 0 && Header->NumEdges >= 0 && Header->NumLoops >= 0 && Header->NumFaces >= 0
+		&& MapSection(Data, FileSize, Header->PositionsOffset, Header->NumVertices * 3ll, File->Positions)
+		&& MapSection(Data, FileSize, Header->FaceOffsetsOffset, Header->NumFaces + 1ll, File->FaceOffsets)
+		&& MapSection(Data, FileSize, Header->LoopVerticesOffset, Header->NumLoops, File->LoopVertices)
+		&& MapSection(Data, FileSize, Header->LoopEdgesOffset, Header->NumLoops, File->LoopEdges)
+		&& MapSection(Data, FileSize, Header->EdgeVerticesOffset, Header->NumEdges * 2ll, File->EdgeVertices)
+		&& MapSection(Data, FileSize, Header->AttributesOffset, Header->NumAttributes, AttributeHeaders);
+
+	for (int32 i = 0; i < AttributeHeaders.Num() && bValid; ++i)
+	{
+		const FAttributeHeader& AttributeHeader = AttributeHeaders[i];
+		const int32 NumElements[] = { Header->NumVertices, Header->NumEdges, Header->NumLoops, Header->NumFaces };
+		TArrayView<const uint8> Values;
+		bValid = AttributeHeader.ElementType < UE_ARRAY_COUNT(NumElements) && AttributeHeader.Stride > 0
+			&& AttributeHeader.Name[UE_ARRAY_COUNT(AttributeHeader.Name) - 1] == 0
+			&& AttributeHeader.Type[UE_ARRAY_COUNT(AttributeHeader.Type) - 1] == 0
+			&& MapSection(Data, FileSize, AttributeHeader.Offset, (int64)NumElements[AttributeHeader.ElementType] * AttributeHeader.Stride, Values);
+		if (bValid)
+		{
+			FBMeshMappedAttribute& Attribute = File->Attributes.AddDefaulted_GetRef();
+			Attribute.Name = FName(AttributeHeader.Name);
+			Attribute.Type = ANSI_TO_TCHAR(AttributeHeader.Type);
+			Attribute.ElementType = (EBMeshElementType)AttributeHeader.ElementType;
+			Attribute.Stride = AttributeHeader.Stride;
+			Attribute.Num = NumElements[AttributeHeader.ElementType];
+			Attribute.Data = Values.GetData();
+		}
+	}
+
+	if (!bValid)
+	{
+		UE_LOG(LogBMesh, Error, TEXT("%s is truncated or corrupt"), *Filename);
+		return nullptr;
+	}
+	return File;
+}
+
+FBMeshMappedFile::~FBMeshMappedFile()
+{
+	// The region must be unmapped before its file is closed
+	Region.Reset();
+	Handle.Reset();
+}
+
+const FBMeshMappedAttribute* FBMeshMappedFile::FindAttribute(EBMeshElementType ElementType, FName Name) const
+{
+	return Attributes.FindByPredicate([ElementType, Name](const FBMeshMappedAttribute& Attribute)
+	{
+		return Attribute.ElementType == ElementType && Attribute.Name == Name;
+	});
+}
+
+bool FBMeshMappedFile::Validate() const
+{
+	const int32 NumVerts = NumVertices();
+	const int32 NumEdgesInFile = NumEdges();
+
+	if (FaceOffsets[0] != 0 || FaceOffsets[NumFaces()] != NumLoops())
+		return false;
+	for (int32 Face = 0; Face < NumFaces(); ++Face)
+	{
+		if (FaceOffsets[Face + 1] - FaceOffsets[Face] < 2)
+			return false;
+	}
+
+	for (int32 Edge = 0; Edge < NumEdgesInFile; ++Edge)
+	{
+		const FIntPoint Vertices = GetEdgeVertices(Edge);
+		if (Vertices.X < 0 || Vertices.X >= NumVerts || Vertices.Y < 0 || Vertices.Y >= NumVerts || Vertices.X == Vertices.Y)
+			return false;
+	}
+
+	// Edges are checked first, so the edge of each corner can be compared with its vertices
+	for (int32 Face = 0; Face < NumFaces(); ++Face)
+	{
+		const TArrayView<const int32> Vertices = GetFaceVertices(Face);
+		const TArrayView<const int32> Edges = GetFaceEdges(Face);
+		for (int32 k = 0; k < Vertices.Num(); ++k)
+		{
+			const int32 Vertex = Vertices[k];
+			const int32 NextVertex = Vertices[(k + 1) % Vertices.Num()];
+			if (Vertex < 0 || Vertex >= NumVerts || Vertex == NextVertex || Edges[k] < 0 || Edges[k] >= NumEdgesInFile)
+				return false;
+			const FIntPoint EdgeVertices = GetEdgeVertices(Edges[k]);
+			if (EdgeVertices != FIntPoint(Vertex, NextVertex) && EdgeVertices != FIntPoint(NextVertex, Vertex))
+				return false;
+		}
+	}
+	return true;
+}
+
+UBMesh* FBMeshMappedFile::ToBMesh(UObject* Outer, UBMesh::FMakeParams Params) const
+{
+	if (!Validate())
+	{
+		UE_LOG(LogBMesh, Error, TEXT("Mapped mesh has invalid indices, it can't be converted"));
+		return nullptr;
+	}
+
+	UBMesh* Mesh = UBMesh::Make(Outer, Params);
+	// The builder finds edges through a hash, so faces don't walk disk cycles to reuse them
+	FBMeshBuilder Builder(Mesh);
+	Builder.Reserve(NumVertices(), NumEdges(), NumLoops(), NumFaces());
+
+	for (int32 Vertex = 0; Vertex < NumVertices(); ++Vertex)
+	{
+		Builder.AddVertex(GetPosition(Vertex));
+	}
+
+	// Edges are added first so they keep the order of the file, faces then reuse them
+	TArray<UBMeshEdge*> Edges;
+	Edges.Reserve(NumEdges());
+	for (int32 Edge = 0; Edge < NumEdges(); ++Edge)
+	{
+		const FIntPoint Vertices = GetEdgeVertices(Edge);
+		Edges.Add(Builder.AddEdge(Vertices.X, Vertices.Y));
+	}
+
+	// The builder creates the loops of each face in order, so Mesh->Loops matches the loop arrays of the file
+	for (int32 Face = 0; Face < NumFaces(); ++Face)
+	{
+		Builder.AddFace(GetFaceVertices(Face));
+	}
+
+	for (const FBMeshMappedAttribute& Attribute : Attributes)
+	{
+		switch (Attribute.ElementType)
+		{
+		case EBMeshElementType::Vertex: CopyAttribute(Attribute, *Mesh->VertexClass, UBMeshVertex::StaticClass(), Mesh->Vertices); break;
+		case EBMeshElementType::Edge: CopyAttribute(Attribute, *Mesh->EdgeClass, UBMeshEdge::StaticClass(), Edges); break;
+		case EBMeshElementType::Loop: CopyAttribute(Attribute, *Mesh->LoopClass, UBMeshLoop::StaticClass(), Mesh->Loops); break;
+		case EBMeshElementType::Face: CopyAttribute(Attribute, *Mesh->FaceClass, UBMeshFace::StaticClass(), Mesh->Faces); break;
+		}
+	}
+	return Mesh;
+}
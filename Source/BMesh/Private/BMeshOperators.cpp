@@ -30,12 +30,19 @@
 #include "BMeshOperators.h"
 
 #include "DrawDebugHelpers.h"
+#include "Async/ParallelFor.h"
 
 #include "BMesh.h"
 #include "BMeshVertex.h"
 #include "BMeshEdge.h"
 #include "BMeshLoop.h"
 #include "BMeshFace.h"
+#include "BMeshUnionFind.h"
+#include "BMeshBuilder.h"
+#include "BMeshDelaunay.h"
+#include "BMeshIndexedPriorityQueue.h"
+#include "BMeshRadixSort.h"
+#include "BMeshLog.h"
 
 TMap<FFieldClass*, FBMeshOperators::FPropertyLerp*> FBMeshOperators::PropertyTypeLerps;
 TMap<UScriptStruct*, FBMeshOperators::FPropertyLerp*> FBMeshOperators::StructTypeLerps;
@@ -44,8 +51,8 @@ FBMeshOperators::FPropertyLerp::~FPropertyLerp()
 {
 }
 
-void FBMeshOperators::FStructPropertyLerp::Lerp(FProperty* Property, UBMeshVertex* destination, UBMeshVertex* v1,
-                                                UBMeshVertex* v2, float t)
+void FBMeshOperators::FStructPropertyLerp::Lerp(FProperty* Property, void* destination, const void* v1,
+                                                const void* v2, float t)
 {
 	FStructProperty* TypedProperty = static_cast<FStructProperty*>(Property);
 	if (FPropertyLerp* SpecificLerp = StructTypeLerps.FindRef(TypedProperty->Struct))
@@ -71,32 +78,124 @@ void FBMeshOperators::AttributeLerp(UBMesh* mesh, UBMeshVertex* destination, UBM
                                     float t)
 {
 	check(v1 && v2 && v1->GetClass() == v2->GetClass());
-	for (TFieldIterator<FProperty> PropertyIt(*mesh->VertexClass, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+	FAttributeLayout(*mesh->VertexClass, UBMeshVertex::StaticClass(), &mesh->VertexLayers).Lerp(destination, v1, v2, t);
+}
+
+namespace
+{
+	template <typename T>
+	int32 IndexOfElement(const UObject* Element)
+	{
+		return static_cast<const T*>(Element)->Index;
+	}
+}
+
+FBMeshOperators::FAttributeLayout::FAttributeLayout(UClass* ElementClass, UClass* BaseClass, FBMeshAttributeLayers* InLayers)
+{
+	check(ElementClass && ElementClass->IsChildOf(BaseClass));
+	if (InLayers && !InLayers->IsEmpty())
+	{
+		Layers = InLayers;
+		if (BaseClass == UBMeshVertex::StaticClass())
+			IndexOf = &IndexOfElement<UBMeshVertex>;
+		else if (BaseClass == UBMeshEdge::StaticClass())
+			IndexOf = &IndexOfElement<UBMeshEdge>;
+		else if (BaseClass == UBMeshLoop::StaticClass())
+			IndexOf = &IndexOfElement<UBMeshLoop>;
+		else if (ensureMsgf(BaseClass == UBMeshFace::StaticClass(), TEXT("Attribute layers need an element base class")))
+			IndexOf = &IndexOfElement<UBMeshFace>;
+		else
+			Layers = nullptr;
+	}
+	for (TFieldIterator<FProperty> PropertyIt(ElementClass, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+	{
+		if (BaseClass->IsChildOf((*PropertyIt)->GetOwnerClass()))
+			continue;
+		Attributes.Add({*PropertyIt, PropertyTypeLerps.FindRef((*PropertyIt)->GetClass())});
+	}
+}
+
+void FBMeshOperators::FAttributeLayout::Copy(UObject* Destination, const UObject* Source) const
+{
+	for (const FAttribute& Attribute : Attributes)
+	{
+		Attribute.Property->CopyCompleteValue_InContainer(Destination, Source);
+	}
+	if (Layers)
+	{
+		Layers->Copy(IndexOf(Destination), IndexOf(Source));
+	}
+}
+
+void FBMeshOperators::FAttributeLayout::Lerp(UObject* Destination, const UObject* A, const UObject* B, float t) const
+{
+	for (const FAttribute& Attribute : Attributes)
+	{
+		if (Attribute.Lerp)
+		{
+			Attribute.Lerp->Lerp(Attribute.Property, Destination, A, B, t);
+		}
+	}
+	if (Layers)
+	{
+		Layers->Lerp(IndexOf(Destination), IndexOf(A), IndexOf(B), t);
+	}
+}
+
+FBMeshOperators::FAttributeMapping::FAttributeMapping(UClass* DestinationClass, UClass* SourceClass, UClass* BaseClass)
+{
+	check(DestinationClass && DestinationClass->IsChildOf(BaseClass));
+	check(SourceClass && SourceClass->IsChildOf(BaseClass));
+	for (TFieldIterator<FProperty> PropertyIt(DestinationClass, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
 	{
-		if ((*PropertyIt)->GetOwnerClass() == UBMeshVertex::StaticClass())
+		FProperty* Property = *PropertyIt;
+		if (BaseClass->IsChildOf(Property->GetOwnerClass()))
 			continue;
-		if (FPropertyLerp* PropertyLerp = PropertyTypeLerps.FindRef((*PropertyIt)->GetClass()))
+		FProperty* SourceProperty = DestinationClass == SourceClass ? Property : SourceClass->FindPropertyByName(Property->GetFName());
+		if (SourceProperty && !BaseClass->IsChildOf(SourceProperty->GetOwnerClass())
+			&& SourceProperty->SameType(Property) && SourceProperty->ArrayDim == Property->ArrayDim)
 		{
-			PropertyLerp->Lerp(*PropertyIt, destination, v1, v2, t);
+			Properties.Emplace(Property, SourceProperty);
 		}
 	}
 }
 
+void FBMeshOperators::FAttributeMapping::Copy(UObject* Destination, const UObject* Source) const
+{
+	for (const TPair<FProperty*, FProperty*>& Pair : Properties)
+	{
+		Pair.Key->CopyCompleteValue(Pair.Key->ContainerPtrToValuePtr<void>(Destination), Pair.Value->ContainerPtrToValuePtr<void>(Source));
+	}
+}
+
 void FBMeshOperators::Subdivide(UBMesh* mesh)
 {
+	const FAttributeLayout VertexAttributes(*mesh->VertexClass, UBMeshVertex::StaticClass());
 	int i = 0;
 	TArray<UBMeshVertex*> edgeCenters;
 	edgeCenters.SetNum(mesh->Edges.Num());
+	// Attribute layers of the edge centers are interpolated in one batch
+	TArray<FBMeshAttributeLerp> edgeCenterLerps;
+	if (!mesh->VertexLayers.IsEmpty())
+		edgeCenterLerps.Reserve(mesh->Edges.Num());
 	// TArray<UBMeshEdge*> originalEdges;
 	// originalEdges.SetNum(mesh->Edges.Num());
 	for (UBMeshEdge* e : mesh->Edges)
 	{
 		edgeCenters[i] = mesh->AddVertex(e->Center());
-		AttributeLerp(mesh, edgeCenters[i], e->Vert1, e->Vert2, 0.5f);
+		VertexAttributes.Lerp(edgeCenters[i], e->Vert1, e->Vert2, 0.5f);
+		if (!mesh->VertexLayers.IsEmpty())
+			edgeCenterLerps.Add({edgeCenters[i]->Index, e->Vert1->Index, e->Vert2->Index, 0.5f});
 		// originalEdges[i] = e;
-		e->Id = i++;
+		++i;
 	}
+	mesh->VertexLayers.LerpBatch(edgeCenterLerps);
+
+	// Face centers accumulate their attributes one loop at a time, so their layers can't be batched
+	const FAttributeLayout FaceCenterAttributes(*mesh->VertexClass, UBMeshVertex::StaticClass(), &mesh->VertexLayers);
 
+	// Removed edges keep their index until the scope ends, so edgeCenters can still be looked up by it
+	FBMeshDeferredRemovalScope DeferredRemoval(mesh);
 	TArray<UBMeshFace*> originalFaces = mesh->Faces; // copy because mesh.faces changes during iterations
 	for (UBMeshFace* f : originalFaces)
 	{
@@ -108,13 +207,13 @@ void FBMeshOperators::Subdivide(UBMesh* mesh)
 		do
 		{
 			w += 1;
-			AttributeLerp(mesh, faceCenter, faceCenter, it->Vert, 1 / w);
+			FaceCenterAttributes.Lerp(faceCenter, faceCenter, it->Vert, 1 / w);
 
 			UBMeshVertex* quad[] = {
 				it->Vert,
-				edgeCenters[it->Edge->Id],
+				edgeCenters[it->Edge->Index],
 				faceCenter,
-				edgeCenters[it->Prev->Edge->Id]
+				edgeCenters[it->Prev->Edge->Index]
 			};
 			mesh->AddFace(quad);
 			it = it->Next;
@@ -141,28 +240,38 @@ bool FBMeshOperators::Subdivide3(UBMesh* mesh)
 			return false;
 	}
 
+	const FAttributeLayout VertexAttributes(*mesh->VertexClass, UBMeshVertex::StaticClass());
 	int i = 0;
 	TArray<UBMeshVertex*> edgeCenters;
 	edgeCenters.SetNum(mesh->Edges.Num());
+	// Attribute layers of the edge centers are interpolated in one batch
+	TArray<FBMeshAttributeLerp> edgeCenterLerps;
+	if (!mesh->VertexLayers.IsEmpty())
+		edgeCenterLerps.Reserve(mesh->Edges.Num());
 	// TArray<UBMeshEdge*> originalEdges;
 	// originalEdges.SetNum(mesh->Edges.Num());
 	for (UBMeshEdge* e : mesh->Edges)
 	{
 		edgeCenters[i] = mesh->AddVertex(e->Center());
-		AttributeLerp(mesh, edgeCenters[i], e->Vert1, e->Vert2, 0.5f);
+		VertexAttributes.Lerp(edgeCenters[i], e->Vert1, e->Vert2, 0.5f);
+		if (!mesh->VertexLayers.IsEmpty())
+			edgeCenterLerps.Add({edgeCenters[i]->Index, e->Vert1->Index, e->Vert2->Index, 0.5f});
 		// originalEdges[i] = e;
-		e->Id = i++;
+		++i;
 	}
+	mesh->VertexLayers.LerpBatch(edgeCenterLerps);
 
+	// Removed edges keep their index until the scope ends, so edgeCenters can still be looked up by it
+	FBMeshDeferredRemovalScope DeferredRemoval(mesh);
 	TArray<UBMeshFace*> originalFaces = mesh->Faces; // copy because mesh.faces changes during iterations
 	for (UBMeshFace* f : originalFaces)
 	{
 		//Center tri
 		{
 			UBMeshVertex* tri[] = {
-				edgeCenters[f->FirstLoop->Edge->Id],
-				edgeCenters[f->FirstLoop->Next->Edge->Id],
-				edgeCenters[f->FirstLoop->Prev->Edge->Id]
+				edgeCenters[f->FirstLoop->Edge->Index],
+				edgeCenters[f->FirstLoop->Next->Edge->Index],
+				edgeCenters[f->FirstLoop->Prev->Edge->Index]
 			};
 			mesh->AddFace(tri);
 		}
@@ -172,8 +281,8 @@ bool FBMeshOperators::Subdivide3(UBMesh* mesh)
 		{
 			UBMeshVertex* tri[] = {
 				it->Vert,
-				edgeCenters[it->Edge->Id],
-				edgeCenters[it->Prev->Edge->Id]
+				edgeCenters[it->Edge->Index],
+				edgeCenters[it->Prev->Edge->Index]
 			};
 			mesh->AddFace(tri);
 			it = it->Next;
@@ -225,6 +334,164 @@ bool FBMeshOperators::MergeFaces(UBMesh* Mesh, UBMeshEdge* Edge)
 	return true;
 }
 
+namespace
+{
+	/**
+	 * Hash an element index into a pseudo random number, so random choices don't depend on the
+	 * order in which threads visit the elements
+	 */
+	uint32 HashRandomIndex(uint32 Seed, uint32 Index)
+	{
+		uint32 Hash = Index * 0x9E3779B9u ^ Seed;
+		Hash ^= Hash >> 16;
+		Hash *= 0x85EBCA6Bu;
+		Hash ^= Hash >> 13;
+		Hash *= 0xC2B2AE35u;
+		Hash ^= Hash >> 16;
+		return Hash;
+	}
+
+	/**
+	 * Whether the edge is shared by exactly two different triangles whose union is a valid quad
+	 */
+	bool IsMergeableTrianglePair(const UBMeshEdge* Edge)
+	{
+		const UBMeshLoop* Loop1 = Edge->Loop;
+		if (Loop1 == nullptr || Loop1->RadialNext == Loop1 || Loop1->RadialNext->RadialNext != Loop1)
+			return false;
+		const UBMeshLoop* Loop2 = Loop1->RadialNext;
+		return Loop1->Face != Loop2->Face
+			&& Loop1->Face->VertCount == 3 && Loop2->Face->VertCount == 3
+			&& Loop1->Vert != Loop2->Vert
+			&& Loop1->Prev->Vert != Loop2->Prev->Vert;
+	}
+}
+
+int32 FBMeshOperators::MergeRandomTrianglePairs(UBMesh* Mesh, int32 Seed, float Ratio)
+{
+	check(Mesh);
+
+	// Candidate edges, in the order of the mesh's container
+	const int32 NumEdges = Mesh->Edges.Num();
+	TArray<bool> IsCandidate;
+	IsCandidate.SetNumZeroed(NumEdges);
+	const uint32 RatioSeed = HashRandomIndex(Seed, MAX_uint32);
+	ParallelFor(NumEdges, [&](int32 EdgeIndex)
+	{
+		const UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+		IsCandidate[EdgeIndex] = IsMergeableTrianglePair(Edge)
+			&& HashRandomIndex(RatioSeed, EdgeIndex) / double(MAX_uint32) < Ratio;
+	});
+	TArray<UBMeshEdge*> Candidates;
+	for (int32 EdgeIndex = 0; EdgeIndex < NumEdges; ++EdgeIndex)
+	{
+		if (IsCandidate[EdgeIndex])
+		{
+			Candidates.Add(Mesh->Edges[EdgeIndex]);
+		}
+	}
+	const int32 NumCandidates = Candidates.Num();
+	if (NumCandidates == 0)
+		return 0;
+
+	// Dual graph: the two triangles of each candidate, and the candidates (at most 3) of each triangle
+	TArray<FIntPoint> CandidateFaces;
+	CandidateFaces.SetNumUninitialized(NumCandidates);
+	TArray<int32> FaceCandidates;
+	FaceCandidates.Init(INDEX_NONE, Mesh->Faces.Num() * 3);
+	for (int32 Candidate = 0; Candidate < NumCandidates; ++Candidate)
+	{
+		const UBMeshLoop* Loop = Candidates[Candidate]->Loop;
+		CandidateFaces[Candidate] = FIntPoint(Loop->Face->Index, Loop->RadialNext->Face->Index);
+		for (const int32 Face : { CandidateFaces[Candidate].X, CandidateFaces[Candidate].Y })
+		{
+			int32* Slot = &FaceCandidates[Face * 3];
+			while (*Slot != INDEX_NONE)
+			{
+				++Slot;
+			}
+			*Slot = Candidate;
+		}
+	}
+
+	// Random priorities, unique because ties are broken by index
+	TArray<uint64> Priorities;
+	Priorities.SetNumUninitialized(NumCandidates);
+	ParallelFor(NumCandidates, [&](int32 Candidate)
+	{
+		Priorities[Candidate] = uint64(HashRandomIndex(Seed, Candidate)) << 32 | uint32(Candidate);
+	});
+
+	// Luby-style matching: in each round, every candidate whose priority is lower than the ones of
+	// all live candidates sharing a triangle with it is selected. Selected candidates never share a
+	// triangle, and each round selects at least the lowest live candidate, so the matching is maximal.
+	TArray<bool> IsLive;
+	IsLive.Init(true, NumCandidates);
+	TArray<bool> IsSelected;
+	IsSelected.SetNumZeroed(NumCandidates);
+	TArray<bool> IsFaceMatched;
+	IsFaceMatched.SetNumZeroed(Mesh->Faces.Num());
+	TArray<int32> Live;
+	Live.Reserve(NumCandidates);
+	for (int32 Candidate = 0; Candidate < NumCandidates; ++Candidate)
+	{
+		Live.Add(Candidate);
+	}
+	while (Live.Num() > 0)
+	{
+		ParallelFor(Live.Num(), [&](int32 LiveIndex)
+		{
+			const int32 Candidate = Live[LiveIndex];
+			bool bIsLocalMinimum = true;
+			for (const int32 Face : { CandidateFaces[Candidate].X, CandidateFaces[Candidate].Y })
+			{
+				for (int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const int32 Neighbor = FaceCandidates[Face * 3 + Corner];
+					if (Neighbor != INDEX_NONE && Neighbor != Candidate && IsLive[Neighbor] && Priorities[Neighbor] < Priorities[Candidate])
+					{
+						bIsLocalMinimum = false;
+					}
+				}
+			}
+			if (bIsLocalMinimum)
+			{
+				IsSelected[Candidate] = true;
+				IsFaceMatched[CandidateFaces[Candidate].X] = true;
+				IsFaceMatched[CandidateFaces[Candidate].Y] = true;
+			}
+		});
+
+		// Candidates touching a matched triangle are out
+		int32 NumLive = 0;
+		for (const int32 Candidate : Live)
+		{
+			if (IsFaceMatched[CandidateFaces[Candidate].X] || IsFaceMatched[CandidateFaces[Candidate].Y])
+			{
+				IsLive[Candidate] = false;
+			}
+			else
+			{
+				Live[NumLive++] = Candidate;
+			}
+		}
+		Live.SetNum(NumLive);
+	}
+
+	// Matched pairs share no triangle, so each merge only relinks its own loops
+	int32 NumMerged = 0;
+	FBMeshDeferredRemovalScope DeferredRemovals(Mesh);
+	for (int32 Candidate = 0; Candidate < NumCandidates; ++Candidate)
+	{
+		if (IsSelected[Candidate])
+		{
+			verify(DissolveEdge(Mesh, Candidates[Candidate]) != nullptr);
+			++NumMerged;
+		}
+	}
+	return NumMerged;
+}
+
 FMatrix FBMeshOperators::ComputeLocalAxis(FVector r0, FVector r1, FVector r2, FVector r3, bool bNormalIsUp)
 {
 	FVector Z = bNormalIsUp ? FVector::UpVector : (
@@ -316,7 +583,7 @@ void FBMeshOperators::SquarifyQuads(UBMesh* mesh, FSquarifyQuadsParams Params)
 						weights[i] = *WeightProperty->ContainerPtrToValuePtr<float>(v);
 						auto restpos = *RestposProperty->ContainerPtrToValuePtr<FVector>(v);
 						pointUpdates[i] = (restpos - v->Location) * weights[i];
-						v->Id = i++;
+						++i;
 					}
 				}
 				else if (WeightPropDouble)
@@ -326,7 +593,7 @@ void FBMeshOperators::SquarifyQuads(UBMesh* mesh, FSquarifyQuadsParams Params)
 						weights[i] = *WeightProperty->ContainerPtrToValuePtr<double>(v);
 						auto restpos = *RestposProperty->ContainerPtrToValuePtr<FVector>(v);
 						pointUpdates[i] = (restpos - v->Location) * weights[i];
-						v->Id = i++;
+						++i;
 					}
 				}
 			}
@@ -337,7 +604,7 @@ void FBMeshOperators::SquarifyQuads(UBMesh* mesh, FSquarifyQuadsParams Params)
 					weights[i] = 1;
 					auto restpos = *RestposProperty->ContainerPtrToValuePtr<FVector>(v);
 					pointUpdates[i] = (restpos - v->Location) * weights[i];
-					v->Id = i++;
+					++i;
 				}
 			}
 		}
@@ -347,7 +614,7 @@ void FBMeshOperators::SquarifyQuads(UBMesh* mesh, FSquarifyQuadsParams Params)
 			{
 				weights[i] = 0.0f;
 				pointUpdates[i] = FVector::ZeroVector;
-				v->Id = i++;
+				++i;
 			}
 		}
 	}
@@ -423,14 +690,14 @@ void FBMeshOperators::SquarifyQuads(UBMesh* mesh, FSquarifyQuadsParams Params)
 			FVector t3 = localToGlobal.TransformVector(lt3);
 
 			// Accumulate
-			pointUpdates[verts[0]->Id] += t0 - r[0];
-			pointUpdates[verts[1]->Id] += t1 - r[1];
-			pointUpdates[verts[2]->Id] += t2 - r[2];
-			pointUpdates[verts[3]->Id] += t3 - r[3];
-			weights[verts[0]->Id] += 1;
-			weights[verts[1]->Id] += 1;
-			weights[verts[2]->Id] += 1;
-			weights[verts[3]->Id] += 1;
+			pointUpdates[verts[0]->Index] += t0 - r[0];
+			pointUpdates[verts[1]->Index] += t1 - r[1];
+			pointUpdates[verts[2]->Index] += t2 - r[2];
+			pointUpdates[verts[3]->Index] += t3 - r[3];
+			weights[verts[0]->Index] += 1;
+			weights[verts[1]->Index] += 1;
+			weights[verts[2]->Index] += 1;
+			weights[verts[3]->Index] += 1;
 		}
 
 		// Apply updates
@@ -475,6 +742,69 @@ void FBMeshOperators::SubdivideTriangleFan(TArrayView<UBMeshFace* const> Faces)
 	}
 }
 
+void FBMeshOperators::Triangulate(UBMesh* Mesh, TArrayView<UBMeshFace* const> Faces, EBMeshTriangulationMethod Method)
+{
+	check(Mesh);
+	TArray<UBMeshFace*> Polygons;
+	Polygons.Reserve(Faces.Num());
+	for (UBMeshFace* Face : Faces)
+	{
+		check(Face != nullptr && Face->GetOuter() == Mesh);
+		if (Face->VertCount > 3)
+		{
+			Polygons.Add(Face);
+		}
+	}
+	if (Polygons.Num() == 0)
+		return;
+
+	const FBMeshTriangulation Triangulation = FBMeshTriangulation::Build(Polygons, Method);
+	const int32 NumTriangles = Triangulation.Triangles.Num();
+	const int32 FirstNewFace = Mesh->Faces.Num();
+	const int32 FirstNewLoop = Mesh->Loops.Num();
+	{
+		FBMeshBuilder Builder(Mesh);
+		// Diagonals are the only new edges, N - 3 per face
+		Builder.Reserve(0, NumTriangles - Polygons.Num(), NumTriangles * 3, NumTriangles);
+		for (const FIntVector& Triangle : Triangulation.Triangles)
+		{
+			UBMeshVertex* const Corners[3] = { Triangulation.Loops[Triangle.X]->Vert, Triangulation.Loops[Triangle.Y]->Vert, Triangulation.Loops[Triangle.Z]->Vert };
+			Builder.AddFace(MakeArrayView(Corners));
+		}
+	}
+
+	// The builder appends faces and loops in triangulation order
+	const FAttributeLayout FaceAttributes(Mesh->FaceClass, UBMeshFace::StaticClass(), &Mesh->FaceLayers);
+	const FAttributeLayout LoopAttributes(Mesh->LoopClass, UBMeshLoop::StaticClass(), &Mesh->LoopLayers);
+	ParallelFor(Polygons.Num(), [&](int32 PolygonIndex)
+	{
+		const UBMeshFace* Original = Polygons[PolygonIndex];
+		for (int32 i = Triangulation.TriangleOffsets[PolygonIndex]; i < Triangulation.TriangleOffsets[PolygonIndex + 1]; ++i)
+		{
+			UBMeshFace* Triangle = Mesh->Faces[FirstNewFace + i];
+			Triangle->Id = Original->Id;
+			FaceAttributes.Copy(Triangle, Original);
+			for (int32 Corner = 0; Corner < 3; ++Corner)
+			{
+				LoopAttributes.Copy(Mesh->Loops[FirstNewLoop + i * 3 + Corner], Triangulation.Loops[Triangulation.Triangles[i][Corner]]);
+			}
+		}
+	});
+
+	// Every edge of the original faces is now also used by a triangle, so no edge is removed here
+	FBMeshDeferredRemovalScope DeferredRemovals(Mesh);
+	for (UBMeshFace* Face : Polygons)
+	{
+		Mesh->RemoveFace(Face);
+	}
+}
+
+void FBMeshOperators::Triangulate(UBMesh* Mesh, EBMeshTriangulationMethod Method)
+{
+	check(Mesh);
+	Triangulate(Mesh, Mesh->Faces, Method);
+}
+
 void FBMeshOperators::DrawPrimitives(FPrimitiveDrawInterface* PDI, FTransform LocalToWorld, UBMesh* mesh)
 {
 	auto DrawLine = [=](FVector A, FVector B, FColor Color)
@@ -538,28 +868,119 @@ void FBMeshOperators::DrawPrimitives(TFunction<void(FVector, FVector, FColor)> D
 	}
 }
 
+namespace
+{
+	/**
+	 * Reorder elements so the one at Order[i] ends up at i, along with its values in the attribute layers
+	 */
+	template <typename T>
+	void PermuteElements(TArray<T*>& Elements, FBMeshAttributeLayers& Layers, const TArray<int32>& Order)
+	{
+		check(Order.Num() == Elements.Num());
+		TArray<T*> Sorted;
+		Sorted.SetNumUninitialized(Elements.Num());
+		ParallelFor(Elements.Num(), [&](int32 NewIndex)
+		{
+			Sorted[NewIndex] = Elements[Order[NewIndex]];
+			Sorted[NewIndex]->Index = NewIndex;
+		});
+		Elements = MoveTemp(Sorted);
+		Layers.Gather(Order);
+	}
+
+	/**
+	 * Sort elements by Z, then Y, then X of their locations, which are cached in the same order as
+	 * the elements so sorting doesn't touch the elements themselves. Elements at the same location
+	 * keep their order.
+	 */
+	template <typename T>
+	void SortElementsByLocations(TArray<T*>& Elements, FBMeshAttributeLayers& Layers, const TArray<FVector>& Locations)
+	{
+		TArray<int32> Order;
+		Order.SetNumUninitialized(Elements.Num());
+		for (int32 Index = 0; Index < Order.Num(); ++Index)
+		{
+			Order[Index] = Index;
+		}
+		Order.StableSort([&Locations](int32 A, int32 B)
+		{
+			const FVector& LocationA = Locations[A];
+			const FVector& LocationB = Locations[B];
+			if (LocationA.Z != LocationB.Z)
+				return LocationA.Z < LocationB.Z;
+			if (LocationA.Y != LocationB.Y)
+				return LocationA.Y < LocationB.Y;
+			return LocationA.X < LocationB.X;
+		});
+		PermuteElements(Elements, Layers, Order);
+	}
+
+	/**
+	 * Interleave the 21 lowest bits of a value with two zero bits each
+	 */
+	uint64 SpreadMortonBits(uint64 Value)
+	{
+		Value &= 0x1fffff;
+		Value = (Value | Value << 32) & 0x1f00000000ffffull;
+		Value = (Value | Value << 16) & 0x1f0000ff0000ffull;
+		Value = (Value | Value << 8) & 0x100f00f00f00f00full;
+		Value = (Value | Value << 4) & 0x10c30c30c30c30c3ull;
+		Value = (Value | Value << 2) & 0x1249249249249249ull;
+		return Value;
+	}
+
+	/**
+	 * Position of each point along a Morton (Z-order) curve through the bounding box of all of them,
+	 * on a grid of 2^21 cells per axis
+	 */
+	TArray<uint64> ComputeMortonCodes(const TArray<FVector>& Points)
+	{
+		FBox Bounds(ForceInit);
+		for (const FVector& Point : Points)
+		{
+			Bounds += Point;
+		}
+		constexpr double MaxCell = (1 << 21) - 1;
+		const FVector Size = Bounds.GetSize();
+		const FVector Scale(
+			Size.X > 0 ? MaxCell / Size.X : 0,
+			Size.Y > 0 ? MaxCell / Size.Y : 0,
+			Size.Z > 0 ? MaxCell / Size.Z : 0);
+
+		TArray<uint64> Codes;
+		Codes.SetNumUninitialized(Points.Num());
+		ParallelFor(Points.Num(), [&](int32 Index)
+		{
+			const FVector Cell = (Points[Index] - Bounds.Min) * Scale;
+			Codes[Index] = SpreadMortonBits(uint64(FMath::Clamp<double>(Cell.X, 0, MaxCell)))
+				| SpreadMortonBits(uint64(FMath::Clamp<double>(Cell.Y, 0, MaxCell))) << 1
+				| SpreadMortonBits(uint64(FMath::Clamp<double>(Cell.Z, 0, MaxCell))) << 2;
+		});
+		return Codes;
+	}
+}
+
 void FBMeshOperators::SortVertices(UBMesh* Mesh)
 {
-	Mesh->Vertices.Sort([](const UBMeshVertex& A, const UBMeshVertex& B)
+	TArray<FVector> Locations;
+	Locations.SetNumUninitialized(Mesh->Vertices.Num());
+	ParallelFor(Mesh->Vertices.Num(), [&](int32 VertexIndex)
 	{
-		if (A.Location.Z < B.Location.Z)
-			return true;
-		if (A.Location.Y < B.Location.Y)
-			return true;
-		return A.Location.X < B.Location.X && A.Location.Y <= B.Location.Y && A.Location.Z <= B.Location.Z;
+		Locations[VertexIndex] = Mesh->Vertices[VertexIndex]->Location;
 	});
+	SortElementsByLocations(Mesh->Vertices, Mesh->VertexLayers, Locations);
+	Mesh->MarkTopologyChanged();
 }
 
 void FBMeshOperators::SortFaceLoops(UBMesh* Mesh)
 {
-	Mesh->UpdateElementIds<UBMeshVertex>();
 	for (const auto Face : Mesh->Faces)
 	{
 		auto LowestLoop = Face->FirstLoop;
 		auto It = LowestLoop->Next;
 		do
 		{
-			if (It->Vert->Id < LowestLoop->Vert->Id)
+			if (It->Vert->Index < LowestLoop->Vert->Index)
 			{
 				LowestLoop = It;
 			}
@@ -568,66 +989,2546 @@ void FBMeshOperators::SortFaceLoops(UBMesh* Mesh)
 		while (It != Face->FirstLoop);
 		Face->FirstLoop = LowestLoop;
 	}
+	Mesh->MarkTopologyChanged();
 }
 
 void FBMeshOperators::SortFacesByCenters(UBMesh* Mesh)
 {
-	Mesh->UpdateElementIds<UBMeshFace>();
 	TArray<FVector> Centers;
-	Centers.Reserve(Mesh->Faces.Num());
-	for (const auto Face : Mesh->Faces)
+	Centers.SetNumUninitialized(Mesh->Faces.Num());
+	ParallelFor(Mesh->Faces.Num(), [&](int32 FaceIndex)
+	{
+		Centers[FaceIndex] = Mesh->Faces[FaceIndex]->Center();
+	});
+	SortElementsByLocations(Mesh->Faces, Mesh->FaceLayers, Centers);
+	Mesh->MarkTopologyChanged();
+}
+
+void FBMeshOperators::SortFacesByFirstLoopId(UBMesh* Mesh)
+{
+	TArray<int32> Order;
+	Order.SetNumUninitialized(Mesh->Faces.Num());
+	for (int32 FaceIndex = 0; FaceIndex < Order.Num(); ++FaceIndex)
 	{
-		Centers.Add(Face->Center());
+		Order[FaceIndex] = FaceIndex;
 	}
-	Mesh->Faces.Sort([&](const UBMeshFace& A, const UBMeshFace& B)
+	Order.StableSort([Mesh](int32 A, int32 B)
 	{
-		const auto& CA = Centers[A.Id];
-		const auto& CB = Centers[B.Id];
-		if (CA.Z < CB.Z)
-			return true;
-		if (CA.Y < CB.Y)
-			return true;
-		return CA.X < CB.X && CA.Y <= CB.Y && CA.Z <= CB.Z;
+		return Mesh->Faces[A]->FirstLoop->Vert->Index < Mesh->Faces[B]->FirstLoop->Vert->Index;
 	});
+	PermuteElements(Mesh->Faces, Mesh->FaceLayers, Order);
+	Mesh->MarkTopologyChanged();
 }
 
-void FBMeshOperators::SortFacesByFirstLoopId(UBMesh* Mesh)
+void FBMeshOperators::SortSpatially(UBMesh* Mesh)
 {
-	for (const auto Face : Mesh->Faces)
+	check(Mesh);
+
+	TArray<FVector> Locations;
+	Locations.SetNumUninitialized(Mesh->Vertices.Num());
+	ParallelFor(Mesh->Vertices.Num(), [&](int32 VertexIndex)
+	{
+		Locations[VertexIndex] = Mesh->Vertices[VertexIndex]->Location;
+	});
+	PermuteElements(Mesh->Vertices, Mesh->VertexLayers, BMeshRadixSort::SortIndices<uint64>(ComputeMortonCodes(Locations)));
+
+	TArray<FVector> Centers;
+	Centers.SetNumUninitialized(Mesh->Faces.Num());
+	ParallelFor(Mesh->Faces.Num(), [&](int32 FaceIndex)
+	{
+		Centers[FaceIndex] = Mesh->Faces[FaceIndex]->Center();
+	});
+	PermuteElements(Mesh->Faces, Mesh->FaceLayers, BMeshRadixSort::SortIndices<uint64>(ComputeMortonCodes(Centers)));
+
+	// Edges follow the first of their vertices in the new order
+	TArray<uint32> EdgeKeys;
+	EdgeKeys.SetNumUninitialized(Mesh->Edges.Num());
+	ParallelFor(Mesh->Edges.Num(), [&](int32 EdgeIndex)
+	{
+		const UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+		EdgeKeys[EdgeIndex] = FMath::Min(Edge->Vert1->Index, Edge->Vert2->Index);
+	});
+	PermuteElements(Mesh->Edges, Mesh->EdgeLayers, BMeshRadixSort::SortIndices<uint32>(EdgeKeys));
+	Mesh->MarkTopologyChanged();
+
+	// Loops of each face are stored together, in the order of faces and of their cycle
+	TArray<int32> FaceOffsets;
+	FaceOffsets.SetNumUninitialized(Mesh->Faces.Num() + 1);
+	FaceOffsets[0] = 0;
+	for (int32 FaceIndex = 0; FaceIndex < Mesh->Faces.Num(); ++FaceIndex)
 	{
-		Face->Id = Face->FirstLoop->Vert->Id;
+		FaceOffsets[FaceIndex + 1] = FaceOffsets[FaceIndex] + Mesh->Faces[FaceIndex]->VertCount;
 	}
-	Mesh->Faces.Sort([](const UBMeshFace& A, const UBMeshFace& B)
+	if (!ensureMsgf(FaceOffsets.Last() == Mesh->Loops.Num(), TEXT("Loops don't match the corners of faces, they are left unsorted")))
+		return;
+	TArray<UBMeshLoop*> Loops;
+	Loops.SetNumUninitialized(Mesh->Loops.Num());
+	TArray<int32> LoopOrder;
+	LoopOrder.SetNumUninitialized(Mesh->Loops.Num());
+	ParallelFor(Mesh->Faces.Num(), [&](int32 FaceIndex)
 	{
-		return A.Id < B.Id;
+		UBMeshLoop* Loop = Mesh->Faces[FaceIndex]->FirstLoop;
+		for (int32 Corner = FaceOffsets[FaceIndex]; Corner < FaceOffsets[FaceIndex + 1]; ++Corner)
+		{
+			Loops[Corner] = Loop;
+			LoopOrder[Corner] = Loop->Index;
+			Loop->Index = Corner;
+			Loop = Loop->Next;
+		}
 	});
+	Mesh->Loops = MoveTemp(Loops);
+	Mesh->LoopLayers.Gather(LoopOrder);
+}
+
+FBMeshConnectedComponents FBMeshOperators::ComputeConnectedComponents(UBMesh* Mesh, EBMeshConnectivity Connectivity)
+{
+	check(Mesh);
+	FBMeshConnectedComponents Result;
+	switch (Connectivity)
+	{
+	case EBMeshConnectivity::Vertex:
+		{
+			FBMeshConcurrentUnionFind UnionFind(Mesh->Vertices.Num());
+			ParallelFor(Mesh->Edges.Num(), [&](int32 EdgeIndex)
+			{
+				const UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+				UnionFind.Unite(Edge->Vert1->Index, Edge->Vert2->Index);
+			});
+			UnionFind.Label(Result.ComponentIds, Result.ComponentSizes);
+			break;
+		}
+	case EBMeshConnectivity::Edge:
+		{
+			FBMeshConcurrentUnionFind UnionFind(Mesh->Edges.Num());
+			ParallelFor(Mesh->Vertices.Num(), [&](int32 VertexIndex)
+			{
+				const UBMeshVertex* Vertex = Mesh->Vertices[VertexIndex];
+				if (Vertex->Edge == nullptr)
+					return;
+				for (UBMeshEdge* Edge : Vertex->EdgesRange())
+				{
+					UnionFind.Unite(Vertex->Edge->Index, Edge->Index);
+				}
+			});
+			UnionFind.Label(Result.ComponentIds, Result.ComponentSizes);
+			break;
+		}
+	case EBMeshConnectivity::Face:
+		{
+			FBMeshConcurrentUnionFind UnionFind(Mesh->Faces.Num());
+			ParallelFor(Mesh->Edges.Num(), [&](int32 EdgeIndex)
+			{
+				const UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+				if (Edge->Loop == nullptr)
+					return;
+				for (UBMeshFace* Face : Edge->NeighborFacesRange())
+				{
+					UnionFind.Unite(Edge->Loop->Face->Index, Face->Index);
+				}
+			});
+			UnionFind.Label(Result.ComponentIds, Result.ComponentSizes);
+			break;
+		}
+	}
+	return Result;
+}
+
+namespace
+{
+	/**
+	 * Cut the cycle of a face where it visits the same vertex twice, moving the corners from the
+	 * second visit on to a new face. No edge is added, the corners keep their edges.
+	 * @retval the new face, or null if the face doesn't repeat a vertex
+	 */
+	UBMeshFace* SplitFaceAtRepeatedVertex(UBMesh* Mesh, UBMeshFace* Face)
+	{
+		UBMeshLoop* Loop = Face->FirstLoop;
+		do
+		{
+			for (UBMeshLoop* Other = Loop->Next; Other != Face->FirstLoop; Other = Other->Next)
+			{
+				if (Other->Vert != Loop->Vert)
+					continue;
+
+				// Loop .. Other->Prev stays in the face, Other .. Loop->Prev goes to the new face
+				UBMeshLoop* BeforeLoop = Loop->Prev;
+				UBMeshLoop* BeforeOther = Other->Prev;
+				BeforeOther->Next = Loop;
+				Loop->Prev = BeforeOther;
+				BeforeLoop->Next = Other;
+				Other->Prev = BeforeLoop;
+
+				UBMeshFace* NewFace = NewObject<UBMeshFace>(Mesh, *Mesh->FaceClass);
+				Mesh->AddToContainer(NewFace);
+				NewFace->Id = Face->Id;
+				FBMeshOperators::FAttributeLayout(*Mesh->FaceClass, UBMeshFace::StaticClass(), &Mesh->FaceLayers).Copy(NewFace, Face);
+
+				NewFace->FirstLoop = Other;
+				NewFace->VertCount = 0;
+				UBMeshLoop* It = Other;
+				do
+				{
+					It->Face = NewFace;
+					++NewFace->VertCount;
+					It = It->Next;
+				}
+				while (It != Other);
+				Face->FirstLoop = Loop;
+				Face->VertCount -= NewFace->VertCount;
+				return NewFace;
+			}
+			Loop = Loop->Next;
+		}
+		while (Loop != Face->FirstLoop);
+		return nullptr;
+	}
 }
 
-//void FBMeshOperators::Merge(UBMesh* mesh, UBMesh* other)
-//{
-//	var newVerts = new Vertex[other.vertices.Count];
-//	int i = 0;
-//	foreach(Vertex v in other.vertices)
-//	{
-//		newVerts[i] = mesh.AddVertex(v.point);
-//		AttributeLerp(mesh, newVerts[i], v, v, 1); // copy all attributes
-//		v.id = i;
-//		++i;
-//	}
-//	foreach(Edge e in other.edges)
-//	{
-//		mesh.AddEdge(newVerts[e.vert1.id], newVerts[e.vert2.id]);
-//	}
-//	foreach(Face f in other.faces)
-//	{
-//		var neighbors = f.NeighborVertices();
-//		var newNeighbors = new Vertex[neighbors.Count];
-//		int j = 0;
-//		foreach(var v in neighbors)
-//		{
-//			newNeighbors[j] = newVerts[v.id];
-//			++j;
-//		}
-//		mesh.AddFace(newNeighbors);
-//	}
-//}
+int32 FBMeshOperators::WeldVertices(UBMesh* Mesh, float Tolerance)
+{
+	check(Mesh);
+	const int32 NumVertices = Mesh->Vertices.Num();
+	if (NumVertices < 2 || Tolerance < 0.0f)
+		return 0;
+
+	// Bucket vertices in a spatial hash, with a linked list of vertices per cell
+	const float CellSize = FMath::Max(Tolerance, KINDA_SMALL_NUMBER);
+	const float ToleranceSquared = Tolerance * Tolerance;
+	auto CellOf = [CellSize](const FVector& Location)
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+	};
+	TMap<FIntVector, int32> CellHeads;
+	CellHeads.Reserve(NumVertices);
+	TArray<int32> NextInCell;
+	NextInCell.SetNumUninitialized(NumVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+	{
+		const FIntVector Cell = CellOf(Mesh->Vertices[VertexIndex]->Location);
+		if (int32* Head = CellHeads.Find(Cell))
+		{
+			NextInCell[VertexIndex] = *Head;
+			*Head = VertexIndex;
+		}
+		else
+		{
+			NextInCell[VertexIndex] = INDEX_NONE;
+			CellHeads.Add(Cell, VertexIndex);
+		}
+	}
+
+	// Cluster vertices closer than the tolerance, looking only at the 27 cells around each vertex
+	FBMeshConcurrentUnionFind UnionFind(NumVertices);
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		const FVector Location = Mesh->Vertices[VertexIndex]->Location;
+		const FIntVector Cell = CellOf(Location);
+		for (int32 Z = -1; Z <= 1; ++Z)
+		for (int32 Y = -1; Y <= 1; ++Y)
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			if (const int32* Head = CellHeads.Find(Cell + FIntVector(X, Y, Z)))
+			{
+				for (int32 Other = *Head; Other != INDEX_NONE; Other = NextInCell[Other])
+				{
+					if (Other > VertexIndex && FVector::DistSquared(Location, Mesh->Vertices[Other]->Location) <= ToleranceSquared)
+					{
+						UnionFind.Unite(VertexIndex, Other);
+					}
+				}
+			}
+		}
+	});
+
+	// The representative of each cluster is its lowest index vertex
+	TArray<int32> Representatives;
+	Representatives.SetNumUninitialized(NumVertices);
+	int32 NumWelded = 0;
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+	{
+		Representatives[VertexIndex] = UnionFind.Find(VertexIndex);
+		if (Representatives[VertexIndex] != VertexIndex)
+		{
+			++NumWelded;
+		}
+	}
+	if (NumWelded == 0)
+		return 0;
+
+	auto RepresentativeOf = [&](const UBMeshVertex* Vertex)
+	{
+		return Mesh->Vertices[Representatives[Vertex->Index]];
+	};
+
+	FBMeshDeferredRemovalScope RemovalScope(Mesh);
+
+	// Rewire edges to the representatives. Edges inside a cluster collapse, and so do
+	// the face corners that use them
+	TArray<UBMeshEdge*> MovedEdges;
+	TSet<UBMeshFace*> ChangedFaces;
+	for (int32 EdgeIndex = 0; EdgeIndex < Mesh->Edges.Num(); ++EdgeIndex)
+	{
+		UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+		UBMeshVertex* Rep1 = RepresentativeOf(Edge->Vert1);
+		UBMeshVertex* Rep2 = RepresentativeOf(Edge->Vert2);
+		if (Rep1 == Rep2)
+		{
+			while (Edge->Loop != nullptr)
+			{
+				UBMeshLoop* Loop = Edge->Loop;
+				ChangedFaces.Add(Loop->Face);
+				Loop->RemoveFromRadial();
+				Loop->RemoveFromFace();
+				Mesh->RemoveFromContainer(Loop);
+			}
+			Edge->RemoveFromDisk(Edge->Vert1);
+			Edge->RemoveFromDisk(Edge->Vert2);
+			Mesh->RemoveFromContainer(Edge);
+		}
+		else if (Rep1 != Edge->Vert1 || Rep2 != Edge->Vert2)
+		{
+			if (Rep1 != Edge->Vert1)
+			{
+				Edge->RemoveFromDisk(Edge->Vert1);
+				Edge->Vert1 = Rep1;
+				Edge->AppendToDisk(Rep1);
+			}
+			if (Rep2 != Edge->Vert2)
+			{
+				Edge->RemoveFromDisk(Edge->Vert2);
+				Edge->Vert2 = Rep2;
+				Edge->AppendToDisk(Rep2);
+			}
+			MovedEdges.Add(Edge);
+		}
+	}
+
+	for (UBMeshLoop* Loop : Mesh->Loops)
+	{
+		if (Loop->Face != nullptr && RepresentativeOf(Loop->Vert) != Loop->Vert)
+		{
+			Loop->Vert = RepresentativeOf(Loop->Vert);
+			ChangedFaces.Add(Loop->Face);
+		}
+	}
+
+	// Merge edges that now join the same two vertices, moving their loops to the edge that is kept
+	TSet<UBMeshEdge*> MergedEdges;
+	for (UBMeshEdge* Edge : MovedEdges)
+	{
+		if (MergedEdges.Contains(Edge))
+			continue;
+		UBMeshEdge* Duplicate = nullptr;
+		for (UBMeshEdge* Other : Edge->Vert1->EdgesRange())
+		{
+			if (Other != Edge && Other->ContainsVertex(Edge->Vert2))
+			{
+				Duplicate = Other;
+				break;
+			}
+		}
+		if (Duplicate == nullptr)
+			continue;
+		while (Edge->Loop != nullptr)
+		{
+			Edge->Loop->MoveToEdge(Duplicate);
+		}
+		Edge->RemoveFromDisk(Edge->Vert1);
+		Edge->RemoveFromDisk(Edge->Vert2);
+		Mesh->RemoveFromContainer(Edge);
+		MergedEdges.Add(Edge);
+	}
+
+	// Faces that visit a vertex twice are split there until no part does. Faces that lost all
+	// their corners, or parts left as two sided polygons, are degenerate
+	TArray<UBMeshFace*> PendingFaces = ChangedFaces.Array();
+	while (PendingFaces.Num() > 0)
+	{
+		UBMeshFace* Face = PendingFaces.Pop();
+		if (Face->FirstLoop == nullptr)
+		{
+			Mesh->RemoveFromContainer(Face);
+		}
+		else if (UBMeshFace* Split = SplitFaceAtRepeatedVertex(Mesh, Face))
+		{
+			PendingFaces.Add(Face);
+			PendingFaces.Add(Split);
+		}
+		else if (Face->VertCount < 3)
+		{
+			Mesh->RemoveFace(Face);
+		}
+	}
+
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+	{
+		if (Representatives[VertexIndex] != VertexIndex)
+		{
+			UBMeshVertex* Vertex = Mesh->Vertices[VertexIndex];
+			check(Vertex->Edge == nullptr);
+			Mesh->RemoveFromContainer(Vertex);
+		}
+	}
+	return NumWelded;
+}
+
+namespace
+{
+	/**
+	 * Element of the destination mesh copied from each element of a merged mesh. Copies are appended
+	 * in the order of the merged mesh's container, so an element's copy is found from its index.
+	 */
+	template <typename T>
+	struct TMergeRemap
+	{
+		const TArray<T*>& Copies;
+		int32 First;
+
+		T* operator()(const T* Element) const
+		{
+			return Element ? Copies[First + Element->Index] : nullptr;
+		}
+	};
+}
+
+void FBMeshOperators::Merge(UBMesh* Mesh, UBMesh* Other)
+{
+	Merge(Mesh, TArrayView<UBMesh* const>(&Other, 1));
+}
+
+void FBMeshOperators::Merge(UBMesh* Mesh, TArrayView<UBMesh* const> Others)
+{
+	int32 NumVertices = Mesh->Vertices.Num();
+	int32 NumEdges = Mesh->Edges.Num();
+	int32 NumLoops = Mesh->Loops.Num();
+	int32 NumFaces = Mesh->Faces.Num();
+	for (const UBMesh* Other : Others)
+	{
+		check(Other && Other != Mesh);
+		NumVertices += Other->Vertices.Num();
+		NumEdges += Other->Edges.Num();
+		NumLoops += Other->Loops.Num();
+		NumFaces += Other->Faces.Num();
+	}
+	Mesh->Vertices.Reserve(NumVertices);
+	Mesh->Edges.Reserve(NumEdges);
+	Mesh->Loops.Reserve(NumLoops);
+	Mesh->Faces.Reserve(NumFaces);
+
+	for (const UBMesh* Other : Others)
+	{
+		const FAttributeMapping VertexAttributes(*Mesh->VertexClass, *Other->VertexClass, UBMeshVertex::StaticClass());
+		const FAttributeMapping EdgeAttributes(*Mesh->EdgeClass, *Other->EdgeClass, UBMeshEdge::StaticClass());
+		const FAttributeMapping LoopAttributes(*Mesh->LoopClass, *Other->LoopClass, UBMeshLoop::StaticClass());
+		const FAttributeMapping FaceAttributes(*Mesh->FaceClass, *Other->FaceClass, UBMeshFace::StaticClass());
+
+		const int32 FirstVertex = Mesh->Vertices.Num();
+		const int32 FirstEdge = Mesh->Edges.Num();
+		const int32 FirstLoop = Mesh->Loops.Num();
+		const int32 FirstFace = Mesh->Faces.Num();
+
+		// Objects have to be created on the game thread, so copies are allocated first and linked afterwards
+		for (const UBMeshVertex* Vertex : Other->Vertices)
+		{
+			UBMeshVertex* Copy = NewObject<UBMeshVertex>(Mesh, *Mesh->VertexClass);
+			Copy->Id = Vertex->Id;
+			Copy->Location = Vertex->Location;
+			VertexAttributes.Copy(Copy, Vertex);
+			Mesh->AddToContainer(Copy);
+		}
+
+		for (const UBMeshEdge* Edge : Other->Edges)
+		{
+			UBMeshEdge* Copy = NewObject<UBMeshEdge>(Mesh, *Mesh->EdgeClass);
+			Copy->Id = Edge->Id;
+			EdgeAttributes.Copy(Copy, Edge);
+			Mesh->AddToContainer(Copy);
+		}
+
+		for (const UBMeshLoop* Loop : Other->Loops)
+		{
+			UBMeshLoop* Copy = NewObject<UBMeshLoop>(Mesh, *Mesh->LoopClass);
+			LoopAttributes.Copy(Copy, Loop);
+			Mesh->AddToContainer(Copy);
+		}
+
+		for (const UBMeshFace* Face : Other->Faces)
+		{
+			UBMeshFace* Copy = NewObject<UBMeshFace>(Mesh, *Mesh->FaceClass);
+			Copy->Id = Face->Id;
+			Copy->VertCount = Face->VertCount;
+			FaceAttributes.Copy(Copy, Face);
+			Mesh->AddToContainer(Copy);
+		}
+
+		// Copies were appended in the same order as the other mesh's elements, so the layers line up
+		Mesh->VertexLayers.Append(Other->VertexLayers, FirstVertex, Other->Vertices.Num());
+		Mesh->EdgeLayers.Append(Other->EdgeLayers, FirstEdge, Other->Edges.Num());
+		Mesh->LoopLayers.Append(Other->LoopLayers, FirstLoop, Other->Loops.Num());
+		Mesh->FaceLayers.Append(Other->FaceLayers, FirstFace, Other->Faces.Num());
+
+		const TMergeRemap<UBMeshVertex> Vertices{Mesh->Vertices, FirstVertex};
+		const TMergeRemap<UBMeshEdge> Edges{Mesh->Edges, FirstEdge};
+		const TMergeRemap<UBMeshLoop> Loops{Mesh->Loops, FirstLoop};
+		const TMergeRemap<UBMeshFace> Faces{Mesh->Faces, FirstFace};
+
+		// Each copy is only written by its own iteration, and the containers are read only from here on
+		ParallelFor(Other->Vertices.Num(), [&](int32 i)
+		{
+			Mesh->Vertices[FirstVertex + i]->Edge = Edges(Other->Vertices[i]->Edge);
+		});
+		ParallelFor(Other->Edges.Num(), [&](int32 i)
+		{
+			const UBMeshEdge* Edge = Other->Edges[i];
+			UBMeshEdge* Copy = Mesh->Edges[FirstEdge + i];
+			Copy->Vert1 = Vertices(Edge->Vert1);
+			Copy->Vert2 = Vertices(Edge->Vert2);
+			Copy->Next1 = Edges(Edge->Next1);
+			Copy->Next2 = Edges(Edge->Next2);
+			Copy->Prev1 = Edges(Edge->Prev1);
+			Copy->Prev2 = Edges(Edge->Prev2);
+			Copy->Loop = Loops(Edge->Loop);
+		});
+		ParallelFor(Other->Loops.Num(), [&](int32 i)
+		{
+			const UBMeshLoop* Loop = Other->Loops[i];
+			UBMeshLoop* Copy = Mesh->Loops[FirstLoop + i];
+			Copy->Vert = Vertices(Loop->Vert);
+			Copy->Edge = Edges(Loop->Edge);
+			Copy->Face = Faces(Loop->Face);
+			Copy->RadialPrev = Loops(Loop->RadialPrev);
+			Copy->RadialNext = Loops(Loop->RadialNext);
+			Copy->Prev = Loops(Loop->Prev);
+			Copy->Next = Loops(Loop->Next);
+		});
+		ParallelFor(Other->Faces.Num(), [&](int32 i)
+		{
+			Mesh->Faces[FirstFace + i]->FirstLoop = Loops(Other->Faces[i]->FirstLoop);
+		});
+	}
+}
+
+bool FBMeshOperators::CanCollapseEdge(const UBMeshEdge* Edge)
+{
+	check(Edge);
+	const UBMeshVertex* Vert1 = Edge->Vert1;
+	const UBMeshVertex* Vert2 = Edge->Vert2;
+
+	int32 NumTriangles = 0;
+	if (const UBMeshLoop* First = Edge->Loop)
+	{
+		const UBMeshLoop* Loop = First;
+		do
+		{
+			NumTriangles += Loop->Face->VertCount == 3 ? 1 : 0;
+			Loop = Loop->RadialNext;
+		}
+		while (Loop != First);
+	}
+
+	int32 NumShared = 0;
+	for (const UBMeshEdge* Edge1 : Vert1->EdgesRange())
+	{
+		if (Edge1 == Edge)
+			continue;
+		const UBMeshVertex* Other = Edge1->OtherVertex(Vert1);
+		for (const UBMeshEdge* Edge2 : Vert2->EdgesRange())
+		{
+			if (Edge2 != Edge && Edge2->ContainsVertex(Other))
+			{
+				++NumShared;
+				break;
+			}
+		}
+	}
+	return NumShared == NumTriangles;
+}
+
+namespace
+{
+	/**
+	 * Collapse the edge into its first vertex, without touching its location or attributes
+	 */
+	void CollapseEdgeTopology(UBMesh* Mesh, UBMeshEdge* Edge)
+	{
+		UBMeshVertex* Kept = Edge->Vert1;
+		UBMeshVertex* Removed = Edge->Vert2;
+		check(Kept != Removed);
+
+		// Faces lose their corner along the edge, triangles are left with two sides
+		TArray<UBMeshFace*, TInlineAllocator<4>> DegenerateFaces;
+		while (Edge->Loop != nullptr)
+		{
+			UBMeshLoop* Loop = Edge->Loop;
+			UBMeshFace* Face = Loop->Face;
+			Loop->RemoveFromRadial();
+			Loop->RemoveFromFace();
+			Mesh->RemoveFromContainer(Loop);
+			if (Face->VertCount < 3)
+			{
+				DegenerateFaces.Add(Face);
+			}
+		}
+		Edge->RemoveFromDisk(Kept);
+		Edge->RemoveFromDisk(Removed);
+		Mesh->RemoveFromContainer(Edge);
+
+		// Move the other edges of the removed vertex, and the corners at it, to the kept vertex
+		TArray<UBMeshEdge*, TInlineAllocator<8>> MovedEdges;
+		while (Removed->Edge != nullptr)
+		{
+			UBMeshEdge* Moved = Removed->Edge;
+			Moved->RemoveFromDisk(Removed);
+			if (Moved->Vert1 == Removed)
+			{
+				Moved->Vert1 = Kept;
+			}
+			else
+			{
+				Moved->Vert2 = Kept;
+			}
+			Moved->AppendToDisk(Kept);
+			if (UBMeshLoop* First = Moved->Loop)
+			{
+				UBMeshLoop* Loop = First;
+				do
+				{
+					if (Loop->Vert == Removed)
+					{
+						Loop->Vert = Kept;
+					}
+					Loop = Loop->RadialNext;
+				}
+				while (Loop != First);
+			}
+			MovedEdges.Add(Moved);
+		}
+
+		// Two sided faces are removed, their sides now join the same two vertices
+		TArray<UBMeshEdge*, TInlineAllocator<8>> SidesOfRemovedFaces;
+		for (UBMeshFace* Face : DegenerateFaces)
+		{
+			while (Face->FirstLoop != nullptr)
+			{
+				UBMeshLoop* Loop = Face->FirstLoop;
+				SidesOfRemovedFaces.Add(Loop->Edge);
+				Loop->RemoveFromRadial();
+				Loop->RemoveFromFace();
+				Mesh->RemoveFromContainer(Loop);
+			}
+			Mesh->RemoveFromContainer(Face);
+		}
+
+		// Merge edges that now join the same two vertices, moving their loops to the edge that is kept
+		for (UBMeshEdge* Moved : MovedEdges)
+		{
+			UBMeshVertex* Other = Moved->OtherVertex(Kept);
+			UBMeshEdge* Duplicate = nullptr;
+			for (UBMeshEdge* Candidate : Kept->EdgesRange())
+			{
+				if (Candidate != Moved && Candidate->ContainsVertex(Other))
+				{
+					Duplicate = Candidate;
+					break;
+				}
+			}
+			if (Duplicate == nullptr)
+				continue;
+			while (Moved->Loop != nullptr)
+			{
+				Moved->Loop->MoveToEdge(Duplicate);
+			}
+			Moved->RemoveFromDisk(Kept);
+			Moved->RemoveFromDisk(Other);
+			Mesh->RemoveFromContainer(Moved);
+		}
+
+		// Sides of removed faces that no other face uses would be left as loose edges
+		TArray<UBMeshEdge*, TInlineAllocator<8>> LooseEdges;
+		for (UBMeshEdge* Candidate : Kept->EdgesRange())
+		{
+			if (Candidate->Loop == nullptr && SidesOfRemovedFaces.Contains(Candidate))
+			{
+				LooseEdges.Add(Candidate);
+			}
+		}
+		for (UBMeshEdge* Loose : LooseEdges)
+		{
+			Loose->RemoveFromDisk(Loose->Vert1);
+			Loose->RemoveFromDisk(Loose->Vert2);
+			Mesh->RemoveFromContainer(Loose);
+		}
+
+		check(Removed->Edge == nullptr);
+		Mesh->RemoveFromContainer(Removed);
+	}
+}
+
+UBMeshVertex* FBMeshOperators::CollapseEdge(UBMesh* Mesh, UBMeshEdge* Edge, float t)
+{
+	check(Mesh && Edge);
+	UBMeshVertex* Kept = Edge->Vert1;
+	UBMeshVertex* Removed = Edge->Vert2;
+	AttributeLerp(Mesh, Kept, Kept, Removed, t);
+	Kept->Location = FMath::Lerp(Kept->Location, Removed->Location, t);
+	CollapseEdgeTopology(Mesh, Edge);
+	return Kept;
+}
+
+namespace
+{
+	/**
+	 * Collect the loops around an edge, so the radial cycle can be edited while going through them
+	 */
+	TArray<UBMeshLoop*, TInlineAllocator<4>> GetRadialLoops(const UBMeshEdge* Edge)
+	{
+		TArray<UBMeshLoop*, TInlineAllocator<4>> RadialLoops;
+		if (UBMeshLoop* First = Edge->Loop)
+		{
+			UBMeshLoop* Loop = First;
+			do
+			{
+				RadialLoops.Add(Loop);
+				Loop = Loop->RadialNext;
+			}
+			while (Loop != First);
+		}
+		return RadialLoops;
+	}
+
+	void LinkTriangle(UBMeshFace* Face, UBMeshLoop* Loop0, UBMeshLoop* Loop1, UBMeshLoop* Loop2)
+	{
+		Loop0->Next = Loop1;
+		Loop1->Next = Loop2;
+		Loop2->Next = Loop0;
+		Loop0->Prev = Loop2;
+		Loop1->Prev = Loop0;
+		Loop2->Prev = Loop1;
+		Loop0->Face = Loop1->Face = Loop2->Face = Face;
+		Face->FirstLoop = Loop0;
+	}
+
+	void RemoveLoop(UBMesh* Mesh, UBMeshLoop* Loop)
+	{
+		Loop->RemoveFromRadial();
+		Loop->RemoveFromFace();
+		Mesh->RemoveFromContainer(Loop);
+	}
+
+	void RemoveEdge(UBMesh* Mesh, UBMeshEdge* Edge)
+	{
+		check(Edge->Loop == nullptr);
+		Edge->RemoveFromDisk(Edge->Vert1);
+		Edge->RemoveFromDisk(Edge->Vert2);
+		Mesh->RemoveFromContainer(Edge);
+	}
+}
+
+UBMeshVertex* FBMeshOperators::SplitEdge(UBMesh* Mesh, UBMeshEdge* Edge, float t)
+{
+	check(Mesh && Edge);
+	UBMeshVertex* Vert1 = Edge->Vert1;
+	UBMeshVertex* Vert2 = Edge->Vert2;
+	const TArray<UBMeshLoop*, TInlineAllocator<4>> RadialLoops = GetRadialLoops(Edge);
+
+	UBMeshVertex* NewVertex = Mesh->AddVertex(FMath::Lerp(Vert1->Location, Vert2->Location, t));
+	const FAttributeLayout VertexAttributes(*Mesh->VertexClass, UBMeshVertex::StaticClass(), &Mesh->VertexLayers);
+	VertexAttributes.Copy(NewVertex, Vert1);
+	VertexAttributes.Lerp(NewVertex, Vert1, Vert2, t);
+
+	// The edge keeps its first half, the second half is a new edge
+	Edge->RemoveFromDisk(Vert2);
+	Edge->Vert2 = NewVertex;
+	Edge->AppendToDisk(NewVertex);
+	UBMeshEdge* NewEdge = Mesh->AddEdge(NewVertex, Vert2);
+	NewEdge->Id = Edge->Id;
+	FAttributeLayout(*Mesh->EdgeClass, UBMeshEdge::StaticClass(), &Mesh->EdgeLayers).Copy(NewEdge, Edge);
+
+	const FAttributeLayout LoopAttributes(*Mesh->LoopClass, UBMeshLoop::StaticClass(), &Mesh->LoopLayers);
+	for (UBMeshLoop* Loop : RadialLoops)
+	{
+		UBMeshLoop* NextLoop = Loop->Next;
+		UBMeshLoop* NewLoop;
+		float LoopT;
+		if (Loop->Vert == Vert1)
+		{
+			// Vert1 -> Vert2 becomes Vert1 -> NewVertex -> Vert2
+			NewLoop = UBMeshLoop::MakeLoopAfter(Mesh->LoopClass, NewVertex, NewEdge, Loop);
+			LoopT = t;
+		}
+		else
+		{
+			// Vert2 -> Vert1 becomes Vert2 -> NewVertex -> Vert1
+			Loop->MoveToEdge(NewEdge);
+			NewLoop = UBMeshLoop::MakeLoopAfter(Mesh->LoopClass, NewVertex, Edge, Loop);
+			LoopT = 1 - t;
+		}
+		Mesh->AddToContainer(NewLoop);
+		LoopAttributes.Copy(NewLoop, Loop);
+		LoopAttributes.Lerp(NewLoop, Loop, NextLoop, LoopT);
+	}
+	return NewVertex;
+}
+
+UBMeshFace* FBMeshOperators::SplitFace(UBMesh* Mesh, UBMeshLoop* LoopA, UBMeshLoop* LoopB)
+{
+	check(Mesh && LoopA && LoopB);
+	UBMeshFace* Face = LoopA->Face;
+	check(LoopB->Face == Face);
+	check(LoopA->Next != LoopB && LoopB->Next != LoopA && LoopA != LoopB);
+	check(LoopA->Vert != LoopB->Vert);
+
+	UBMeshEdge* Edge = Mesh->AddEdge(LoopA->Vert, LoopB->Vert);
+
+	// New corners closing each half: at B after the one before B, and at A after the one before A
+	const FAttributeLayout LoopAttributes(*Mesh->LoopClass, UBMeshLoop::StaticClass(), &Mesh->LoopLayers);
+	UBMeshLoop* CornerB = UBMeshLoop::MakeLoopAfter(Mesh->LoopClass, LoopB->Vert, Edge, LoopB->Prev);
+	UBMeshLoop* CornerA = UBMeshLoop::MakeLoopAfter(Mesh->LoopClass, LoopA->Vert, Edge, LoopA->Prev);
+	Mesh->AddToContainer(CornerB);
+	Mesh->AddToContainer(CornerA);
+	LoopAttributes.Copy(CornerB, LoopB);
+	LoopAttributes.Copy(CornerA, LoopA);
+
+	// Cut the cycle of the face in two
+	CornerB->Next = LoopA;
+	LoopA->Prev = CornerB;
+	CornerA->Next = LoopB;
+	LoopB->Prev = CornerA;
+
+	UBMeshFace* NewFace = NewObject<UBMeshFace>(Mesh, *Mesh->FaceClass);
+	Mesh->AddToContainer(NewFace);
+	NewFace->Id = Face->Id;
+	FAttributeLayout(*Mesh->FaceClass, UBMeshFace::StaticClass(), &Mesh->FaceLayers).Copy(NewFace, Face);
+
+	NewFace->FirstLoop = LoopB;
+	NewFace->VertCount = 0;
+	UBMeshLoop* Loop = LoopB;
+	do
+	{
+		Loop->Face = NewFace;
+		++NewFace->VertCount;
+		Loop = Loop->Next;
+	}
+	while (Loop != LoopB);
+	Face->FirstLoop = LoopA;
+	Face->VertCount -= NewFace->VertCount;
+	return NewFace;
+}
+
+bool FBMeshOperators::FlipEdge(UBMesh* Mesh, UBMeshEdge* Edge)
+{
+	check(Mesh && Edge);
+	UBMeshLoop* Loop1 = Edge->Loop;
+	if (Loop1 == nullptr || Loop1->RadialNext == Loop1 || Loop1->RadialNext->RadialNext != Loop1)
+		return false;
+	UBMeshLoop* Loop2 = Loop1->RadialNext;
+	UBMeshFace* Face1 = Loop1->Face;
+	UBMeshFace* Face2 = Loop2->Face;
+	if (Face1 == Face2 || Face1->VertCount != 3 || Face2->VertCount != 3 || Loop1->Vert == Loop2->Vert)
+		return false;
+
+	// Face1 is A -> B -> C and Face2 is B -> A -> D
+	UBMeshLoop* Loop1Next = Loop1->Next;
+	UBMeshLoop* Loop1Prev = Loop1->Prev;
+	UBMeshLoop* Loop2Next = Loop2->Next;
+	UBMeshLoop* Loop2Prev = Loop2->Prev;
+	UBMeshVertex* A = Loop1->Vert;
+	UBMeshVertex* B = Loop2->Vert;
+	UBMeshVertex* C = Loop1Prev->Vert;
+	UBMeshVertex* D = Loop2Prev->Vert;
+	if (C == D || Mesh->FindEdge(C, D) != nullptr)
+		return false;
+
+	// The loops of the edge become the corners at D in Face1 and at C in Face2
+	const FAttributeLayout LoopAttributes(*Mesh->LoopClass, UBMeshLoop::StaticClass(), &Mesh->LoopLayers);
+	LoopAttributes.Copy(Loop1, Loop2Prev);
+	LoopAttributes.Copy(Loop2, Loop1Prev);
+	Loop1->Vert = D;
+	Loop2->Vert = C;
+
+	Edge->RemoveFromDisk(A);
+	Edge->RemoveFromDisk(B);
+	Edge->Vert1 = C;
+	Edge->Vert2 = D;
+	Edge->AppendToDisk(C);
+	Edge->AppendToDisk(D);
+
+	// Face1 becomes A -> D -> C and Face2 becomes D -> B -> C
+	LinkTriangle(Face1, Loop1, Loop1Prev, Loop2Next);
+	LinkTriangle(Face2, Loop2, Loop2Prev, Loop1Next);
+	Mesh->MarkTopologyChanged();
+	return true;
+}
+
+UBMeshFace* FBMeshOperators::DissolveEdge(UBMesh* Mesh, UBMeshEdge* Edge)
+{
+	check(Mesh && Edge);
+	UBMeshLoop* Loop1 = Edge->Loop;
+	if (Loop1 == nullptr || Loop1->RadialNext == Loop1 || Loop1->RadialNext->RadialNext != Loop1)
+		return nullptr;
+	UBMeshLoop* Loop2 = Loop1->RadialNext;
+	UBMeshFace* Kept = Loop1->Face;
+	UBMeshFace* Removed = Loop2->Face;
+	if (Kept == Removed || Loop1->Vert == Loop2->Vert)
+		return nullptr;
+
+	// Splice the cycle of the removed face in place of the edge
+	for (UBMeshLoop* Loop = Loop2->Next; Loop != Loop2; Loop = Loop->Next)
+	{
+		Loop->Face = Kept;
+	}
+	Loop1->Prev->Next = Loop2->Next;
+	Loop2->Next->Prev = Loop1->Prev;
+	Loop2->Prev->Next = Loop1->Next;
+	Loop1->Next->Prev = Loop2->Prev;
+	Kept->VertCount += Removed->VertCount - 2;
+	Kept->FirstLoop = Loop1->Next;
+
+	for (UBMeshLoop* Loop : { Loop1, Loop2 })
+	{
+		Loop->RemoveFromRadial();
+		Loop->Next = Loop->Prev = nullptr;
+		Loop->Face = nullptr;
+		Mesh->RemoveFromContainer(Loop);
+	}
+	Removed->FirstLoop = nullptr;
+	Removed->VertCount = 0;
+	Mesh->RemoveFromContainer(Removed);
+	RemoveEdge(Mesh, Edge);
+	return Kept;
+}
+
+bool FBMeshOperators::DissolveVertex(UBMesh* Mesh, UBMeshVertex* Vertex)
+{
+	check(Mesh && Vertex);
+	if (Vertex->Edge == nullptr)
+	{
+		Mesh->RemoveFromContainer(Vertex);
+		return true;
+	}
+
+	// The faces around the vertex must form a single fan
+	int32 NumBoundaryEdges = 0;
+	for (const UBMeshEdge* Edge : Vertex->EdgesRange())
+	{
+		const UBMeshLoop* Loop = Edge->Loop;
+		if (Loop == nullptr || Loop->RadialNext->RadialNext != Loop)
+			return false;
+		NumBoundaryEdges += Loop->RadialNext == Loop ? 1 : 0;
+	}
+	if (NumBoundaryEdges != 0 && NumBoundaryEdges != 2)
+		return false;
+
+	// Merge the faces of the fan one edge at a time
+	for (;;)
+	{
+		UBMeshEdge* Shared = nullptr;
+		for (UBMeshEdge* Edge : Vertex->EdgesRange())
+		{
+			const UBMeshLoop* Loop = Edge->Loop;
+			if (Loop->RadialNext != Loop && Loop->RadialNext->Face != Loop->Face)
+			{
+				Shared = Edge;
+				break;
+			}
+		}
+		if (Shared == nullptr || DissolveEdge(Mesh, Shared) == nullptr)
+			break;
+	}
+
+	UBMeshEdge* Edge1 = Vertex->Edge;
+	UBMeshEdge* Edge2 = Edge1->Next(Vertex);
+	if (Edge2 == Edge1)
+	{
+		// The merged face goes to the vertex and back along a single edge
+		UBMeshLoop* Loop1 = Edge1->Loop;
+		UBMeshLoop* Loop2 = Loop1->RadialNext;
+		if (Loop2 == Loop1 || Loop2->Face != Loop1->Face)
+			return false;
+		RemoveLoop(Mesh, Loop1);
+		RemoveLoop(Mesh, Loop2);
+		RemoveEdge(Mesh, Edge1);
+		Mesh->RemoveFromContainer(Vertex);
+		return true;
+	}
+	if (Edge2->Next(Vertex) != Edge1)
+		return false;
+
+	// Join the two edges left into the first one
+	UBMeshVertex* Other2 = Edge2->OtherVertex(Vertex);
+	if (Edge1->ContainsVertex(Other2) || Mesh->FindEdge(Edge1->OtherVertex(Vertex), Other2) != nullptr)
+		return false;
+
+	const TArray<UBMeshLoop*, TInlineAllocator<4>> RadialLoops = GetRadialLoops(Edge2);
+	Edge1->RemoveFromDisk(Vertex);
+	if (Edge1->Vert1 == Vertex)
+	{
+		Edge1->Vert1 = Other2;
+	}
+	else
+	{
+		Edge1->Vert2 = Other2;
+	}
+	Edge1->AppendToDisk(Other2);
+	for (UBMeshLoop* Loop : RadialLoops)
+	{
+		if (Loop->Vert == Vertex)
+		{
+			// The corner before it now goes straight to Other2 along the joined edge
+			RemoveLoop(Mesh, Loop);
+		}
+		else
+		{
+			// The corner after it, at the vertex, is removed and this one follows the joined edge
+			UBMeshLoop* AtVertex = Loop->Next;
+			check(AtVertex->Vert == Vertex && AtVertex->Edge == Edge1);
+			RemoveLoop(Mesh, AtVertex);
+			Loop->MoveToEdge(Edge1);
+		}
+	}
+	RemoveEdge(Mesh, Edge2);
+	check(Vertex->Edge == nullptr);
+	Mesh->RemoveFromContainer(Vertex);
+	return true;
+}
+
+namespace
+{
+	/**
+	 * Symmetric 4x4 matrix Q such that [P, 1] Q [P, 1]^T is a weighted sum of squared distances of P
+	 * to a set of planes
+	 */
+	struct FErrorQuadric
+	{
+		double XX = 0, XY = 0, XZ = 0, XW = 0;
+		double YY = 0, YZ = 0, YW = 0;
+		double ZZ = 0, ZW = 0;
+		double WW = 0;
+
+		FErrorQuadric() = default;
+
+		// Plane Normal.P + D = 0, Normal must be normalized
+		FErrorQuadric(const FVector& Normal, double D, double Weight)
+		{
+			const double X = Normal.X, Y = Normal.Y, Z = Normal.Z;
+			XX = X * X * Weight; XY = X * Y * Weight; XZ = X * Z * Weight; XW = X * D * Weight;
+			YY = Y * Y * Weight; YZ = Y * Z * Weight; YW = Y * D * Weight;
+			ZZ = Z * Z * Weight; ZW = Z * D * Weight;
+			WW = D * D * Weight;
+		}
+
+		FErrorQuadric& operator+=(const FErrorQuadric& Other)
+		{
+			XX += Other.XX; XY += Other.XY; XZ += Other.XZ; XW += Other.XW;
+			YY += Other.YY; YZ += Other.YZ; YW += Other.YW;
+			ZZ += Other.ZZ; ZW += Other.ZW;
+			WW += Other.WW;
+			return *this;
+		}
+
+		FErrorQuadric operator+(const FErrorQuadric& Other) const
+		{
+			FErrorQuadric Result = *this;
+			return Result += Other;
+		}
+
+		double Evaluate(const FVector& P) const
+		{
+			const double X = P.X, Y = P.Y, Z = P.Z;
+			const double Error = XX * X * X + 2 * XY * X * Y + 2 * XZ * X * Z + 2 * XW * X
+				+ YY * Y * Y + 2 * YZ * Y * Z + 2 * YW * Y
+				+ ZZ * Z * Z + 2 * ZW * Z
+				+ WW;
+			return FMath::Max(Error, 0.0);
+		}
+
+		/**
+		 * Find the point where the error is minimal, if it's unique
+		 */
+		bool Minimize(FVector& OutPoint) const
+		{
+			// Solve A P = -B by Cramer's rule, with A the upper 3x3 block and B the last column
+			const double C00 = YY * ZZ - YZ * YZ;
+			const double C01 = XZ * YZ - XY * ZZ;
+			const double C02 = XY * YZ - XZ * YY;
+			const double Det = XX * C00 + XY * C01 + XZ * C02;
+			const double Scale = FMath::Abs(XX * YY * ZZ) + 1e-30;
+			if (FMath::Abs(Det) <= 1e-6 * Scale)
+				return false;
+			const double C11 = XX * ZZ - XZ * XZ;
+			const double C12 = XY * XZ - XX * YZ;
+			const double C22 = XX * YY - XY * XY;
+			const double InvDet = -1.0 / Det;
+			OutPoint.X = (C00 * XW + C01 * YW + C02 * ZW) * InvDet;
+			OutPoint.Y = (C01 * XW + C11 * YW + C12 * ZW) * InvDet;
+			OutPoint.Z = (C02 * XW + C12 * YW + C22 * ZW) * InvDet;
+			return true;
+		}
+	};
+
+	/**
+	 * Best point to collapse an edge to, and the quadric error at that point
+	 */
+	double ComputeCollapseTarget(const FErrorQuadric& Quadric, const FVector& P1, const FVector& P2, FVector& OutTarget)
+	{
+		if (Quadric.Minimize(OutTarget))
+			return Quadric.Evaluate(OutTarget);
+
+		// No unique minimum (e.g. flat regions), pick the best of the ends and the middle
+		const FVector Candidates[3] = { P1, P2, (P1 + P2) * 0.5f };
+		double BestError = TNumericLimits<double>::Max();
+		for (const FVector& Candidate : Candidates)
+		{
+			const double Error = Quadric.Evaluate(Candidate);
+			if (Error < BestError)
+			{
+				BestError = Error;
+				OutTarget = Candidate;
+			}
+		}
+		return BestError;
+	}
+
+	/**
+	 * Area weighted normal of a face (twice its area long), with vertices A and B moved to Target
+	 */
+	FVector FaceNormalWithMovedVertices(const UBMeshFace* Face, const UBMeshVertex* A, const UBMeshVertex* B, const FVector& Target)
+	{
+		auto LocationOf = [&](const UBMeshVertex* Vertex) { return Vertex == A || Vertex == B ? Target : Vertex->Location; };
+		FVector Normal = FVector::ZeroVector;
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			Normal += LocationOf(Loop->Vert) ^ LocationOf(Loop->Next->Vert);
+		}
+		return Normal;
+	}
+
+	/**
+	 * Whether moving both vertices of the edge to Target turns any face around them upside down
+	 */
+	bool CollapseFlipsFaces(const UBMeshEdge* Edge, const FVector& Target)
+	{
+		for (const UBMeshVertex* Vertex : { Edge->Vert1, Edge->Vert2 })
+		{
+			for (const UBMeshEdge* Side : Vertex->EdgesRange())
+			{
+				const UBMeshLoop* First = Side->Loop;
+				if (First == nullptr)
+					continue;
+				const UBMeshLoop* Loop = First;
+				do
+				{
+					// Each face around the vertex is visited once, from its corner at the vertex
+					if (Loop->Vert == Vertex && Loop->Edge != Edge && Loop->Prev->Edge != Edge)
+					{
+						const FVector Before = FaceNormalWithMovedVertices(Loop->Face, nullptr, nullptr, FVector::ZeroVector);
+						const FVector After = FaceNormalWithMovedVertices(Loop->Face, Edge->Vert1, Edge->Vert2, Target);
+						if ((Before | After) <= 0)
+							return true;
+					}
+					Loop = Loop->RadialNext;
+				}
+				while (Loop != First);
+			}
+		}
+		return false;
+	}
+}
+
+int32 FBMeshOperators::Decimate(UBMesh* Mesh, const FDecimateParams& Params)
+{
+	check(Mesh);
+	if (Params.TargetFaceCount < 0 && Params.MaxError < 0)
+	{
+		UE_LOG(LogBMesh, Warning, TEXT("Decimate: neither a target face count nor a max error were given"));
+		return 0;
+	}
+	const int32 NumEdges = Mesh->Edges.Num();
+
+	// Quadric of each vertex, from the planes of its faces weighted by their area
+	TArray<FErrorQuadric> FaceQuadrics;
+	FaceQuadrics.SetNum(Mesh->Faces.Num());
+	ParallelFor(Mesh->Faces.Num(), [&](int32 FaceIndex)
+	{
+		const UBMeshFace* Face = Mesh->Faces[FaceIndex];
+		FVector Normal = FaceNormalWithMovedVertices(Face, nullptr, nullptr, FVector::ZeroVector);
+		const double Area = Normal.Size() * 0.5;
+		if (Normal.Normalize())
+		{
+			FaceQuadrics[FaceIndex] = FErrorQuadric(Normal, -(Normal | Face->FirstLoop->Vert->Location), Area);
+		}
+	});
+	TArray<FErrorQuadric> Quadrics;
+	Quadrics.SetNum(Mesh->Vertices.Num());
+	for (int32 FaceIndex = 0; FaceIndex < Mesh->Faces.Num(); ++FaceIndex)
+	{
+		for (const UBMeshVertex* Vertex : Mesh->Faces[FaceIndex]->Vertices())
+		{
+			Quadrics[Vertex->Index] += FaceQuadrics[FaceIndex];
+		}
+	}
+
+	// Boundary edges get a plane orthogonal to their face, so the boundary can't move inwards
+	if (Params.BoundaryWeight > 0)
+	{
+		for (const UBMeshEdge* Edge : Mesh->Edges)
+		{
+			if (Edge->Loop == nullptr || Edge->Loop->RadialNext != Edge->Loop)
+				continue;
+			const FVector Direction = Edge->Vert2->Location - Edge->Vert1->Location;
+			const FVector FaceNormal = FaceNormalWithMovedVertices(Edge->Loop->Face, nullptr, nullptr, FVector::ZeroVector);
+			FVector Normal = Direction ^ FaceNormal;
+			if (Normal.Normalize())
+			{
+				const FErrorQuadric Constraint(Normal, -(Normal | Edge->Vert1->Location), Params.BoundaryWeight * Direction.SizeSquared());
+				Quadrics[Edge->Vert1->Index] += Constraint;
+				Quadrics[Edge->Vert2->Index] += Constraint;
+			}
+		}
+	}
+
+	TArray<FVector> Targets;
+	Targets.SetNumUninitialized(NumEdges);
+	TArray<float> InitialCosts;
+	InitialCosts.SetNumUninitialized(NumEdges);
+	ParallelFor(NumEdges, [&](int32 EdgeIndex)
+	{
+		const UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+		const FErrorQuadric Quadric = Quadrics[Edge->Vert1->Index] + Quadrics[Edge->Vert2->Index];
+		InitialCosts[EdgeIndex] = ComputeCollapseTarget(Quadric, Edge->Vert1->Location, Edge->Vert2->Location, Targets[EdgeIndex]);
+	});
+	FBMeshIndexedPriorityQueue Queue(NumEdges);
+	for (int32 EdgeIndex = 0; EdgeIndex < NumEdges; ++EdgeIndex)
+	{
+		Queue.Update(EdgeIndex, InitialCosts[EdgeIndex]);
+	}
+
+	const FAttributeLayout VertexAttributes(*Mesh->VertexClass, UBMeshVertex::StaticClass(), &Mesh->VertexLayers);
+	FBMeshDeferredRemovalScope RemovalScope(Mesh);
+	int32 NumFaces = Mesh->Faces.Num();
+	int32 NumCollapsed = 0;
+	TArray<UBMeshEdge*, TInlineAllocator<32>> Neighborhood;
+	while (!Queue.IsEmpty())
+	{
+		if (Params.TargetFaceCount >= 0 && NumFaces <= Params.TargetFaceCount)
+			break;
+		if (Params.MaxError >= 0 && Queue.GetCost(Queue.Top()) > Params.MaxError)
+			break;
+
+		// Edges that can't be collapsed now get back in the queue if their neighborhood changes
+		const int32 EdgeIndex = Queue.Pop();
+		UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+		const FVector Target = Targets[EdgeIndex];
+		if (!CanCollapseEdge(Edge) || CollapseFlipsFaces(Edge, Target))
+			continue;
+
+		UBMeshVertex* Kept = Edge->Vert1;
+		UBMeshVertex* Removed = Edge->Vert2;
+		if (Edge->Loop != nullptr)
+		{
+			for (const UBMeshFace* Face : Edge->NeighborFacesRange())
+			{
+				NumFaces -= Face->VertCount == 3 ? 1 : 0;
+			}
+		}
+		Neighborhood.Reset();
+		for (UBMeshEdge* Side : Kept->EdgesRange())
+		{
+			Neighborhood.Add(Side);
+		}
+		for (UBMeshEdge* Side : Removed->EdgesRange())
+		{
+			Neighborhood.Add(Side);
+		}
+
+		const FVector Direction = Removed->Location - Kept->Location;
+		const float t = Direction.IsNearlyZero() ? 0.5f : FMath::Clamp(float(((Target - Kept->Location) | Direction) / Direction.SizeSquared()), 0.0f, 1.0f);
+		VertexAttributes.Lerp(Kept, Kept, Removed, t);
+		Kept->Location = Target;
+		Quadrics[Kept->Index] += Quadrics[Removed->Index];
+		CollapseEdgeTopology(Mesh, Edge);
+		++NumCollapsed;
+
+		// The neighborhood edges are either removed or now around the kept vertex, whose quadric changed
+		for (const UBMeshEdge* Side : Neighborhood)
+		{
+			Queue.Remove(Side->Index);
+		}
+		for (const UBMeshEdge* Side : Kept->EdgesRange())
+		{
+			const FErrorQuadric Quadric = Quadrics[Side->Vert1->Index] + Quadrics[Side->Vert2->Index];
+			Queue.Update(Side->Index, ComputeCollapseTarget(Quadric, Side->Vert1->Location, Side->Vert2->Location, Targets[Side->Index]));
+		}
+	}
+	return NumCollapsed;
+}
+
+namespace
+{
+	/**
+	 * Whether the vertex is on a boundary or a non-manifold edge, or has no edge at all
+	 */
+	bool IsRemeshFixedVertex(const UBMeshVertex* Vertex)
+	{
+		if (Vertex->Edge == nullptr)
+			return true;
+		for (const UBMeshEdge* Edge : Vertex->EdgesRange())
+		{
+			const UBMeshLoop* Loop = Edge->Loop;
+			if (Loop == nullptr || Loop->RadialNext == Loop || Loop->RadialNext->RadialNext != Loop)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Split an edge at its middle and connect the new vertex to the opposite corner of each triangle
+	 */
+	void SplitTriangleEdge(UBMesh* Mesh, UBMeshEdge* Edge)
+	{
+		UBMeshVertex* Middle = FBMeshOperators::SplitEdge(Mesh, Edge, 0.5f);
+		TArray<UBMeshLoop*, TInlineAllocator<4>> Corners;
+		for (const UBMeshEdge* Side : Middle->EdgesRange())
+		{
+			const UBMeshLoop* First = Side->Loop;
+			if (First == nullptr)
+				continue;
+			UBMeshLoop* Loop = Side->Loop;
+			do
+			{
+				if (Loop->Vert == Middle && Loop->Face->VertCount == 4)
+				{
+					Corners.Add(Loop);
+				}
+				Loop = Loop->RadialNext;
+			}
+			while (Loop != First);
+		}
+		for (UBMeshLoop* Corner : Corners)
+		{
+			FBMeshOperators::SplitFace(Mesh, Corner, Corner->Next->Next);
+		}
+	}
+
+	/**
+	 * Whether flipping an edge shared by two triangles keeps both of them facing the same side
+	 */
+	bool FlipKeepsOrientation(const UBMeshEdge* Edge)
+	{
+		const UBMeshLoop* Loop1 = Edge->Loop;
+		const UBMeshLoop* Loop2 = Loop1->RadialNext;
+		const FVector A = Loop1->Vert->Location;
+		const FVector B = Loop2->Vert->Location;
+		const FVector C = Loop1->Prev->Vert->Location;
+		const FVector D = Loop2->Prev->Vert->Location;
+		const FVector Normal = ((B - A) ^ (C - A)) + ((A - B) ^ (D - B));
+		return (((D - A) ^ (C - A)) | Normal) > 0 && (((B - D) ^ (C - D)) | Normal) > 0;
+	}
+}
+
+void FBMeshOperators::Remesh(UBMesh* Mesh, const FRemeshParams& Params)
+{
+	check(Mesh);
+	Triangulate(Mesh);
+
+	float TargetLength = Params.TargetEdgeLength;
+	if (TargetLength <= 0)
+	{
+		TArray<double> Lengths;
+		Lengths.SetNumUninitialized(Mesh->Edges.Num());
+		ParallelFor(Mesh->Edges.Num(), [&](int32 EdgeIndex)
+		{
+			const UBMeshEdge* Edge = Mesh->Edges[EdgeIndex];
+			Lengths[EdgeIndex] = FVector::Dist(Edge->Vert1->Location, Edge->Vert2->Location);
+		});
+		double Sum = 0;
+		for (const double Length : Lengths)
+		{
+			Sum += Length;
+		}
+		TargetLength = Lengths.Num() > 0 ? float(Sum / Lengths.Num()) : 0.0f;
+	}
+	if (TargetLength <= 0)
+		return;
+	const float MaxLength = TargetLength * 4.0f / 3.0f;
+	const float MinLength = TargetLength * 4.0f / 5.0f;
+
+	TArray<UBMeshEdge*> SelectedEdges;
+	TArray<bool> IsSelected;
+	auto SelectEdges = [&](TFunctionRef<bool(const UBMeshEdge*)> Predicate)
+	{
+		IsSelected.SetNumUninitialized(Mesh->Edges.Num());
+		ParallelFor(Mesh->Edges.Num(), [&](int32 EdgeIndex)
+		{
+			IsSelected[EdgeIndex] = Predicate(Mesh->Edges[EdgeIndex]);
+		});
+		SelectedEdges.Reset();
+		for (int32 EdgeIndex = 0; EdgeIndex < IsSelected.Num(); ++EdgeIndex)
+		{
+			if (IsSelected[EdgeIndex])
+			{
+				SelectedEdges.Add(Mesh->Edges[EdgeIndex]);
+			}
+		}
+	};
+
+	for (int32 Iteration = 0; Iteration < Params.Iterations; ++Iteration)
+	{
+		// Split long edges, until none is left since halves and new diagonals can still be too long
+		for (;;)
+		{
+			SelectEdges([&](const UBMeshEdge* Edge)
+			{
+				return FVector::DistSquared(Edge->Vert1->Location, Edge->Vert2->Location) > FMath::Square(MaxLength);
+			});
+			if (SelectedEdges.Num() == 0)
+				break;
+			for (UBMeshEdge* Edge : SelectedEdges)
+			{
+				SplitTriangleEdge(Mesh, Edge);
+			}
+		}
+
+		// Collapse short edges into their middle, shortest first, unless that makes long edges
+		{
+			TArray<bool> IsFixed;
+			IsFixed.SetNumUninitialized(Mesh->Vertices.Num());
+			ParallelFor(Mesh->Vertices.Num(), [&](int32 VertexIndex)
+			{
+				IsFixed[VertexIndex] = IsRemeshFixedVertex(Mesh->Vertices[VertexIndex]);
+			});
+			auto IsCollapsible = [&](const UBMeshEdge* Edge)
+			{
+				return !IsFixed[Edge->Vert1->Index] && !IsFixed[Edge->Vert2->Index]
+					&& FVector::DistSquared(Edge->Vert1->Location, Edge->Vert2->Location) < FMath::Square(MinLength);
+			};
+			SelectEdges(IsCollapsible);
+			FBMeshIndexedPriorityQueue Queue(Mesh->Edges.Num());
+			for (const UBMeshEdge* Edge : SelectedEdges)
+			{
+				Queue.Update(Edge->Index, float(FVector::Dist(Edge->Vert1->Location, Edge->Vert2->Location)));
+			}
+
+			FBMeshDeferredRemovalScope RemovalScope(Mesh);
+			TArray<UBMeshEdge*, TInlineAllocator<32>> Neighborhood;
+			while (!Queue.IsEmpty())
+			{
+				UBMeshEdge* Edge = Mesh->Edges[Queue.Pop()];
+				UBMeshVertex* Kept = Edge->Vert1;
+				UBMeshVertex* Removed = Edge->Vert2;
+				const FVector Target = (Kept->Location + Removed->Location) * 0.5f;
+				if (!CanCollapseEdge(Edge) || CollapseFlipsFaces(Edge, Target))
+					continue;
+				Neighborhood.Reset();
+				bool bMakesLongEdges = false;
+				for (const UBMeshVertex* Vertex : { Kept, Removed })
+				{
+					for (UBMeshEdge* Side : Vertex->EdgesRange())
+					{
+						Neighborhood.Add(Side);
+						bMakesLongEdges |= Side != Edge && FVector::DistSquared(Side->OtherVertex(Vertex)->Location, Target) > FMath::Square(MaxLength);
+					}
+				}
+				if (bMakesLongEdges)
+					continue;
+
+				CollapseEdge(Mesh, Edge, 0.5f);
+				for (const UBMeshEdge* Side : Neighborhood)
+				{
+					Queue.Remove(Side->Index);
+				}
+				for (const UBMeshEdge* Side : Kept->EdgesRange())
+				{
+					if (IsCollapsible(Side))
+					{
+						Queue.Update(Side->Index, float(FVector::Dist(Side->Vert1->Location, Side->Vert2->Location)));
+					}
+				}
+			}
+		}
+
+		// Flip edges that bring the valences of their four vertices closer to 6, or 4 on boundaries
+		{
+			const int32 NumVertices = Mesh->Vertices.Num();
+			TArray<int32> Valences;
+			Valences.SetNumUninitialized(NumVertices);
+			TArray<int32> TargetValences;
+			TargetValences.SetNumUninitialized(NumVertices);
+			ParallelFor(NumVertices, [&](int32 VertexIndex)
+			{
+				const UBMeshVertex* Vertex = Mesh->Vertices[VertexIndex];
+				int32 Valence = 0;
+				if (Vertex->Edge != nullptr)
+				{
+					for (const UBMeshEdge* Edge : Vertex->EdgesRange())
+					{
+						++Valence;
+					}
+				}
+				Valences[VertexIndex] = Valence;
+				TargetValences[VertexIndex] = IsRemeshFixedVertex(Vertex) ? 4 : 6;
+			});
+			auto FlipImprovesValence = [&](const UBMeshEdge* Edge)
+			{
+				const UBMeshLoop* Loop = Edge->Loop;
+				if (Loop == nullptr || Loop->RadialNext == Loop || Loop->RadialNext->RadialNext != Loop
+					|| Loop->Face->VertCount != 3 || Loop->RadialNext->Face->VertCount != 3)
+					return false;
+				const int32 Corners[4] = { Loop->Vert->Index, Loop->RadialNext->Vert->Index, Loop->Prev->Vert->Index, Loop->RadialNext->Prev->Vert->Index };
+				const int32 Changes[4] = { -1, -1, 1, 1 };
+				int32 DeviationBefore = 0;
+				int32 DeviationAfter = 0;
+				for (int32 i = 0; i < 4; ++i)
+				{
+					DeviationBefore += FMath::Abs(Valences[Corners[i]] - TargetValences[Corners[i]]);
+					DeviationAfter += FMath::Abs(Valences[Corners[i]] + Changes[i] - TargetValences[Corners[i]]);
+				}
+				return DeviationAfter < DeviationBefore;
+			};
+			// Valences change with each flip, so candidates are checked again before being flipped
+			SelectEdges(FlipImprovesValence);
+			for (UBMeshEdge* Edge : SelectedEdges)
+			{
+				if (!FlipImprovesValence(Edge) || !FlipKeepsOrientation(Edge))
+					continue;
+				const int32 Vert1 = Edge->Vert1->Index;
+				const int32 Vert2 = Edge->Vert2->Index;
+				if (FlipEdge(Mesh, Edge))
+				{
+					--Valences[Vert1];
+					--Valences[Vert2];
+					++Valences[Edge->Vert1->Index];
+					++Valences[Edge->Vert2->Index];
+				}
+			}
+		}
+
+		// Move vertices toward the center of their neighbors, in their tangent plane
+		{
+			const int32 NumVertices = Mesh->Vertices.Num();
+			TArray<FVector> Locations;
+			Locations.SetNumUninitialized(NumVertices);
+			ParallelFor(NumVertices, [&](int32 VertexIndex)
+			{
+				const UBMeshVertex* Vertex = Mesh->Vertices[VertexIndex];
+				Locations[VertexIndex] = Vertex->Location;
+				if (IsRemeshFixedVertex(Vertex))
+					return;
+				FVector Center = FVector::ZeroVector;
+				FVector Normal = FVector::ZeroVector;
+				int32 NumNeighbors = 0;
+				for (const UBMeshEdge* Edge : Vertex->EdgesRange())
+				{
+					Center += Edge->OtherVertex(Vertex)->Location;
+					++NumNeighbors;
+					// Each face is visited once, from its corner at the vertex
+					const UBMeshLoop* Loop = Edge->Loop->Vert == Vertex ? Edge->Loop : Edge->Loop->RadialNext;
+					Normal += (Loop->Next->Vert->Location - Vertex->Location) ^ (Loop->Prev->Vert->Location - Vertex->Location);
+				}
+				FVector Offset = Center / NumNeighbors - Vertex->Location;
+				if (Normal.Normalize())
+				{
+					Offset -= (Offset | Normal) * Normal;
+				}
+				Locations[VertexIndex] += Offset * Params.RelaxationStrength;
+			});
+			ParallelFor(NumVertices, [&](int32 VertexIndex)
+			{
+				Mesh->Vertices[VertexIndex]->Location = Locations[VertexIndex];
+			});
+		}
+	}
+}
+
+namespace
+{
+	enum class EFaceOffset : uint8
+	{
+		// Along the normals of the faces
+		Extrude,
+		// Inwards from the boundary of each region, in the plane of its faces
+		Inset,
+	};
+
+	/**
+	 * Replace the faces by copies along new vertices, moved by the given offset, and join the boundary
+	 * of each region (of each face in Individual mode) to its copy with quads
+	 * @retval the copies of the faces, in the order they were given
+	 */
+	TArray<UBMeshFace*> OffsetFaceRegions(UBMesh* Mesh, TArrayView<UBMeshFace* const> InFaces, EBMeshFaceRegionMode Mode, EFaceOffset OffsetKind, float Amount)
+	{
+		check(Mesh);
+		const bool bIndividual = Mode == EBMeshFaceRegionMode::Individual;
+		TSet<const UBMeshFace*> Selection;
+		Selection.Reserve(InFaces.Num());
+		TArray<UBMeshFace*> Faces;
+		Faces.Reserve(InFaces.Num());
+		for (UBMeshFace* Face : InFaces)
+		{
+			check(Face != nullptr && Face->GetOuter() == Mesh);
+			bool bIsAlreadyInSet = false;
+			Selection.Add(Face, &bIsAlreadyInSet);
+			if (!bIsAlreadyInSet)
+			{
+				Faces.Add(Face);
+			}
+		}
+		const int32 NumFaces = Faces.Num();
+		if (NumFaces == 0)
+			return {};
+
+		// Corners of all faces, laid out face after face
+		TArray<int32> CornerOffsets;
+		CornerOffsets.SetNumUninitialized(NumFaces + 1);
+		CornerOffsets[0] = 0;
+		for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+		{
+			CornerOffsets[FaceIndex + 1] = CornerOffsets[FaceIndex] + Faces[FaceIndex]->VertCount;
+		}
+		const int32 NumCorners = CornerOffsets[NumFaces];
+		TArray<UBMeshLoop*> Corners;
+		Corners.SetNumUninitialized(NumCorners);
+		TArray<int32> CornerFaces;
+		CornerFaces.SetNumUninitialized(NumCorners);
+		TArray<FVector> FaceNormals;
+		FaceNormals.SetNumUninitialized(NumFaces);
+		ParallelFor(NumFaces, [&](int32 FaceIndex)
+		{
+			int32 Corner = CornerOffsets[FaceIndex];
+			FVector Normal = FVector::ZeroVector;
+			for (UBMeshLoop* Loop : Faces[FaceIndex]->Loops())
+			{
+				Normal += Loop->Vert->Location ^ Loop->Next->Vert->Location;
+				CornerFaces[Corner] = FaceIndex;
+				Corners[Corner++] = Loop;
+			}
+			FaceNormals[FaceIndex] = Normal.GetSafeNormal();
+		});
+		auto NextCorner = [&](int32 Corner)
+		{
+			const int32 FaceIndex = CornerFaces[Corner];
+			return Corner + 1 < CornerOffsets[FaceIndex + 1] ? Corner + 1 : CornerOffsets[FaceIndex];
+		};
+
+		// Corners along the boundary of their region get a side quad
+		TArray<bool> IsBoundaryCorner;
+		IsBoundaryCorner.SetNumUninitialized(NumCorners);
+		ParallelFor(NumCorners, [&](int32 Corner)
+		{
+			bool bIsBoundary = true;
+			if (!bIndividual)
+			{
+				for (const UBMeshLoop* Loop = Corners[Corner]->RadialNext; Loop != Corners[Corner]; Loop = Loop->RadialNext)
+				{
+					bIsBoundary &= !Selection.Contains(Loop->Face);
+				}
+			}
+			IsBoundaryCorner[Corner] = bIsBoundary;
+		});
+
+		// New vertices: one per corner in Individual mode, one per vertex of the selection in Region mode
+		TArray<int32> CornerVertices;
+		CornerVertices.SetNumUninitialized(NumCorners);
+		TArray<UBMeshVertex*> SourceVertices;
+		if (bIndividual)
+		{
+			SourceVertices.SetNumUninitialized(NumCorners);
+			for (int32 Corner = 0; Corner < NumCorners; ++Corner)
+			{
+				CornerVertices[Corner] = Corner;
+				SourceVertices[Corner] = Corners[Corner]->Vert;
+			}
+		}
+		else
+		{
+			// New vertex of each mesh vertex, by vertex index
+			TArray<int32> VertexIndices;
+			VertexIndices.Init(INDEX_NONE, Mesh->Vertices.Num());
+			for (int32 Corner = 0; Corner < NumCorners; ++Corner)
+			{
+				UBMeshVertex* Vertex = Corners[Corner]->Vert;
+				int32& Index = VertexIndices[Vertex->Index];
+				if (Index == INDEX_NONE)
+				{
+					Index = SourceVertices.Add(Vertex);
+				}
+				CornerVertices[Corner] = Index;
+			}
+		}
+		const int32 NumNewVertices = SourceVertices.Num();
+
+		// Offset directions are averaged, then scaled so that faces move by Amount along their normal
+		// (when extruding) and boundary edges move by Amount across (when insetting)
+		TArray<FVector> Directions;
+		Directions.SetNumZeroed(NumNewVertices);
+		TArray<int32> NumDirections;
+		NumDirections.SetNumZeroed(NumNewVertices);
+		for (int32 Corner = 0; Corner < NumCorners; ++Corner)
+		{
+			const FVector& Normal = FaceNormals[CornerFaces[Corner]];
+			if (OffsetKind == EFaceOffset::Extrude)
+			{
+				Directions[CornerVertices[Corner]] += Normal;
+				++NumDirections[CornerVertices[Corner]];
+			}
+			else if (IsBoundaryCorner[Corner])
+			{
+				const int32 Next = NextCorner(Corner);
+				const FVector Across = Normal ^ (Corners[Next]->Vert->Location - Corners[Corner]->Vert->Location).GetSafeNormal();
+				for (const int32 End : { Corner, Next })
+				{
+					Directions[CornerVertices[End]] += Across;
+					++NumDirections[CornerVertices[End]];
+				}
+			}
+		}
+		TArray<FVector> Locations;
+		Locations.SetNumUninitialized(NumNewVertices);
+		ParallelFor(NumNewVertices, [&](int32 VertexIndex)
+		{
+			FVector Offset = FVector::ZeroVector;
+			if (NumDirections[VertexIndex] > 0)
+			{
+				const FVector Average = Directions[VertexIndex] / NumDirections[VertexIndex];
+				// Sharp corners would shoot far away, their offset is limited to 10 times the amount
+				Offset = Average * (Amount / FMath::Max(float(Average.SizeSquared()), 0.01f));
+			}
+			Locations[VertexIndex] = SourceVertices[VertexIndex]->Location + Offset;
+		});
+
+		TArray<int32> BoundaryCorners;
+		for (int32 Corner = 0; Corner < NumCorners; ++Corner)
+		{
+			if (IsBoundaryCorner[Corner])
+			{
+				BoundaryCorners.Add(Corner);
+			}
+		}
+		const int32 NumSides = BoundaryCorners.Num();
+
+		// Copies of the faces first, then sides, the builder appends faces and loops in that order
+		const int32 FirstNewVertex = Mesh->Vertices.Num();
+		const int32 FirstNewFace = Mesh->Faces.Num();
+		const int32 FirstNewLoop = Mesh->Loops.Num();
+		{
+			FBMeshBuilder Builder(Mesh);
+			Builder.Reserve(NumNewVertices, NumCorners + NumSides, NumCorners + NumSides * 4, NumFaces + NumSides);
+			for (const FVector& Location : Locations)
+			{
+				Builder.AddVertex(Location);
+			}
+			TArray<int32, TInlineAllocator<8>> FaceVertices;
+			for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+			{
+				FaceVertices.Reset();
+				for (int32 Corner = CornerOffsets[FaceIndex]; Corner < CornerOffsets[FaceIndex + 1]; ++Corner)
+				{
+					FaceVertices.Add(FirstNewVertex + CornerVertices[Corner]);
+				}
+				Builder.AddFace(FaceVertices);
+			}
+			for (const int32 Corner : BoundaryCorners)
+			{
+				const int32 Next = NextCorner(Corner);
+				UBMeshVertex* const Side[4] = {
+					Corners[Corner]->Vert, Corners[Next]->Vert,
+					Mesh->Vertices[FirstNewVertex + CornerVertices[Next]], Mesh->Vertices[FirstNewVertex + CornerVertices[Corner]]
+				};
+				Builder.AddFace(MakeArrayView(Side));
+			}
+		}
+
+		const FBMeshOperators::FAttributeLayout VertexAttributes(Mesh->VertexClass, UBMeshVertex::StaticClass(), &Mesh->VertexLayers);
+		const FBMeshOperators::FAttributeLayout FaceAttributes(Mesh->FaceClass, UBMeshFace::StaticClass(), &Mesh->FaceLayers);
+		const FBMeshOperators::FAttributeLayout LoopAttributes(Mesh->LoopClass, UBMeshLoop::StaticClass(), &Mesh->LoopLayers);
+		ParallelFor(NumNewVertices, [&](int32 VertexIndex)
+		{
+			UBMeshVertex* Vertex = Mesh->Vertices[FirstNewVertex + VertexIndex];
+			Vertex->Id = SourceVertices[VertexIndex]->Id;
+			VertexAttributes.Copy(Vertex, SourceVertices[VertexIndex]);
+		});
+		ParallelFor(NumFaces, [&](int32 FaceIndex)
+		{
+			UBMeshFace* Copy = Mesh->Faces[FirstNewFace + FaceIndex];
+			Copy->Id = Faces[FaceIndex]->Id;
+			FaceAttributes.Copy(Copy, Faces[FaceIndex]);
+			for (int32 Corner = CornerOffsets[FaceIndex]; Corner < CornerOffsets[FaceIndex + 1]; ++Corner)
+			{
+				LoopAttributes.Copy(Mesh->Loops[FirstNewLoop + Corner], Corners[Corner]);
+			}
+		});
+		ParallelFor(NumSides, [&](int32 SideIndex)
+		{
+			const int32 Corner = BoundaryCorners[SideIndex];
+			const int32 Next = NextCorner(Corner);
+			const UBMeshFace* Source = Faces[CornerFaces[Corner]];
+			UBMeshFace* Side = Mesh->Faces[FirstNewFace + NumFaces + SideIndex];
+			Side->Id = Source->Id;
+			FaceAttributes.Copy(Side, Source);
+			const int32 SideLoop = FirstNewLoop + NumCorners + SideIndex * 4;
+			LoopAttributes.Copy(Mesh->Loops[SideLoop], Corners[Corner]);
+			LoopAttributes.Copy(Mesh->Loops[SideLoop + 1], Corners[Next]);
+			LoopAttributes.Copy(Mesh->Loops[SideLoop + 2], Corners[Next]);
+			LoopAttributes.Copy(Mesh->Loops[SideLoop + 3], Corners[Corner]);
+		});
+
+		// Remove the original faces, and the edges and vertices inside regions that nothing uses anymore
+		TSet<UBMeshEdge*> FreedEdges;
+		for (int32 Corner = 0; Corner < NumCorners; ++Corner)
+		{
+			if (!IsBoundaryCorner[Corner])
+			{
+				FreedEdges.Add(Corners[Corner]->Edge);
+			}
+		}
+		FBMeshDeferredRemovalScope DeferredRemovals(Mesh);
+		for (UBMeshFace* Face : Faces)
+		{
+			Mesh->RemoveFace(Face);
+		}
+		for (UBMeshEdge* Edge : FreedEdges)
+		{
+			if (Edge->Loop == nullptr)
+			{
+				Mesh->RemoveEdge(Edge);
+			}
+		}
+		for (UBMeshVertex* Vertex : SourceVertices)
+		{
+			if (Vertex->Edge == nullptr)
+			{
+				Mesh->RemoveFromContainer(Vertex);
+			}
+		}
+
+		TArray<UBMeshFace*> Copies;
+		Copies.Append(Mesh->Faces.GetData() + FirstNewFace, NumFaces);
+		return Copies;
+	}
+}
+
+TArray<UBMeshFace*> FBMeshOperators::ExtrudeFaces(UBMesh* Mesh, TArrayView<UBMeshFace* const> Faces, float Distance, EBMeshFaceRegionMode Mode)
+{
+	return OffsetFaceRegions(Mesh, Faces, Mode, EFaceOffset::Extrude, Distance);
+}
+
+TArray<UBMeshFace*> FBMeshOperators::InsetFaces(UBMesh* Mesh, TArrayView<UBMeshFace* const> Faces, float Thickness, EBMeshFaceRegionMode Mode)
+{
+	return OffsetFaceRegions(Mesh, Faces, Mode, EFaceOffset::Inset, Thickness);
+}
+
+namespace
+{
+	/**
+	 * Faces around a vertex, counterclockwise: from any corner at the vertex for interior vertices,
+	 * and from the corner after the outgoing boundary edge for boundary vertices
+	 */
+	struct FDualCell
+	{
+		const UBMeshLoop* First = nullptr;
+		// Boundary edge closing the fan, null for interior vertices
+		const UBMeshEdge* LastEdge = nullptr;
+		// Zero if the faces around the vertex don't form a single fan
+		int32 NumFaces = 0;
+	};
+
+	FDualCell FindDualCell(const UBMeshVertex* Vertex)
+	{
+		FDualCell Cell;
+		if (Vertex->Edge == nullptr)
+			return Cell;
+		int32 NumLoops = 0;
+		int32 NumBoundaryEdges = 0;
+		for (const UBMeshEdge* Edge : Vertex->EdgesRange())
+		{
+			const UBMeshLoop* Loop = Edge->Loop;
+			if (Loop == nullptr || Loop->RadialNext->RadialNext != Loop)
+				return Cell;
+			if (Loop->RadialNext == Loop)
+			{
+				++NumLoops;
+				++NumBoundaryEdges;
+				if (Loop->Vert == Vertex)
+				{
+					Cell.First = Loop;
+				}
+			}
+			else
+			{
+				NumLoops += 2;
+			}
+		}
+		if (NumBoundaryEdges == 0)
+		{
+			const UBMeshLoop* Loop = Vertex->Edge->Loop;
+			Cell.First = Loop->Vert == Vertex ? Loop : Loop->RadialNext;
+		}
+		else if (NumBoundaryEdges != 2 || Cell.First == nullptr)
+		{
+			Cell.First = nullptr;
+			return Cell;
+		}
+
+		// Each face of the fan has two corners along the edges of the vertex
+		const int32 NumFaces = NumLoops / 2;
+		const UBMeshLoop* Loop = Cell.First;
+		int32 NumVisited = 0;
+		do
+		{
+			++NumVisited;
+			const UBMeshLoop* Incoming = Loop->Prev;
+			if (Incoming->RadialNext == Incoming)
+			{
+				Cell.LastEdge = Incoming->Edge;
+				break;
+			}
+			Loop = Incoming->RadialNext;
+		}
+		while (Loop != Cell.First && Loop->Vert == Vertex && NumVisited < NumFaces);
+		const bool bIsClosed = NumBoundaryEdges == 0 ? Loop == Cell.First : Cell.LastEdge != nullptr;
+		Cell.NumFaces = bIsClosed && NumVisited == NumFaces ? NumFaces : 0;
+		return Cell;
+	}
+}
+
+UBMesh* FBMeshOperators::Dual(UBMesh* Mesh, EBMeshDualBoundary Boundary)
+{
+	check(Mesh);
+	const bool bCloseBoundary = Boundary == EBMeshDualBoundary::Close;
+	const int32 NumFaces = Mesh->Faces.Num();
+	const int32 NumVertices = Mesh->Vertices.Num();
+
+	TArray<FDualCell> Cells;
+	Cells.SetNumUninitialized(NumVertices);
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		FDualCell Cell = FindDualCell(Mesh->Vertices[VertexIndex]);
+		// Boundary cells have a corner at the vertex and at the middle of both boundary edges
+		const int32 NumCorners = Cell.NumFaces + (Cell.LastEdge ? 3 : 0);
+		if ((Cell.LastEdge && !bCloseBoundary) || NumCorners < 3)
+		{
+			Cell.NumFaces = 0;
+		}
+		Cells[VertexIndex] = Cell;
+	});
+
+	// Dual vertices: face centers, then for closed boundary cells, middles of boundary edges and
+	// copies of boundary vertices
+	TArray<int32> CellOffsets;
+	CellOffsets.SetNumUninitialized(NumVertices + 1);
+	CellOffsets[0] = 0;
+	TArray<const UObject*> Sources;
+	Sources.Reserve(NumFaces);
+	for (const UBMeshFace* Face : Mesh->Faces)
+	{
+		Sources.Add(Face);
+	}
+	TArray<int32> MiddleIndices;
+	MiddleIndices.Init(INDEX_NONE, Mesh->Edges.Num());
+	TArray<int32> VertexCopyIndices;
+	VertexCopyIndices.Init(INDEX_NONE, NumVertices);
+	for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+	{
+		const FDualCell& Cell = Cells[VertexIndex];
+		int32 NumCorners = Cell.NumFaces;
+		if (Cell.NumFaces > 0 && Cell.LastEdge)
+		{
+			NumCorners += 3;
+			for (const UBMeshEdge* Edge : { static_cast<const UBMeshEdge*>(Cell.First->Edge), Cell.LastEdge })
+			{
+				if (MiddleIndices[Edge->Index] == INDEX_NONE)
+				{
+					MiddleIndices[Edge->Index] = Sources.Add(Edge);
+				}
+			}
+			VertexCopyIndices[VertexIndex] = Sources.Add(Mesh->Vertices[VertexIndex]);
+		}
+		CellOffsets[VertexIndex + 1] = CellOffsets[VertexIndex] + NumCorners;
+	}
+	const int32 NumCorners = CellOffsets[NumVertices];
+
+	TArray<int32> CellCorners;
+	CellCorners.SetNumUninitialized(NumCorners);
+	ParallelFor(NumVertices, [&](int32 VertexIndex)
+	{
+		const FDualCell& Cell = Cells[VertexIndex];
+		if (Cell.NumFaces == 0)
+			return;
+		int32 Corner = CellOffsets[VertexIndex];
+		if (Cell.LastEdge)
+		{
+			CellCorners[Corner++] = MiddleIndices[Cell.First->Edge->Index];
+		}
+		const UBMeshLoop* Loop = Cell.First;
+		for (int32 i = 0; i < Cell.NumFaces; ++i)
+		{
+			CellCorners[Corner++] = Loop->Face->Index;
+			Loop = Loop->Prev->RadialNext;
+		}
+		if (Cell.LastEdge)
+		{
+			CellCorners[Corner++] = MiddleIndices[Cell.LastEdge->Index];
+			CellCorners[Corner++] = VertexCopyIndices[VertexIndex];
+		}
+	});
+
+	// Faces whose vertices get no cell would be left as loose vertices
+	TArray<int32> NewVertexIndices;
+	NewVertexIndices.Init(INDEX_NONE, Sources.Num());
+	for (const int32 Source : CellCorners)
+	{
+		NewVertexIndices[Source] = 0;
+	}
+	TArray<const UObject*> UsedSources;
+	UsedSources.Reserve(Sources.Num());
+	for (int32 Source = 0; Source < Sources.Num(); ++Source)
+	{
+		if (NewVertexIndices[Source] != INDEX_NONE)
+		{
+			NewVertexIndices[Source] = UsedSources.Add(Sources[Source]);
+		}
+	}
+	TArray<FVector> Locations;
+	Locations.SetNumUninitialized(UsedSources.Num());
+	ParallelFor(UsedSources.Num(), [&](int32 Index)
+	{
+		const UObject* Source = UsedSources[Index];
+		if (const UBMeshFace* Face = Cast<UBMeshFace>(Source))
+		{
+			Locations[Index] = Face->Center();
+		}
+		else if (const UBMeshEdge* Edge = Cast<UBMeshEdge>(Source))
+		{
+			Locations[Index] = (Edge->Vert1->Location + Edge->Vert2->Location) * 0.5f;
+		}
+		else
+		{
+			Locations[Index] = CastChecked<UBMeshVertex>(Source)->Location;
+		}
+	});
+
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = Mesh->VertexClass;
+	Params.EdgeClass = Mesh->EdgeClass;
+	Params.LoopClass = Mesh->LoopClass;
+	Params.FaceClass = Mesh->FaceClass;
+	UBMesh* DualMesh = UBMesh::Make(Mesh->GetOuter(), Params);
+	TArray<int32> DualCells;
+	{
+		FBMeshBuilder Builder(DualMesh);
+		// Each edge is shared by two cells at most
+		Builder.Reserve(UsedSources.Num(), NumCorners, NumCorners, NumVertices);
+		for (const FVector& Location : Locations)
+		{
+			Builder.AddVertex(Location);
+		}
+		TArray<int32, TInlineAllocator<8>> FaceVertices;
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			if (CellOffsets[VertexIndex + 1] == CellOffsets[VertexIndex])
+				continue;
+			FaceVertices.Reset();
+			for (int32 Corner = CellOffsets[VertexIndex]; Corner < CellOffsets[VertexIndex + 1]; ++Corner)
+			{
+				FaceVertices.Add(NewVertexIndices[CellCorners[Corner]]);
+			}
+			Builder.AddFace(FaceVertices);
+			DualCells.Add(VertexIndex);
+		}
+	}
+
+	// Faces become vertices and vertices become faces, so their attributes are paired by name. Element
+	// classes share no topology property other than Id, so UObject is the common base.
+	const FAttributeMapping FaceToVertex(DualMesh->VertexClass, Mesh->FaceClass, UObject::StaticClass());
+	const FAttributeMapping VertexToFace(DualMesh->FaceClass, Mesh->VertexClass, UObject::StaticClass());
+	const FAttributeLayout VertexAttributes(DualMesh->VertexClass, UBMeshVertex::StaticClass());
+	ParallelFor(UsedSources.Num(), [&](int32 Index)
+	{
+		UBMeshVertex* Vertex = DualMesh->Vertices[Index];
+		const UObject* Source = UsedSources[Index];
+		if (const UBMeshFace* Face = Cast<UBMeshFace>(Source))
+		{
+			FaceToVertex.Copy(Vertex, Face);
+			Vertex->Id = Face->Id;
+		}
+		else if (const UBMeshEdge* Edge = Cast<UBMeshEdge>(Source))
+		{
+			VertexAttributes.Copy(Vertex, Edge->Vert1);
+			VertexAttributes.Lerp(Vertex, Edge->Vert1, Edge->Vert2, 0.5f);
+			Vertex->Id = Edge->Id;
+		}
+		else
+		{
+			const UBMeshVertex* Original = CastChecked<UBMeshVertex>(Source);
+			VertexAttributes.Copy(Vertex, Original);
+			Vertex->Id = Original->Id;
+		}
+	});
+	ParallelFor(DualCells.Num(), [&](int32 Index)
+	{
+		UBMeshFace* Face = DualMesh->Faces[Index];
+		const UBMeshVertex* Original = Mesh->Vertices[DualCells[Index]];
+		VertexToFace.Copy(Face, Original);
+		Face->Id = Original->Id;
+	});
+	return DualMesh;
+}
+
+bool FBMeshOperators::Delaunay(UBMesh* Mesh, TArrayView<const FVector2D> Points)
+{
+	check(Mesh);
+	const FBMeshDelaunay Triangulation = FBMeshDelaunay::Build(Points);
+	const int32 NumTriangles = Triangulation.Triangles.Num();
+	if (NumTriangles == 0)
+		return false;
+
+	// Duplicate points skipped by the triangulation are in no triangle, and get no vertex
+	TArray<int32> PointVertices;
+	PointVertices.Init(INDEX_NONE, Points.Num());
+	for (const FIntVector& Triangle : Triangulation.Triangles)
+	{
+		PointVertices[Triangle.X] = PointVertices[Triangle.Y] = PointVertices[Triangle.Z] = 0;
+	}
+	TArray<int32> VertexPoints;
+	VertexPoints.Reserve(Points.Num());
+	const int32 FirstNewVertex = Mesh->Vertices.Num();
+	for (int32 PointIndex = 0; PointIndex < Points.Num(); ++PointIndex)
+	{
+		if (PointVertices[PointIndex] != INDEX_NONE)
+		{
+			PointVertices[PointIndex] = FirstNewVertex + VertexPoints.Add(PointIndex);
+		}
+	}
+
+	const int32 FirstNewFace = Mesh->Faces.Num();
+	{
+		FBMeshBuilder Builder(Mesh);
+		// Edges inside the hull are shared by two triangles
+		Builder.Reserve(VertexPoints.Num(), (NumTriangles * 3 + Triangulation.Hull.Num()) / 2, NumTriangles * 3, NumTriangles);
+		for (const int32 PointIndex : VertexPoints)
+		{
+			Builder.AddVertex(FVector(Points[PointIndex].X, Points[PointIndex].Y, 0));
+		}
+		for (const FIntVector& Triangle : Triangulation.Triangles)
+		{
+			const int32 Corners[3] = { PointVertices[Triangle.X], PointVertices[Triangle.Y], PointVertices[Triangle.Z] };
+			Builder.AddFace(MakeArrayView(Corners));
+		}
+	}
+	ParallelFor(VertexPoints.Num(), [&](int32 VertexIndex)
+	{
+		Mesh->Vertices[FirstNewVertex + VertexIndex]->Id = VertexPoints[VertexIndex];
+	});
+	ParallelFor(NumTriangles, [&](int32 Triangle)
+	{
+		Mesh->Faces[FirstNewFace + Triangle]->Id = Triangle;
+	});
+	return true;
+}
+
+bool FBMeshOperators::Voronoi(UBMesh* Mesh, TArrayView<const FVector2D> Points)
+{
+	check(Mesh);
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = Mesh->VertexClass;
+	Params.EdgeClass = Mesh->EdgeClass;
+	Params.LoopClass = Mesh->LoopClass;
+	Params.FaceClass = Mesh->FaceClass;
+	UBMesh* Triangulation = UBMesh::Make(GetTransientPackage(), Params);
+	if (!Delaunay(Triangulation, Points))
+		return false;
+
+	// Vertices of the dual are at the centroids of the triangles, whose Id is their index, and
+	// Voronoi vertices are at their circumcenters
+	UBMesh* Cells = Dual(Triangulation, EBMeshDualBoundary::Clip);
+	ParallelFor(Cells->Vertices.Num(), [&](int32 VertexIndex)
+	{
+		UBMeshVertex* Vertex = Cells->Vertices[VertexIndex];
+		const UBMeshLoop* Loop = Triangulation->Faces[Vertex->Id]->FirstLoop;
+		const FVector& A = Loop->Vert->Location;
+		const FVector& B = Loop->Next->Vert->Location;
+		const FVector& C = Loop->Prev->Vert->Location;
+		const FVector2D Center = FBMeshDelaunay::Circumcenter(FVector2D(A.X, A.Y), FVector2D(B.X, B.Y), FVector2D(C.X, C.Y));
+		Vertex->Location = FVector(Center.X, Center.Y, 0);
+	});
+	Merge(Mesh, Cells);
+	return Cells->Faces.Num() > 0;
+}
+
+namespace
+{
+	/**
+	 * Vertices, edges and faces of a lattice as indices, where every face has FaceSize corners.
+	 * Corner i of face f is at f * FaceSize + i, and its edge goes to the next corner of the face.
+	 */
+	struct FLatticeTopology
+	{
+		int32 FaceSize = 0;
+		TArray<FVector> Locations;
+		TArray<FIntPoint> EdgeVertices;
+		TArray<int32> CornerVertices;
+		TArray<int32> CornerEdges;
+
+		FLatticeTopology(int32 InFaceSize, int32 NumVertices, int32 NumEdges, int32 NumFaces)
+			: FaceSize(InFaceSize)
+		{
+			Locations.SetNumUninitialized(NumVertices);
+			EdgeVertices.SetNumUninitialized(NumEdges);
+			CornerVertices.SetNumUninitialized(NumFaces * FaceSize);
+			CornerEdges.SetNumUninitialized(NumFaces * FaceSize);
+		}
+	};
+
+	/**
+	 * Add a lattice to a mesh, linking its elements directly instead of going through UBMesh::AddFace.
+	 * Links are the same AddFace would make, except for the order of edges around vertices.
+	 * Only allocating the elements is sequential.
+	 */
+	void AddLattice(UBMesh* Mesh, const FLatticeTopology& Lattice)
+	{
+		const int32 NumVertices = Lattice.Locations.Num();
+		const int32 NumEdges = Lattice.EdgeVertices.Num();
+		const int32 NumLoops = Lattice.CornerVertices.Num();
+		const int32 NumFaces = NumLoops / Lattice.FaceSize;
+		const int32 FaceSize = Lattice.FaceSize;
+
+		// Edges around each vertex, and loops around each edge, which are at most 2 in a lattice
+		TArray<int32> DiskStart;
+		DiskStart.SetNumZeroed(NumVertices + 1);
+		for (const FIntPoint& Ends : Lattice.EdgeVertices)
+		{
+			++DiskStart[Ends.X + 1];
+			++DiskStart[Ends.Y + 1];
+		}
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			DiskStart[VertexIndex + 1] += DiskStart[VertexIndex];
+		}
+		TArray<int32> DiskEdges;
+		DiskEdges.SetNumUninitialized(NumEdges * 2);
+		{
+			TArray<int32> DiskEnd(DiskStart.GetData(), NumVertices);
+			for (int32 EdgeIndex = 0; EdgeIndex < NumEdges; ++EdgeIndex)
+			{
+				DiskEdges[DiskEnd[Lattice.EdgeVertices[EdgeIndex].X]++] = EdgeIndex;
+				DiskEdges[DiskEnd[Lattice.EdgeVertices[EdgeIndex].Y]++] = EdgeIndex;
+			}
+		}
+		TArray<FIntPoint> EdgeLoops;
+		EdgeLoops.Init(FIntPoint(INDEX_NONE, INDEX_NONE), NumEdges);
+		for (int32 Corner = 0; Corner < NumLoops; ++Corner)
+		{
+			FIntPoint& Radial = EdgeLoops[Lattice.CornerEdges[Corner]];
+			if (Radial.X == INDEX_NONE)
+			{
+				Radial.X = Corner;
+			}
+			else
+			{
+				check(Radial.Y == INDEX_NONE);
+				Radial.Y = Corner;
+			}
+		}
+
+		const int32 FirstVertex = Mesh->Vertices.Num();
+		const int32 FirstEdge = Mesh->Edges.Num();
+		const int32 FirstLoop = Mesh->Loops.Num();
+		const int32 FirstFace = Mesh->Faces.Num();
+		Mesh->Vertices.Reserve(FirstVertex + NumVertices);
+		Mesh->Edges.Reserve(FirstEdge + NumEdges);
+		Mesh->Loops.Reserve(FirstLoop + NumLoops);
+		Mesh->Faces.Reserve(FirstFace + NumFaces);
+		for (int32 i = 0; i < NumVertices; ++i)
+		{
+			Mesh->AddToContainer(NewObject<UBMeshVertex>(Mesh, *Mesh->VertexClass));
+		}
+		for (int32 i = 0; i < NumEdges; ++i)
+		{
+			Mesh->AddToContainer(NewObject<UBMeshEdge>(Mesh, *Mesh->EdgeClass));
+		}
+		for (int32 i = 0; i < NumLoops; ++i)
+		{
+			Mesh->AddToContainer(NewObject<UBMeshLoop>(Mesh, *Mesh->LoopClass));
+		}
+		for (int32 i = 0; i < NumFaces; ++i)
+		{
+			Mesh->AddToContainer(NewObject<UBMeshFace>(Mesh, *Mesh->FaceClass));
+		}
+		UBMeshVertex* const* Vertices = Mesh->Vertices.GetData() + FirstVertex;
+		UBMeshEdge* const* Edges = Mesh->Edges.GetData() + FirstEdge;
+		UBMeshLoop* const* Loops = Mesh->Loops.GetData() + FirstLoop;
+		UBMeshFace* const* Faces = Mesh->Faces.GetData() + FirstFace;
+
+		// Edge ends must be set before disks are linked, as that depends on which end a vertex is
+		ParallelFor(NumEdges, [&](int32 EdgeIndex)
+		{
+			UBMeshEdge* Edge = Edges[EdgeIndex];
+			const FIntPoint& Radial = EdgeLoops[EdgeIndex];
+			Edge->Vert1 = Vertices[Lattice.EdgeVertices[EdgeIndex].X];
+			Edge->Vert2 = Vertices[Lattice.EdgeVertices[EdgeIndex].Y];
+			// Loops are inserted at the head of the radial list, so the last one is the edge's loop
+			Edge->Loop = Radial.X != INDEX_NONE ? Loops[Radial.Y != INDEX_NONE ? Radial.Y : Radial.X] : nullptr;
+		});
+		ParallelFor(NumVertices, [&](int32 VertexIndex)
+		{
+			UBMeshVertex* Vertex = Vertices[VertexIndex];
+			Vertex->Location = Lattice.Locations[VertexIndex];
+			Vertex->Id = VertexIndex;
+
+			const int32 Start = DiskStart[VertexIndex];
+			const int32 Num = DiskStart[VertexIndex + 1] - Start;
+			Vertex->Edge = Num > 0 ? Edges[DiskEdges[Start]] : nullptr;
+			for (int32 i = 0; i < Num; ++i)
+			{
+				UBMeshEdge* Edge = Edges[DiskEdges[Start + i]];
+				Edge->SetNext(Vertex, Edges[DiskEdges[Start + (i + 1) % Num]]);
+				Edge->SetPrev(Vertex, Edges[DiskEdges[Start + (i + Num - 1) % Num]]);
+			}
+		});
+		ParallelFor(NumLoops, [&](int32 Corner)
+		{
+			UBMeshLoop* Loop = Loops[Corner];
+			const int32 FaceCorner = Corner % FaceSize;
+			const int32 FaceStart = Corner - FaceCorner;
+			Loop->Vert = Vertices[Lattice.CornerVertices[Corner]];
+			Loop->Edge = Edges[Lattice.CornerEdges[Corner]];
+			Loop->Face = Faces[Corner / FaceSize];
+			Loop->Next = Loops[FaceStart + (FaceCorner + 1) % FaceSize];
+			Loop->Prev = Loops[FaceStart + (FaceCorner + FaceSize - 1) % FaceSize];
+
+			const FIntPoint& Radial = EdgeLoops[Lattice.CornerEdges[Corner]];
+			const int32 Other = Radial.X == Corner ? Radial.Y : Radial.X;
+			Loop->RadialNext = Loop->RadialPrev = Loops[Other != INDEX_NONE ? Other : Corner];
+		});
+		ParallelFor(NumFaces, [&](int32 FaceIndex)
+		{
+			UBMeshFace* Face = Faces[FaceIndex];
+			Face->Id = FaceIndex;
+			Face->VertCount = FaceSize;
+			// UBMeshLoop::SetFace leaves the last loop as the first one
+			Face->FirstLoop = Loops[FaceIndex * FaceSize + FaceSize - 1];
+		});
+	}
+
+	/**
+	 * Indexing of a lattice of equilateral triangles, in rows of vertices along X. Vertex (Q, R) is at
+	 * Q + R / 2 cells along X and R * sqrt(3) / 2 cells along Y, and row R holds the vertices from
+	 * Q = MinQ to MaxQ. A vertex has edges to (Q + 1, R), (Q, R + 1) and (Q - 1, R + 1), upward triangle
+	 * (Q, R) has corners (Q, R), (Q + 1, R) and (Q, R + 1), and downward triangle (Q, R) has corners
+	 * (Q + 1, R), (Q + 1, R + 1) and (Q, R + 1). Each of them is in the lattice if all its vertices are.
+	 * Each kind of element of a row has a contiguous range of indices, so any element is found in
+	 * constant time from its coordinates.
+	 */
+	class FTriangleLattice
+	{
+	public:
+		/**
+		 * @param RowRanges the MinQ and MaxQ of each row, with rows starting at R = FirstRow
+		 */
+		FTriangleLattice(TArrayView<const FIntPoint> RowRanges, int32 InFirstRow)
+			: FirstRow(InFirstRow)
+		{
+			Rows.SetNum(RowRanges.Num());
+			for (int32 Row = 0; Row < RowRanges.Num(); ++Row)
+			{
+				const int32 MinQ = RowRanges[Row].X;
+				const int32 MaxQ = RowRanges[Row].Y;
+				FRow& Data = Rows[Row];
+				Data.Vertices = FRange(MinQ, MaxQ);
+				Data.EdgesQ = FRange(MinQ, MaxQ - 1);
+				if (Row + 1 < RowRanges.Num())
+				{
+					const int32 NextMinQ = RowRanges[Row + 1].X;
+					const int32 NextMaxQ = RowRanges[Row + 1].Y;
+					Data.EdgesR = FRange(FMath::Max(MinQ, NextMinQ), FMath::Min(MaxQ, NextMaxQ));
+					Data.EdgesQR = FRange(FMath::Max(MinQ, NextMinQ + 1), FMath::Min(MaxQ, NextMaxQ + 1));
+					Data.UpFaces = FRange(FMath::Max(MinQ, NextMinQ), FMath::Min(MaxQ - 1, NextMaxQ));
+					Data.DownFaces = FRange(FMath::Max(MinQ - 1, NextMinQ), FMath::Min(MaxQ - 1, NextMaxQ - 1));
+				}
+				Data.FirstVertex = NumVertices;
+				Data.FirstEdge = NumEdges;
+				Data.FirstFace = NumFaces;
+				NumVertices += Data.Vertices.Num;
+				NumEdges += Data.EdgesQ.Num + Data.EdgesR.Num + Data.EdgesQR.Num;
+				NumFaces += Data.UpFaces.Num + Data.DownFaces.Num;
+			}
+		}
+
+		FLatticeTopology MakeTopology(float CellSize, const FVector& Origin) const
+		{
+			FLatticeTopology Lattice(3, NumVertices, NumEdges, NumFaces);
+			const float RowHeight = CellSize * FMath::Sqrt(3.0f) / 2;
+			ParallelFor(Rows.Num(), [&](int32 Row)
+			{
+				const FRow& Data = Rows[Row];
+				const int32 R = FirstRow + Row;
+				for (int32 Q = Data.Vertices.Min; Q < Data.Vertices.End(); ++Q)
+				{
+					Lattice.Locations[Vertex(Q, Row)] = Origin + FVector((Q + R * 0.5f) * CellSize, R * RowHeight, 0);
+				}
+				for (int32 Q = Data.EdgesQ.Min; Q < Data.EdgesQ.End(); ++Q)
+				{
+					Lattice.EdgeVertices[EdgeQ(Q, Row)] = FIntPoint(Vertex(Q, Row), Vertex(Q + 1, Row));
+				}
+				for (int32 Q = Data.EdgesR.Min; Q < Data.EdgesR.End(); ++Q)
+				{
+					Lattice.EdgeVertices[EdgeR(Q, Row)] = FIntPoint(Vertex(Q, Row), Vertex(Q, Row + 1));
+				}
+				for (int32 Q = Data.EdgesQR.Min; Q < Data.EdgesQR.End(); ++Q)
+				{
+					Lattice.EdgeVertices[EdgeQR(Q, Row)] = FIntPoint(Vertex(Q, Row), Vertex(Q - 1, Row + 1));
+				}
+				for (int32 Q = Data.UpFaces.Min; Q < Data.UpFaces.End(); ++Q)
+				{
+					const int32 Corner = (Data.FirstFace + Data.UpFaces.IndexOf(Q)) * 3;
+					Lattice.CornerVertices[Corner + 0] = Vertex(Q, Row);
+					Lattice.CornerVertices[Corner + 1] = Vertex(Q + 1, Row);
+					Lattice.CornerVertices[Corner + 2] = Vertex(Q, Row + 1);
+					Lattice.CornerEdges[Corner + 0] = EdgeQ(Q, Row);
+					Lattice.CornerEdges[Corner + 1] = EdgeQR(Q + 1, Row);
+					Lattice.CornerEdges[Corner + 2] = EdgeR(Q, Row);
+				}
+				for (int32 Q = Data.DownFaces.Min; Q < Data.DownFaces.End(); ++Q)
+				{
+					const int32 Corner = (Data.FirstFace + Data.UpFaces.Num + Data.DownFaces.IndexOf(Q)) * 3;
+					Lattice.CornerVertices[Corner + 0] = Vertex(Q + 1, Row);
+					Lattice.CornerVertices[Corner + 1] = Vertex(Q + 1, Row + 1);
+					Lattice.CornerVertices[Corner + 2] = Vertex(Q, Row + 1);
+					Lattice.CornerEdges[Corner + 0] = EdgeR(Q + 1, Row);
+					Lattice.CornerEdges[Corner + 1] = EdgeQ(Q, Row + 1);
+					Lattice.CornerEdges[Corner + 2] = EdgeQR(Q + 1, Row);
+				}
+			});
+			return Lattice;
+		}
+
+	private:
+		struct FRange
+		{
+			int32 Min = 0;
+			int32 Num = 0;
+
+			FRange() = default;
+			FRange(int32 InMin, int32 InMax) : Min(InMin), Num(FMath::Max(InMax - InMin + 1, 0)) {}
+
+			int32 End() const { return Min + Num; }
+			int32 IndexOf(int32 Q) const { return Q - Min; }
+		};
+
+		struct FRow
+		{
+			FRange Vertices, EdgesQ, EdgesR, EdgesQR, UpFaces, DownFaces;
+			int32 FirstVertex = 0;
+			int32 FirstEdge = 0;
+			int32 FirstFace = 0;
+		};
+
+		int32 Vertex(int32 Q, int32 Row) const
+		{
+			return Rows[Row].FirstVertex + Rows[Row].Vertices.IndexOf(Q);
+		}
+
+		int32 EdgeQ(int32 Q, int32 Row) const
+		{
+			return Rows[Row].FirstEdge + Rows[Row].EdgesQ.IndexOf(Q);
+		}
+
+		int32 EdgeR(int32 Q, int32 Row) const
+		{
+			return Rows[Row].FirstEdge + Rows[Row].EdgesQ.Num + Rows[Row].EdgesR.IndexOf(Q);
+		}
+
+		int32 EdgeQR(int32 Q, int32 Row) const
+		{
+			return Rows[Row].FirstEdge + Rows[Row].EdgesQ.Num + Rows[Row].EdgesR.Num + Rows[Row].EdgesQR.IndexOf(Q);
+		}
+
+		TArray<FRow> Rows;
+		int32 FirstRow = 0;
+		int32 NumVertices = 0;
+		int32 NumEdges = 0;
+		int32 NumFaces = 0;
+	};
+}
+
+bool FBMeshOperators::SquareGrid(UBMesh* Mesh, int32 NumX, int32 NumY, float CellSize)
+{
+	check(Mesh);
+	if (NumX < 1 || NumY < 1)
+		return false;
+
+	const int32 RowVertices = NumX + 1;
+	const int32 NumEdgesX = NumX * (NumY + 1);
+	FLatticeTopology Lattice(4, RowVertices * (NumY + 1), NumEdgesX + RowVertices * NumY, NumX * NumY);
+	auto Vertex = [RowVertices](int32 X, int32 Y) { return Y * RowVertices + X; };
+	auto EdgeX = [NumX](int32 X, int32 Y) { return Y * NumX + X; };
+	auto EdgeY = [NumEdgesX, RowVertices](int32 X, int32 Y) { return NumEdgesX + Y * RowVertices + X; };
+	const FVector Origin(-NumX * CellSize / 2, -NumY * CellSize / 2, 0);
+	ParallelFor(NumY + 1, [&](int32 Y)
+	{
+		for (int32 X = 0; X <= NumX; ++X)
+		{
+			Lattice.Locations[Vertex(X, Y)] = Origin + FVector(X * CellSize, Y * CellSize, 0);
+			if (X < NumX)
+			{
+				Lattice.EdgeVertices[EdgeX(X, Y)] = FIntPoint(Vertex(X, Y), Vertex(X + 1, Y));
+			}
+			if (Y < NumY)
+			{
+				Lattice.EdgeVertices[EdgeY(X, Y)] = FIntPoint(Vertex(X, Y), Vertex(X, Y + 1));
+			}
+			if (X < NumX && Y < NumY)
+			{
+				const int32 Corner = (Y * NumX + X) * 4;
+				Lattice.CornerVertices[Corner + 0] = Vertex(X, Y);
+				Lattice.CornerVertices[Corner + 1] = Vertex(X + 1, Y);
+				Lattice.CornerVertices[Corner + 2] = Vertex(X + 1, Y + 1);
+				Lattice.CornerVertices[Corner + 3] = Vertex(X, Y + 1);
+				Lattice.CornerEdges[Corner + 0] = EdgeX(X, Y);
+				Lattice.CornerEdges[Corner + 1] = EdgeY(X + 1, Y);
+				Lattice.CornerEdges[Corner + 2] = EdgeX(X, Y + 1);
+				Lattice.CornerEdges[Corner + 3] = EdgeY(X, Y);
+			}
+		}
+	});
+	AddLattice(Mesh, Lattice);
+	return true;
+}
+
+bool FBMeshOperators::TriangleGrid(UBMesh* Mesh, int32 NumX, int32 NumY, float CellSize)
+{
+	check(Mesh);
+	if (NumX < 1 || NumY < 1)
+		return false;
+
+	// Rows are shifted back by a cell every other row to undo the half cell shift of each row
+	TArray<FIntPoint> RowRanges;
+	RowRanges.SetNumUninitialized(NumY + 1);
+	for (int32 Row = 0; Row <= NumY; ++Row)
+	{
+		RowRanges[Row] = FIntPoint(-(Row / 2), NumX - Row / 2);
+	}
+	const FTriangleLattice Grid(RowRanges, 0);
+	const FVector Origin(-(NumX + 0.5f) * CellSize / 2, -NumY * CellSize * FMath::Sqrt(3.0f) / 4, 0);
+	AddLattice(Mesh, Grid.MakeTopology(CellSize, Origin));
+	return true;
+}
+
+bool FBMeshOperators::HexagonGrid(UBMesh* Mesh, int32 Subdivisions, float CellSize)
+{
+	check(Mesh);
+	if (Subdivisions < 1)
+		return false;
+
+	// Axial coordinates of the hexagon are those with |Q|, |R| and |Q + R| up to Subdivisions
+	const int32 N = Subdivisions;
+	TArray<FIntPoint> RowRanges;
+	RowRanges.SetNumUninitialized(2 * N + 1);
+	for (int32 R = -N; R <= N; ++R)
+	{
+		RowRanges[R + N] = FIntPoint(FMath::Max(-N, -N - R), FMath::Min(N, N - R));
+	}
+	const FTriangleLattice Grid(RowRanges, -N);
+	AddLattice(Mesh, Grid.MakeTopology(CellSize, FVector::ZeroVector));
+	return true;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace BMeshRadixSort
+{
+	/**
+	 * Order of the given unsigned integer keys, as indices into them. The sort is stable, so equal
+	 * keys keep their order. It goes one byte at a time from the least significant one, and bytes
+	 * that are the same in every key are skipped.
+	 */
+	template <typename KeyType>
+	TArray<int32> SortIndices(TArrayView<const KeyType> Keys)
+	{
+		static_assert(TIsIntegral<KeyType>::Value && !TIsSigned<KeyType>::Value, "Keys must be unsigned integers");
+
+		const int32 Num = Keys.Num();
+		TArray<int32> Order, OrderBuffer;
+		TArray<KeyType> SortedKeys(Keys.GetData(), Num), KeyBuffer;
+		Order.SetNumUninitialized(Num);
+		OrderBuffer.SetNumUninitialized(Num);
+		KeyBuffer.SetNumUninitialized(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Order[Index] = Index;
+		}
+		if (Num == 0)
+			return Order;
+
+		for (int32 Shift = 0; Shift < int32(sizeof(KeyType)) * 8; Shift += 8)
+		{
+			int32 Offsets[256] = {};
+			for (const KeyType Key : SortedKeys)
+			{
+				++Offsets[(Key >> Shift) & 0xff];
+			}
+			if (Offsets[(SortedKeys[0] >> Shift) & 0xff] == Num)
+				continue;
+
+			for (int32 Digit = 0, Offset = 0; Digit < 256; ++Digit)
+			{
+				const int32 Count = Offsets[Digit];
+				Offsets[Digit] = Offset;
+				Offset += Count;
+			}
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				const int32 Destination = Offsets[(SortedKeys[Index] >> Shift) & 0xff]++;
+				KeyBuffer[Destination] = SortedKeys[Index];
+				OrderBuffer[Destination] = Order[Index];
+			}
+			Swap(SortedKeys, KeyBuffer);
+			Swap(Order, OrderBuffer);
+		}
+		return Order;
+	}
+}
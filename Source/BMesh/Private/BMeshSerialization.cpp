@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMesh.h"
+
+#include "Serialization/CustomVersion.h"
+#include "Serialization/StructuredArchive.h"
+#include "UObject/PropertyPortFlags.h"
+
+#include "BMeshCustomVersion.h"
+#include "BMeshVertex.h"
+#include "BMeshEdge.h"
+#include "BMeshLoop.h"
+#include "BMeshFace.h"
+#include "BMeshOperators.h"
+#include "BMeshLog.h"
+
+const FGuid FBMeshCustomVersion::GUID(0x6A1B5E3C, 0x4D2F4B87, 0x9C0E7A15, 0x3F8D2B64);
+
+FCustomVersionRegistration GRegisterBMeshCustomVersion(FBMeshCustomVersion::GUID, FBMeshCustomVersion::LatestVersion, TEXT("BMeshVer"));
+
+namespace
+{
+	// Number of indices stored per element in the packed topology arrays
+	constexpr int32 VertexStride = 2; // Id, Edge
+	constexpr int32 EdgeStride = 8; // Id, Vert1, Vert2, Next1, Next2, Prev1, Prev2, Loop
+	constexpr int32 LoopStride = 7; // Vert, Edge, Face, RadialPrev, RadialNext, Prev, Next
+	constexpr int32 FaceStride = 3; // Id, VertCount, FirstLoop
+
+	/**
+	 * Resolves the indices of a loaded topology array, flagging any index that is out of range
+	 */
+	struct FIndexResolver
+	{
+		bool bValid = true;
+
+		template <typename T>
+		T* operator()(const TArray<T*>& Elements, int32 Index)
+		{
+			if (Index == INDEX_NONE)
+				return nullptr;
+			if (!Elements.IsValidIndex(Index))
+			{
+				bValid = false;
+				return nullptr;
+			}
+			return Elements[Index];
+		}
+	};
+
+	/**
+	 * Position of a linked element in its container, elements keep it in their Index
+	 */
+	template <typename T>
+	int32 PackedIndex(const T* Element)
+	{
+		return Element ? Element->Index : INDEX_NONE;
+	}
+
+	template <typename T>
+	void CreateElements(UBMesh* Mesh, TArray<T*>& Elements, UClass* ElementClass, int32 Num)
+	{
+		Elements.Reset(Num);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Elements.Add(NewObject<T>(Mesh, ElementClass));
+		}
+	}
+
+	/**
+	 * Attributes are written one column per property, laid out by the compiled attribute layout of the element
+	 * class. Each column is tagged with the property name and type and prefixed with its size, so columns that
+	 * no longer match a property of the class are skipped when loading.
+	 */
+	template <typename T>
+	void SerializeAttributeColumns(FArchive& Ar, const TArray<T*>& Elements, UClass* ElementClass, UClass* BaseClass)
+	{
+		const FBMeshOperators::FAttributeLayout Layout(ElementClass, BaseClass);
+
+		int32 NumColumns = Layout.Num();
+		Ar << NumColumns;
+		for (int32 Column = 0; Column < NumColumns && !Ar.IsError(); ++Column)
+		{
+			FProperty* Property = Ar.IsSaving() ? Layout.GetProperty(Column) : nullptr;
+
+			FName Name;
+			FString Type;
+			int32 ArrayDim = 0;
+			if (Property)
+			{
+				Name = Property->GetFName();
+				Type = Property->GetCPPType();
+				ArrayDim = Property->ArrayDim;
+			}
+			Ar << Name << Type << ArrayDim;
+
+			int64 Size = 0;
+			const int64 SizeOffset = Ar.Tell();
+			Ar << Size;
+			const int64 Start = Ar.Tell();
+
+			if (Ar.IsLoading())
+			{
+				for (int32 i = 0; i < Layout.Num() && !Property; ++i)
+				{
+					FProperty* Candidate = Layout.GetProperty(i);
+					if (Candidate->GetFName() == Name && Candidate->GetCPPType() == Type && Candidate->ArrayDim == ArrayDim)
+					{
+						Property = Candidate;
+					}
+				}
+				if (!Property)
+				{
+					UE_LOG(LogBMesh, Warning, TEXT("%s: attribute %s (%s) is not a property of %s anymore, its values are discarded"),
+					       *Ar.GetArchiveName(), *Name.ToString(), *Type, *ElementClass->GetName());
+					Ar.Seek(Start + Size);
+					continue;
+				}
+			}
+
+			{
+				FStructuredArchiveFromArchive Adapter(Ar);
+				FStructuredArchive::FStream Stream = Adapter.GetSlot().EnterStream();
+				for (T* Element : Elements)
+				{
+					for (int32 i = 0; i < Property->ArrayDim; ++i)
+					{
+						Property->SerializeItem(Stream.EnterElement(), Property->ContainerPtrToValuePtr<void>(Element, i), nullptr);
+					}
+				}
+			}
+
+			if (Ar.IsSaving())
+			{
+				const int64 End = Ar.Tell();
+				Size = End - Start;
+				Ar.Seek(SizeOffset);
+				Ar << Size;
+				Ar.Seek(End);
+			}
+			else
+			{
+				Ar.Seek(Start + Size);
+			}
+		}
+	}
+}
+
+void UBMesh::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FBMeshCustomVersion::GUID);
+
+	// Transactions, duplication and reference collection still go through the elements themselves.
+	// Assets saved before the packed format load their elements from the tagged properties.
+	const bool bPacked = Ar.IsPersistent() && !Ar.IsTransacting()
+		&& (Ar.IsSaving() || Ar.CustomVer(FBMeshCustomVersion::GUID) >= FBMeshCustomVersion::PackedTopology);
+	if (!bPacked)
+	{
+		Super::Serialize(Ar);
+		if (Ar.IsLoading())
+		{
+			// Element indices aren't properties, so they're restored from the containers
+			UpdateElementIndices();
+		}
+		// Undo and duplication restore the same elements, so handles to them must keep resolving and
+		// their layers must be kept
+		if (Ar.IsTransacting() || Ar.HasAnyPortFlags(PPF_Duplicate))
+		{
+			SerializeHandles(Ar);
+			SerializeLayers(Ar);
+		}
+		else if (Ar.IsLoading())
+		{
+			ResetHandles();
+			ResetLayers();
+		}
+		return;
+	}
+
+	if (Ar.IsSaving())
+	{
+		// The element containers are saved empty, so the elements are never referenced by the package and
+		// are not written as exports
+		TArray<UBMeshVertex*> SavedVertices = MoveTemp(Vertices);
+		TArray<UBMeshEdge*> SavedEdges = MoveTemp(Edges);
+		TArray<UBMeshLoop*> SavedLoops = MoveTemp(Loops);
+		TArray<UBMeshFace*> SavedFaces = MoveTemp(Faces);
+		Super::Serialize(Ar);
+		Vertices = MoveTemp(SavedVertices);
+		Edges = MoveTemp(SavedEdges);
+		Loops = MoveTemp(SavedLoops);
+		Faces = MoveTemp(SavedFaces);
+	}
+	else
+	{
+		Super::Serialize(Ar);
+	}
+
+	SerializePacked(Ar);
+	if (Ar.IsLoading())
+	{
+		UpdateElementIndices();
+	}
+	if (Ar.IsSaving() || (!Ar.IsError() && Ar.CustomVer(FBMeshCustomVersion::GUID) >= FBMeshCustomVersion::ElementHandles))
+	{
+		SerializeHandles(Ar);
+	}
+	else
+	{
+		ResetHandles();
+	}
+	if (Ar.IsSaving() || (!Ar.IsError() && Ar.CustomVer(FBMeshCustomVersion::GUID) >= FBMeshCustomVersion::AttributeLayers))
+	{
+		SerializeLayers(Ar);
+	}
+	else
+	{
+		ResetLayers();
+	}
+}
+
+void UBMesh::SerializeHandles(FArchive& Ar)
+{
+	const bool bVertexSlotsValid = VertexSlots.Serialize(Ar, Vertices);
+	const bool bFaceSlotsValid = FaceSlots.Serialize(Ar, Faces);
+	if (!bVertexSlotsValid || !bFaceSlotsValid)
+	{
+		UE_LOG(LogBMesh, Warning, TEXT("%s: handles of %s don't match its elements, existing handles won't resolve"), *Ar.GetArchiveName(), *GetPathName());
+		ResetHandles();
+	}
+}
+
+void UBMesh::ResetHandles()
+{
+	VertexSlots.Reset(Vertices);
+	FaceSlots.Reset(Faces);
+}
+
+void UBMesh::SerializeLayers(FArchive& Ar)
+{
+	VertexLayers.Serialize(Ar, Vertices.Num());
+	EdgeLayers.Serialize(Ar, Edges.Num());
+	LoopLayers.Serialize(Ar, Loops.Num());
+	FaceLayers.Serialize(Ar, Faces.Num());
+}
+
+void UBMesh::ResetLayers()
+{
+	VertexLayers.Reset();
+	EdgeLayers.Reset();
+	LoopLayers.Reset();
+	FaceLayers.Reset();
+}
+
+void UBMesh::SerializePacked(FArchive& Ar)
+{
+	int32 NumVertices = Vertices.Num();
+	int32 NumEdges = Edges.Num();
+	int32 NumLoops = Loops.Num();
+	int32 NumFaces = Faces.Num();
+	Ar << NumVertices << NumEdges << NumLoops << NumFaces;
+
+	TArray<FVector> Locations;
+	TArray<int32> VertexData;
+	TArray<int32> EdgeData;
+	TArray<int32> LoopData;
+	TArray<int32> FaceData;
+
+	if (Ar.IsSaving())
+	{
+		Locations.Reserve(NumVertices);
+		VertexData.Reserve(NumVertices * VertexStride);
+		for (const UBMeshVertex* Vertex : Vertices)
+		{
+			Locations.Add(Vertex->Location);
+			VertexData.Add(Vertex->Id);
+			VertexData.Add(PackedIndex(Vertex->Edge));
+		}
+
+		EdgeData.Reserve(NumEdges * EdgeStride);
+		for (const UBMeshEdge* Edge : Edges)
+		{
+			EdgeData.Add(Edge->Id);
+			EdgeData.Add(PackedIndex(Edge->Vert1));
+			EdgeData.Add(PackedIndex(Edge->Vert2));
+			EdgeData.Add(PackedIndex(Edge->Next1));
+			EdgeData.Add(PackedIndex(Edge->Next2));
+			EdgeData.Add(PackedIndex(Edge->Prev1));
+			EdgeData.Add(PackedIndex(Edge->Prev2));
+			EdgeData.Add(PackedIndex(Edge->Loop));
+		}
+
+		LoopData.Reserve(NumLoops * LoopStride);
+		for (const UBMeshLoop* Loop : Loops)
+		{
+			LoopData.Add(PackedIndex(Loop->Vert));
+			LoopData.Add(PackedIndex(Loop->Edge));
+			LoopData.Add(PackedIndex(Loop->Face));
+			LoopData.Add(PackedIndex(Loop->RadialPrev));
+			LoopData.Add(PackedIndex(Loop->RadialNext));
+			LoopData.Add(PackedIndex(Loop->Prev));
+			LoopData.Add(PackedIndex(Loop->Next));
+		}
+
+		FaceData.Reserve(NumFaces * FaceStride);
+		for (const UBMeshFace* Face : Faces)
+		{
+			FaceData.Add(Face->Id);
+			FaceData.Add(Face->VertCount);
+			FaceData.Add(PackedIndex(Face->FirstLoop));
+		}
+	}
+
+	Locations.BulkSerialize(Ar);
+	VertexData.BulkSerialize(Ar);
+	EdgeData.BulkSerialize(Ar);
+	LoopData.BulkSerialize(Ar);
+	FaceData.BulkSerialize(Ar);
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || NumVertices < 0 || NumEdges < 0 || NumLoops < 0 || NumFaces < 0
+			|| Locations.Num() != NumVertices || VertexData.Num() != NumVertices * VertexStride
+			|| EdgeData.Num() != NumEdges * EdgeStride || LoopData.Num() != NumLoops * LoopStride
+			|| FaceData.Num() != NumFaces * FaceStride)
+		{
+			UE_LOG(LogBMesh, Error, TEXT("%s: packed topology of %s is corrupt"), *Ar.GetArchiveName(), *GetPathName());
+			Ar.SetError();
+			return;
+		}
+
+		// Blueprint element classes may not be fully loaded yet
+		Ar.Preload(*VertexClass);
+		Ar.Preload(*EdgeClass);
+		Ar.Preload(*LoopClass);
+		Ar.Preload(*FaceClass);
+
+		// Every element is allocated up front, so all links can be resolved in a single pass
+		CreateElements(this, Vertices, *VertexClass, NumVertices);
+		CreateElements(this, Edges, *EdgeClass, NumEdges);
+		CreateElements(this, Loops, *LoopClass, NumLoops);
+		CreateElements(this, Faces, *FaceClass, NumFaces);
+
+		FIndexResolver Resolve;
+		for (int32 i = 0; i < NumVertices; ++i)
+		{
+			const int32* Data = &VertexData[i * VertexStride];
+			UBMeshVertex* Vertex = Vertices[i];
+			Vertex->Location = Locations[i];
+			Vertex->Id = Data[0];
+			Vertex->Edge = Resolve(Edges, Data[1]);
+		}
+		for (int32 i = 0; i < NumEdges; ++i)
+		{
+			const int32* Data = &EdgeData[i * EdgeStride];
+			UBMeshEdge* Edge = Edges[i];
+			Edge->Id = Data[0];
+			Edge->Vert1 = Resolve(Vertices, Data[1]);
+			Edge->Vert2 = Resolve(Vertices, Data[2]);
+			Edge->Next1 = Resolve(Edges, Data[3]);
+			Edge->Next2 = Resolve(Edges, Data[4]);
+			Edge->Prev1 = Resolve(Edges, Data[5]);
+			Edge->Prev2 = Resolve(Edges, Data[6]);
+			Edge->Loop = Resolve(Loops, Data[7]);
+		}
+		for (int32 i = 0; i < NumLoops; ++i)
+		{
+			const int32* Data = &LoopData[i * LoopStride];
+			UBMeshLoop* Loop = Loops[i];
+			Loop->Vert = Resolve(Vertices, Data[0]);
+			Loop->Edge = Resolve(Edges, Data[1]);
+			Loop->Face = Resolve(Faces, Data[2]);
+			Loop->RadialPrev = Resolve(Loops, Data[3]);
+			Loop->RadialNext = Resolve(Loops, Data[4]);
+			Loop->Prev = Resolve(Loops, Data[5]);
+			Loop->Next = Resolve(Loops, Data[6]);
+		}
+		for (int32 i = 0; i < NumFaces; ++i)
+		{
+			const int32* Data = &FaceData[i * FaceStride];
+			UBMeshFace* Face = Faces[i];
+			Face->Id = Data[0];
+			Face->VertCount = Data[1];
+			Face->FirstLoop = Resolve(Loops, Data[2]);
+		}
+
+		if (!Resolve.bValid)
+		{
+			UE_LOG(LogBMesh, Error, TEXT("%s: packed topology of %s references missing elements"), *Ar.GetArchiveName(), *GetPathName());
+			Ar.SetError();
+			Vertices.Empty();
+			Edges.Empty();
+			Loops.Empty();
+			Faces.Empty();
+			return;
+		}
+	}
+
+	SerializeAttributeColumns(Ar, Vertices, *VertexClass, UBMeshVertex::StaticClass());
+	SerializeAttributeColumns(Ar, Edges, *EdgeClass, UBMeshEdge::StaticClass());
+	SerializeAttributeColumns(Ar, Loops, *LoopClass, UBMeshLoop::StaticClass());
+	SerializeAttributeColumns(Ar, Faces, *FaceClass, UBMeshFace::StaticClass());
+}
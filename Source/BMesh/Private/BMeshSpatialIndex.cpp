@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshSpatialIndex.h"
+
+#include <algorithm>
+
+#include "Async/ParallelFor.h"
+
+#include "BMeshCore.h"
+
+namespace
+{
+	constexpr int32 MaxPrimitivesPerLeaf = 4;
+
+	typedef TArray<int32, TInlineAllocator<64>> FNodeStack;
+	typedef TArray<FVector, TInlineAllocator<8>> FPolygonPoints;
+
+	struct FPolygon
+	{
+		FPolygonPoints Points;
+		FVector Normal = FVector::ZeroVector;
+		FVector Center = FVector::ZeroVector;
+
+		explicit FPolygon(const UBMeshFace* Face)
+		{
+			for (const UBMeshVertex* Vert : Face->Vertices())
+			{
+				Points.Add(Vert->Location);
+				Center += Vert->Location;
+			}
+			Center /= Points.Num();
+			// Newell's method, robust for concave and slightly non planar polygons
+			for (int32 i = 0, Prev = Points.Num() - 1; i < Points.Num(); Prev = i++)
+			{
+				const FVector& A = Points[Prev];
+				const FVector& B = Points[i];
+				Normal.X += (A.Y - B.Y) * (A.Z + B.Z);
+				Normal.Y += (A.Z - B.Z) * (A.X + B.X);
+				Normal.Z += (A.X - B.X) * (A.Y + B.Y);
+			}
+			Normal = Normal.GetSafeNormal();
+		}
+
+		bool IsDegenerate() const
+		{
+			return Normal.IsZero();
+		}
+
+		/**
+		 * Crossing number test on the plane of the polygon, dropping the normal's dominant axis
+		 */
+		bool ContainsProjected(const FVector& Point) const
+		{
+			const FVector AbsNormal = Normal.GetAbs();
+			const int32 DropAxis = AbsNormal.X > AbsNormal.Y ? (AbsNormal.X > AbsNormal.Z ? 0 : 2) : (AbsNormal.Y > AbsNormal.Z ? 1 : 2);
+			const int32 U = DropAxis == 0 ? 1 : 0;
+			const int32 V = DropAxis == 2 ? 1 : 2;
+
+			bool bInside = false;
+			for (int32 i = 0, Prev = Points.Num() - 1; i < Points.Num(); Prev = i++)
+			{
+				const FVector& A = Points[i];
+				const FVector& B = Points[Prev];
+				if ((A[V] > Point[V]) != (B[V] > Point[V]))
+				{
+					const float Crossing = A[U] + (Point[V] - A[V]) * (B[U] - A[U]) / (B[V] - A[V]);
+					if (Point[U] < Crossing)
+					{
+						bInside = !bInside;
+					}
+				}
+			}
+			return bInside;
+		}
+
+		FVector ClosestPoint(const FVector& Point) const
+		{
+			if (!IsDegenerate())
+			{
+				const FVector Projected = Point - Normal * FVector::DotProduct(Point - Center, Normal);
+				if (ContainsProjected(Projected))
+				{
+					return Projected;
+				}
+			}
+			FVector Closest = Points[0];
+			float ClosestDistSquared = FVector::DistSquared(Point, Closest);
+			for (int32 i = 0, Prev = Points.Num() - 1; i < Points.Num(); Prev = i++)
+			{
+				const FVector OnEdge = FMath::ClosestPointOnSegment(Point, Points[Prev], Points[i]);
+				const float DistSquared = FVector::DistSquared(Point, OnEdge);
+				if (DistSquared < ClosestDistSquared)
+				{
+					ClosestDistSquared = DistSquared;
+					Closest = OnEdge;
+				}
+			}
+			return Closest;
+		}
+	};
+
+	/**
+	 * Slab test, returns the distance along the ray at which it enters the box.
+	 * Axes with an infinite inverse direction are parallel to the ray, and are tested on the start alone
+	 * since a start on a slab plane would give 0 * inf = NaN.
+	 */
+	bool IntersectRayBox(const FBox& Box, const FVector& Start, const FVector& InvDirection, float MaxDistance, float& OutDistance)
+	{
+		float TMin = 0.0f;
+		float TMax = MaxDistance;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (!FMath::IsFinite(InvDirection[Axis]))
+			{
+				if (Start[Axis] < Box.Min[Axis] || Start[Axis] > Box.Max[Axis])
+					return false;
+				continue;
+			}
+			float T0 = (Box.Min[Axis] - Start[Axis]) * InvDirection[Axis];
+			float T1 = (Box.Max[Axis] - Start[Axis]) * InvDirection[Axis];
+			if (T0 > T1)
+			{
+				Swap(T0, T1);
+			}
+			TMin = FMath::Max(TMin, T0);
+			TMax = FMath::Min(TMax, T1);
+			if (TMin > TMax)
+			{
+				return false;
+			}
+		}
+		OutDistance = TMin;
+		return true;
+	}
+}
+
+void FBMeshSpatialIndex::FTree::Build(TArrayView<const FVector> Centers)
+{
+	const int32 NumPrimitives = Centers.Num();
+	Nodes.Reset();
+	Primitives.SetNumUninitialized(NumPrimitives);
+	for (int32 i = 0; i < NumPrimitives; ++i)
+	{
+		Primitives[i] = i;
+	}
+	if (NumPrimitives == 0)
+	{
+		return;
+	}
+
+	// Top down median split along the longest axis of the primitive centers
+	Nodes.Reserve(2 * FMath::DivideAndRoundUp(NumPrimitives, MaxPrimitivesPerLeaf));
+	Nodes.Add(FNode{FBox(ForceInit), 0, NumPrimitives});
+	FNodeStack Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const int32 Start = Nodes[NodeIndex].Index;
+		const int32 Count = Nodes[NodeIndex].Count;
+		if (Count <= MaxPrimitivesPerLeaf)
+			continue;
+
+		FBox CenterBounds(ForceInit);
+		for (int32 i = Start; i < Start + Count; ++i)
+		{
+			CenterBounds += Centers[Primitives[i]];
+		}
+		const FVector Size = CenterBounds.GetSize();
+		const int32 Axis = Size.X > Size.Y ? (Size.X > Size.Z ? 0 : 2) : (Size.Y > Size.Z ? 1 : 2);
+		if (Size[Axis] <= 0.0f)
+			continue; // all centers are coincident, there is no useful split
+
+		const int32 Mid = Start + Count / 2;
+		int32* Begin = Primitives.GetData() + Start;
+		std::nth_element(Begin, Primitives.GetData() + Mid, Begin + Count, [&](int32 A, int32 B)
+		{
+			return Centers[A][Axis] < Centers[B][Axis];
+		});
+
+		const int32 ChildIndex = Nodes.Num();
+		Nodes.Add(FNode{FBox(ForceInit), Start, Mid - Start});
+		Nodes.Add(FNode{FBox(ForceInit), Mid, Start + Count - Mid});
+		Nodes[NodeIndex].Index = ChildIndex;
+		Nodes[NodeIndex].Count = 0;
+		Stack.Push(ChildIndex);
+		Stack.Push(ChildIndex + 1);
+	}
+}
+
+template <typename BoundsGetterType>
+void FBMeshSpatialIndex::FTree::Refit(BoundsGetterType&& GetBounds)
+{
+	ParallelFor(Nodes.Num(), [&](int32 NodeIndex)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		if (Node.Count > 0)
+		{
+			FBox Bounds(ForceInit);
+			for (int32 i = Node.Index; i < Node.Index + Node.Count; ++i)
+			{
+				Bounds += GetBounds(Primitives[i]);
+			}
+			Node.Bounds = Bounds;
+		}
+	});
+	for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; --NodeIndex)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		if (Node.Count == 0)
+		{
+			Node.Bounds = Nodes[Node.Index].Bounds + Nodes[Node.Index + 1].Bounds;
+		}
+	}
+}
+
+template <typename VisitorType>
+void FBMeshSpatialIndex::FTree::ForEachOverlappingLeaf(const FBox& Box, VisitorType&& Visit) const
+{
+	if (Nodes.Num() == 0)
+		return;
+	FNodeStack Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(false)];
+		if (!Node.Bounds.Intersect(Box))
+			continue;
+		if (Node.Count > 0)
+		{
+			for (int32 i = Node.Index; i < Node.Index + Node.Count; ++i)
+			{
+				Visit(Primitives[i]);
+			}
+		}
+		else
+		{
+			Stack.Push(Node.Index);
+			Stack.Push(Node.Index + 1);
+		}
+	}
+}
+
+void FBMeshSpatialIndex::Build(const UBMesh* Mesh)
+{
+	check(Mesh);
+	Vertices = Mesh->Vertices;
+	Faces = Mesh->Faces;
+	UpdatePrimitiveBounds();
+
+	TArray<FVector> FaceCenters;
+	FaceCenters.SetNumUninitialized(FaceBounds.Num());
+	ParallelFor(FaceBounds.Num(), [&](int32 FaceIndex)
+	{
+		FaceCenters[FaceIndex] = FaceBounds[FaceIndex].GetCenter();
+	});
+
+	VertexTree.Build(VertexLocations);
+	FaceTree.Build(FaceCenters);
+	VertexTree.Refit([this](int32 VertexIndex) { return FBox(VertexLocations[VertexIndex], VertexLocations[VertexIndex]); });
+	FaceTree.Refit([this](int32 FaceIndex) { return FaceBounds[FaceIndex]; });
+}
+
+void FBMeshSpatialIndex::Refit()
+{
+	UpdatePrimitiveBounds();
+	VertexTree.Refit([this](int32 VertexIndex) { return FBox(VertexLocations[VertexIndex], VertexLocations[VertexIndex]); });
+	FaceTree.Refit([this](int32 FaceIndex) { return FaceBounds[FaceIndex]; });
+}
+
+void FBMeshSpatialIndex::Reset()
+{
+	VertexTree = FTree();
+	FaceTree = FTree();
+	Vertices.Reset();
+	Faces.Reset();
+	VertexLocations.Reset();
+	FaceBounds.Reset();
+}
+
+void FBMeshSpatialIndex::UpdatePrimitiveBounds()
+{
+	VertexLocations.SetNumUninitialized(Vertices.Num());
+	ParallelFor(Vertices.Num(), [&](int32 VertexIndex)
+	{
+		VertexLocations[VertexIndex] = Vertices[VertexIndex]->Location;
+	});
+	FaceBounds.SetNumUninitialized(Faces.Num());
+	ParallelFor(Faces.Num(), [&](int32 FaceIndex)
+	{
+		FBox Bounds(ForceInit);
+		for (const UBMeshVertex* Vert : Faces[FaceIndex]->Vertices())
+		{
+			Bounds += Vert->Location;
+		}
+		FaceBounds[FaceIndex] = Bounds;
+	});
+}
+
+UBMeshVertex* FBMeshSpatialIndex::FindNearestVertex(const FVector& Point, float MaxDistance) const
+{
+	if (VertexTree.Nodes.Num() == 0)
+		return nullptr;
+
+	double BestDistSquared = FMath::Square((double)MaxDistance);
+	int32 BestIndex = INDEX_NONE;
+	FNodeStack Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = VertexTree.Nodes[Stack.Pop(false)];
+		if (Node.Bounds.ComputeSquaredDistanceToPoint(Point) > BestDistSquared)
+			continue;
+		if (Node.Count > 0)
+		{
+			for (int32 i = Node.Index; i < Node.Index + Node.Count; ++i)
+			{
+				const int32 VertexIndex = VertexTree.Primitives[i];
+				const double DistSquared = FVector::DistSquared(VertexLocations[VertexIndex], Point);
+				if (DistSquared <= BestDistSquared)
+				{
+					BestDistSquared = DistSquared;
+					BestIndex = VertexIndex;
+				}
+			}
+		}
+		else
+		{
+			// Push the farthest child first so the nearest one is visited first and tightens the bound sooner
+			const double DistA = VertexTree.Nodes[Node.Index].Bounds.ComputeSquaredDistanceToPoint(Point);
+			const double DistB = VertexTree.Nodes[Node.Index + 1].Bounds.ComputeSquaredDistanceToPoint(Point);
+			Stack.Push(DistA < DistB ? Node.Index + 1 : Node.Index);
+			Stack.Push(DistA < DistB ? Node.Index : Node.Index + 1);
+		}
+	}
+	return BestIndex != INDEX_NONE ? Vertices[BestIndex] : nullptr;
+}
+
+UBMeshFace* FBMeshSpatialIndex::FindNearestFace(const FVector& Point, float MaxDistance, FVector* OutClosestPoint) const
+{
+	if (FaceTree.Nodes.Num() == 0)
+		return nullptr;
+
+	double BestDistSquared = FMath::Square((double)MaxDistance);
+	int32 BestIndex = INDEX_NONE;
+	FVector BestPoint = Point;
+	FNodeStack Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = FaceTree.Nodes[Stack.Pop(false)];
+		if (Node.Bounds.ComputeSquaredDistanceToPoint(Point) > BestDistSquared)
+			continue;
+		if (Node.Count > 0)
+		{
+			for (int32 i = Node.Index; i < Node.Index + Node.Count; ++i)
+			{
+				const int32 FaceIndex = FaceTree.Primitives[i];
+				if (FaceBounds[FaceIndex].ComputeSquaredDistanceToPoint(Point) > BestDistSquared)
+					continue;
+				const FVector Closest = FPolygon(Faces[FaceIndex]).ClosestPoint(Point);
+				const double DistSquared = FVector::DistSquared(Closest, Point);
+				if (DistSquared <= BestDistSquared)
+				{
+					BestDistSquared = DistSquared;
+					BestIndex = FaceIndex;
+					BestPoint = Closest;
+				}
+			}
+		}
+		else
+		{
+			const double DistA = FaceTree.Nodes[Node.Index].Bounds.ComputeSquaredDistanceToPoint(Point);
+			const double DistB = FaceTree.Nodes[Node.Index + 1].Bounds.ComputeSquaredDistanceToPoint(Point);
+			Stack.Push(DistA < DistB ? Node.Index + 1 : Node.Index);
+			Stack.Push(DistA < DistB ? Node.Index : Node.Index + 1);
+		}
+	}
+	if (BestIndex == INDEX_NONE)
+		return nullptr;
+	if (OutClosestPoint)
+	{
+		*OutClosestPoint = BestPoint;
+	}
+	return Faces[BestIndex];
+}
+
+void FBMeshSpatialIndex::FindVerticesInRadius(const FVector& Center, float Radius, TArray<UBMeshVertex*>& OutVertices) const
+{
+	const double RadiusSquared = FMath::Square((double)Radius);
+	VertexTree.ForEachOverlappingLeaf(FBox(Center - FVector(Radius), Center + FVector(Radius)), [&](int32 VertexIndex)
+	{
+		if (FVector::DistSquared(VertexLocations[VertexIndex], Center) <= RadiusSquared)
+		{
+			OutVertices.Add(Vertices[VertexIndex]);
+		}
+	});
+}
+
+void FBMeshSpatialIndex::FindFacesInRadius(const FVector& Center, float Radius, TArray<UBMeshFace*>& OutFaces) const
+{
+	const double RadiusSquared = FMath::Square((double)Radius);
+	FaceTree.ForEachOverlappingLeaf(FBox(Center - FVector(Radius), Center + FVector(Radius)), [&](int32 FaceIndex)
+	{
+		if (FaceBounds[FaceIndex].ComputeSquaredDistanceToPoint(Center) > RadiusSquared)
+			return;
+		if (FVector::DistSquared(FPolygon(Faces[FaceIndex]).ClosestPoint(Center), Center) <= RadiusSquared)
+		{
+			OutFaces.Add(Faces[FaceIndex]);
+		}
+	});
+}
+
+void FBMeshSpatialIndex::FindVerticesInBox(const FBox& Box, TArray<UBMeshVertex*>& OutVertices) const
+{
+	VertexTree.ForEachOverlappingLeaf(Box, [&](int32 VertexIndex)
+	{
+		if (Box.IsInsideOrOn(VertexLocations[VertexIndex]))
+		{
+			OutVertices.Add(Vertices[VertexIndex]);
+		}
+	});
+}
+
+void FBMeshSpatialIndex::FindFacesInBox(const FBox& Box, TArray<UBMeshFace*>& OutFaces) const
+{
+	FaceTree.ForEachOverlappingLeaf(Box, [&](int32 FaceIndex)
+	{
+		if (FaceBounds[FaceIndex].Intersect(Box))
+		{
+			OutFaces.Add(Faces[FaceIndex]);
+		}
+	});
+}
+
+bool FBMeshSpatialIndex::Raycast(const FVector& Start, const FVector& Direction, float MaxDistance, FBMeshRayHit& OutHit) const
+{
+	const FVector Dir = Direction.GetSafeNormal();
+	if (FaceTree.Nodes.Num() == 0 || Dir.IsZero())
+		return false;
+
+	// Division by zero gives infinities, which the slab test treats as axes parallel to the ray
+	const FVector InvDirection(1.0f / Dir.X, 1.0f / Dir.Y, 1.0f / Dir.Z);
+	float BestDistance = MaxDistance;
+	int32 BestIndex = INDEX_NONE;
+	FNodeStack Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = FaceTree.Nodes[Stack.Pop(false)];
+		float EntryDistance;
+		if (!IntersectRayBox(Node.Bounds, Start, InvDirection, BestDistance, EntryDistance))
+			continue;
+		if (Node.Count > 0)
+		{
+			for (int32 i = Node.Index; i < Node.Index + Node.Count; ++i)
+			{
+				const int32 FaceIndex = FaceTree.Primitives[i];
+				if (!IntersectRayBox(FaceBounds[FaceIndex], Start, InvDirection, BestDistance, EntryDistance))
+					continue;
+				const FPolygon Polygon(Faces[FaceIndex]);
+				const float Denominator = FVector::DotProduct(Polygon.Normal, Dir);
+				if (Polygon.IsDegenerate() || FMath::IsNearlyZero(Denominator))
+					continue;
+				const float Distance = FVector::DotProduct(Polygon.Center - Start, Polygon.Normal) / Denominator;
+				if (Distance < 0.0f || Distance > BestDistance)
+					continue;
+				if (Polygon.ContainsProjected(Start + Dir * Distance))
+				{
+					BestDistance = Distance;
+					BestIndex = FaceIndex;
+				}
+			}
+		}
+		else
+		{
+			Stack.Push(Node.Index);
+			Stack.Push(Node.Index + 1);
+		}
+	}
+	if (BestIndex == INDEX_NONE)
+		return false;
+	OutHit.Face = Faces[BestIndex];
+	OutHit.Distance = BestDistance;
+	OutHit.Location = Start + Dir * BestDistance;
+	return true;
+}
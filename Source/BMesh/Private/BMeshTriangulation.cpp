@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BMeshTriangulation.h"
+
+#include "Async/ParallelFor.h"
+
+#include "BMeshCore.h"
+
+namespace
+{
+	double Orientation2D(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+	{
+		return FVector2D::CrossProduct(B - A, C - A);
+	}
+
+	bool IsInTriangle2D(const FVector2D& P, const FVector2D& A, const FVector2D& B, const FVector2D& C)
+	{
+		return Orientation2D(A, B, P) >= 0 && Orientation2D(B, C, P) >= 0 && Orientation2D(C, A, P) >= 0;
+	}
+}
+
+FBMeshTriangulation FBMeshTriangulation::Build(const UBMesh* Mesh, EBMeshTriangulationMethod Method)
+{
+	check(Mesh);
+	return Build(Mesh->Faces, Method);
+}
+
+FBMeshTriangulation FBMeshTriangulation::Build(TArrayView<UBMeshFace* const> Faces, EBMeshTriangulationMethod Method)
+{
+	const int32 NumFaces = Faces.Num();
+
+	FBMeshTriangulation Result;
+	Result.LoopOffsets.SetNumUninitialized(NumFaces + 1);
+	Result.TriangleOffsets.SetNumUninitialized(NumFaces + 1);
+	Result.LoopOffsets[0] = 0;
+	Result.TriangleOffsets[0] = 0;
+	for (int32 i = 0; i < NumFaces; ++i)
+	{
+		const int32 VertCount = Faces[i]->VertCount;
+		Result.LoopOffsets[i + 1] = Result.LoopOffsets[i] + VertCount;
+		Result.TriangleOffsets[i + 1] = Result.TriangleOffsets[i] + FMath::Max(VertCount - 2, 0);
+	}
+	Result.Loops.SetNumUninitialized(Result.LoopOffsets[NumFaces]);
+	Result.Triangles.SetNumUninitialized(Result.TriangleOffsets[NumFaces]);
+
+	ParallelFor(NumFaces, [&Result, Faces, Method](int32 FaceIndex)
+	{
+		const UBMeshFace* Face = Faces[FaceIndex];
+		const int32 FirstLoop = Result.LoopOffsets[FaceIndex];
+		const int32 NumLoops = Result.LoopOffsets[FaceIndex + 1] - FirstLoop;
+
+		TArray<FVector, TInlineAllocator<16>> Polygon;
+		Polygon.Reserve(NumLoops);
+		for (UBMeshLoop* Loop : Face->Loops())
+		{
+			check(Polygon.Num() < NumLoops);
+			Result.Loops[FirstLoop + Polygon.Num()] = Loop;
+			Polygon.Add(Loop->Vert->Location);
+		}
+		check(Polygon.Num() == NumLoops);
+		if (NumLoops < 3)
+			return;
+
+		const int32 FirstTriangle = Result.TriangleOffsets[FaceIndex];
+		TArrayView<FIntVector> Triangles(&Result.Triangles[FirstTriangle], NumLoops - 2);
+		if (Method == EBMeshTriangulationMethod::Fan)
+		{
+			for (int32 i = 0; i < Triangles.Num(); ++i)
+			{
+				Triangles[i] = FIntVector(0, i + 1, i + 2);
+			}
+		}
+		else
+		{
+			TriangulatePolygon(Polygon, Triangles);
+		}
+		for (FIntVector& Triangle : Triangles)
+		{
+			Triangle += FIntVector(FirstLoop);
+		}
+	});
+	return Result;
+}
+
+void FBMeshTriangulation::TriangulatePolygon(TArrayView<const FVector> Polygon, TArrayView<FIntVector> OutTriangles)
+{
+	const int32 NumCorners = Polygon.Num();
+	check(NumCorners >= 3 && OutTriangles.Num() == NumCorners - 2);
+	if (NumCorners == 3)
+	{
+		OutTriangles[0] = FIntVector(0, 1, 2);
+		return;
+	}
+
+	// Newell's method, the normal follows the winding of the polygon even if it's concave
+	FVector Normal = FVector::ZeroVector;
+	for (int32 i = 0, i_prev = NumCorners - 1; i < NumCorners; i_prev = i++)
+	{
+		const FVector& A = Polygon[i_prev];
+		const FVector& B = Polygon[i];
+		Normal.X += (A.Y - B.Y) * (A.Z + B.Z);
+		Normal.Y += (A.Z - B.Z) * (A.X + B.X);
+		Normal.Z += (A.X - B.X) * (A.Y + B.Y);
+	}
+
+	TArray<int32, TInlineAllocator<16>> Remaining;
+	for (int32 i = 0; i < NumCorners; ++i)
+	{
+		Remaining.Add(i);
+	}
+	int32 NumTriangles = 0;
+
+	if (Normal.Normalize())
+	{
+		// Right handed basis around the normal, so the polygon winds counter clockwise in it
+		FVector AxisX, AxisY;
+		Normal.FindBestAxisVectors(AxisX, AxisY);
+		AxisY = Normal ^ AxisX;
+
+		TArray<FVector2D, TInlineAllocator<16>> Points;
+		for (const FVector& Corner : Polygon)
+		{
+			Points.Add(FVector2D(Corner | AxisX, Corner | AxisY));
+		}
+
+		int32 Candidate = 0;
+		int32 NumTried = 0;
+		while (Remaining.Num() > 3 && NumTried < Remaining.Num())
+		{
+			const int32 Num = Remaining.Num();
+			const int32 Prev = Remaining[(Candidate + Num - 1) % Num];
+			const int32 Current = Remaining[Candidate];
+			const int32 Next = Remaining[(Candidate + 1) % Num];
+
+			bool bIsEar = Orientation2D(Points[Prev], Points[Current], Points[Next]) > 0;
+			for (int32 i = 0; i < Num && bIsEar; ++i)
+			{
+				const int32 Other = Remaining[i];
+				if (Other == Prev || Other == Current || Other == Next
+					|| Points[Other] == Points[Prev] || Points[Other] == Points[Current] || Points[Other] == Points[Next])
+					continue;
+				bIsEar = !IsInTriangle2D(Points[Other], Points[Prev], Points[Current], Points[Next]);
+			}
+
+			if (bIsEar)
+			{
+				OutTriangles[NumTriangles++] = FIntVector(Prev, Current, Next);
+				Remaining.RemoveAt(Candidate);
+				Candidate = Candidate % Remaining.Num();
+				NumTried = 0;
+			}
+			else
+			{
+				Candidate = (Candidate + 1) % Num;
+				++NumTried;
+			}
+		}
+	}
+
+	// The last triangle, or what's left of a polygon without ears
+	for (int32 i = 1; i + 1 < Remaining.Num(); ++i)
+	{
+		OutTriangles[NumTriangles++] = FIntVector(Remaining[0], Remaining[i], Remaining[i + 1]);
+	}
+	check(NumTriangles == NumCorners - 2);
+}
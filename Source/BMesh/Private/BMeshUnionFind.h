@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+
+/**
+ * Lock free union-find over a fixed number of elements. Unite and Find may be called from
+ * several threads at once, e.g. from the body of a ParallelFor.
+ *
+ * Roots are always linked under the root with the lowest index, so every element's parent
+ * has a lower index than itself. This rules out cycles without locking, and the root of a
+ * set is always its lowest element, so labels don't depend on thread scheduling.
+ */
+class FBMeshConcurrentUnionFind
+{
+public:
+	explicit FBMeshConcurrentUnionFind(int32 Num)
+	{
+		Parents.SetNumUninitialized(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Parents[Index] = Index;
+		}
+	}
+
+	int32 Num() const
+	{
+		return Parents.Num();
+	}
+
+	int32 Find(int32 Element)
+	{
+		while (true)
+		{
+			const int32 Parent = FPlatformAtomics::AtomicRead(&Parents[Element]);
+			if (Parent == Element)
+			{
+				return Element;
+			}
+			const int32 GrandParent = FPlatformAtomics::AtomicRead(&Parents[Parent]);
+			if (GrandParent != Parent)
+			{
+				// Path halving, it's fine for this to fail if another thread relinked the element first
+				FPlatformAtomics::InterlockedCompareExchange(&Parents[Element], GrandParent, Parent);
+			}
+			Element = GrandParent;
+		}
+	}
+
+	void Unite(int32 A, int32 B)
+	{
+		while (true)
+		{
+			A = Find(A);
+			B = Find(B);
+			if (A == B)
+			{
+				return;
+			}
+			if (A > B)
+			{
+				Swap(A, B);
+			}
+			// Only succeeds if B is still a root, otherwise another thread linked it first and we retry from the new roots
+			if (FPlatformAtomics::InterlockedCompareExchange(&Parents[B], A, B) == B)
+			{
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Assign dense set ids to all elements, ordered by the lowest element of each set,
+	 * and count the elements in each set.
+	 */
+	void Label(TArray<int32>& OutIds, TArray<int32>& OutSizes)
+	{
+		const int32 NumElements = Parents.Num();
+		OutIds.SetNumUninitialized(NumElements);
+		ParallelFor(NumElements, [&](int32 Index)
+		{
+			OutIds[Index] = Find(Index);
+		});
+
+		// Roots are the lowest element of their set, so they are always relabeled before the rest of it
+		OutSizes.Reset();
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			const int32 Root = OutIds[Index];
+			if (Root == Index)
+			{
+				OutIds[Index] = OutSizes.Add(1);
+			}
+			else
+			{
+				const int32 SetId = OutIds[Root];
+				OutIds[Index] = SetId;
+				++OutSizes[SetId];
+			}
+		}
+	}
+
+private:
+	TArray<int32> Parents;
+};
@@ -63,6 +63,9 @@
 
 #include "CoreMinimal.h"
 
+#include "BMeshHandle.h"
+#include "BMeshAttributeLayers.h"
+
 #include "BMesh.generated.h"
 
 class UBMeshVertex;
@@ -114,6 +117,12 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ExposeOnSpawn))
 	TSubclassOf<UBMeshFace> FaceClass;
 
+	// Attribute layers, custom attributes stored per container instead of as element class properties
+	FBMeshAttributeLayers VertexLayers;
+	FBMeshAttributeLayers EdgeLayers;
+	FBMeshAttributeLayers LoopLayers;
+	FBMeshAttributeLayers FaceLayers;
+
 	///////////////////////////////////////////////////////////////////////////
 	//#region [Topology Methods]
 
@@ -261,6 +270,172 @@ public:
 	UFUNCTION(BlueprintCallable, Category="BMesh", meta=(DisplayName="Remove Face"))
 	bool K2_RemoveFace(UBMeshFace* e);
 
+	/**
+	 * Take an element out of its container without touching the topology. This is meant for
+	 * operators that unlink elements themselves, everything else should use the Remove methods.
+	 * Deferred while a FBMeshDeferredRemovalScope is alive.
+	 */
+	void RemoveFromContainer(UBMeshVertex* v);
+	void RemoveFromContainer(UBMeshEdge* e);
+	void RemoveFromContainer(UBMeshLoop* l);
+	void RemoveFromContainer(UBMeshFace* f);
+
+	/**
+	 * Append an element to its container and set its Index. This is meant for operators that create
+	 * and link elements themselves, everything else should use the Add methods.
+	 */
+	void AddToContainer(UBMeshVertex* v);
+	void AddToContainer(UBMeshEdge* e);
+	void AddToContainer(UBMeshLoop* l);
+	void AddToContainer(UBMeshFace* f);
+
+	/**
+	 * Set the Index of every element to its position in its container. Adding, removing and sorting
+	 * elements through the mesh and the operators keep indices up to date, this is only needed after
+	 * writing to the containers directly. Attribute layers aren't reordered along with the elements, so
+	 * their values are only meaningful if the containers were written without reordering.
+	 */
+	void UpdateElementIndices();
+
+	/**
+	 * Counter bumped whenever elements are added, removed or reordered, or relinked by an operator,
+	 * so data built from the topology can tell it's stale. Moving vertices doesn't change it.
+	 */
+	uint32 GetTopologyRevision() const { return TopologyRevision; }
+
+	/**
+	 * Bump the topology revision, for code that relinks or reorders elements without adding or removing any
+	 */
+	void MarkTopologyChanged() { ++TopologyRevision; }
+
+	/**
+	 * Get a handle to a vertex of this mesh, which can be kept instead of the vertex itself to check in
+	 * constant time whether it is still in the mesh. Unset if the vertex isn't in the mesh.
+	 */
+	UFUNCTION(BlueprintPure, Category="BMesh")
+	FBMeshVertexHandle GetVertexHandle(const UBMeshVertex* v) const;
+
+	/**
+	 * Get the vertex a handle refers to, or null if it has been removed from the mesh since.
+	 */
+	UFUNCTION(BlueprintPure, Category="BMesh")
+	UBMeshVertex* ResolveVertexHandle(FBMeshVertexHandle Handle) const;
+
+	/**
+	 * Get a handle to a face of this mesh, see GetVertexHandle. Unset if the face isn't in the mesh.
+	 */
+	UFUNCTION(BlueprintPure, Category="BMesh")
+	FBMeshFaceHandle GetFaceHandle(const UBMeshFace* f) const;
+
+	/**
+	 * Get the face a handle refers to, or null if it has been removed from the mesh since.
+	 */
+	UFUNCTION(BlueprintPure, Category="BMesh")
+	UBMeshFace* ResolveFaceHandle(FBMeshFaceHandle Handle) const;
+
+	bool IsRemovalDeferred() const { return DeferredRemovalDepth > 0; }
+
+	///////////////////////////////////////////////////////////////////////////
+	//#region [Attribute Layers]
+
+	/**
+	 * Add an attribute layer to the elements of a type, or get the existing layer with this name.
+	 * Values are zero for existing elements and for elements added later, and follow their element
+	 * when elements are removed or reordered. Values are copied and interpolated by operators along
+	 * with element class attributes.
+	 * The returned view is invalidated when elements of this type are added or removed.
+	 * @retval empty view if a layer with this name but another type exists
+	 */
+	template <typename T>
+	TArrayView<T> AddAttribute(EBMeshElementType ElementType, FName Name)
+	{
+		TBMeshAttributeLayer<T>* Layer = GetAttributeLayers(ElementType).Add<T>(Name, GetNumElements(ElementType));
+		return Layer ? TArrayView<T>(Layer->Values) : TArrayView<T>();
+	}
+
+	/**
+	 * Get the values of an attribute layer, indexed like the elements' container.
+	 * @retval empty view if there is no layer with this name and type
+	 */
+	template <typename T>
+	TArrayView<T> FindAttribute(EBMeshElementType ElementType, FName Name)
+	{
+		TBMeshAttributeLayer<T>* Layer = GetAttributeLayers(ElementType).Find<T>(Name);
+		return Layer ? TArrayView<T>(Layer->Values) : TArrayView<T>();
+	}
+
+	template <typename T>
+	TArrayView<T> AddVertexAttribute(FName Name) { return AddAttribute<T>(EBMeshElementType::Vertex, Name); }
+
+	template <typename T>
+	TArrayView<T> AddEdgeAttribute(FName Name) { return AddAttribute<T>(EBMeshElementType::Edge, Name); }
+
+	template <typename T>
+	TArrayView<T> AddLoopAttribute(FName Name) { return AddAttribute<T>(EBMeshElementType::Loop, Name); }
+
+	template <typename T>
+	TArrayView<T> AddFaceAttribute(FName Name) { return AddAttribute<T>(EBMeshElementType::Face, Name); }
+
+	FBMeshAttributeLayers& GetAttributeLayers(EBMeshElementType ElementType);
+	const FBMeshAttributeLayers& GetAttributeLayers(EBMeshElementType ElementType) const;
+
+	int32 GetNumElements(EBMeshElementType ElementType) const;
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool AddAttributeLayer(EBMeshElementType ElementType, FName Name, EBMeshAttributeType Type);
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool RemoveAttributeLayer(EBMeshElementType ElementType, FName Name);
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	bool HasAttributeLayer(EBMeshElementType ElementType, FName Name) const;
+
+	// Bulk getters, values are in the order of the elements' container. Empty if there is no layer with this name and type
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	TArray<float> GetFloatAttribute(EBMeshElementType ElementType, FName Name) const;
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	TArray<int32> GetIntAttribute(EBMeshElementType ElementType, FName Name) const;
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	TArray<FVector> GetVectorAttribute(EBMeshElementType ElementType, FName Name) const;
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	TArray<FVector2D> GetVector2DAttribute(EBMeshElementType ElementType, FName Name) const;
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	TArray<FVector4> GetVector4Attribute(EBMeshElementType ElementType, FName Name) const;
+
+	UFUNCTION(BlueprintPure, Category="BMesh|Attributes")
+	TArray<FLinearColor> GetLinearColorAttribute(EBMeshElementType ElementType, FName Name) const;
+
+	// Bulk setters, which fail if there is no layer with this name and type or if the number of values doesn't match
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool SetFloatAttribute(EBMeshElementType ElementType, FName Name, const TArray<float>& Values);
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool SetIntAttribute(EBMeshElementType ElementType, FName Name, const TArray<int32>& Values);
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool SetVectorAttribute(EBMeshElementType ElementType, FName Name, const TArray<FVector>& Values);
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool SetVector2DAttribute(EBMeshElementType ElementType, FName Name, const TArray<FVector2D>& Values);
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool SetVector4Attribute(EBMeshElementType ElementType, FName Name, const TArray<FVector4>& Values);
+
+	UFUNCTION(BlueprintCallable, Category="BMesh|Attributes")
+	bool SetLinearColorAttribute(EBMeshElementType ElementType, FName Name, const TArray<FLinearColor>& Values);
+
+	/**
+	 * When saved to or loaded from a package, elements are not written as their own objects but packed
+	 * as index based topology arrays and per-class attribute columns, see FBMeshCustomVersion.
+	 */
+	virtual void Serialize(FArchive& Ar) override;
+
 	struct BMESH_API FMakeParams
 	{
 		TSubclassOf<UBMeshVertex> VertexClass;
@@ -273,7 +448,17 @@ public:
 
 	static UBMesh* Make(UObject* Outer = GetTransientPackage(), FMakeParams Params = FMakeParams());
 
-	//Updates each element's Id field to contain its index into its container
+	/**
+	 * Make a deep copy of this mesh, with the same element classes and copies of all elements and
+	 * their attributes. Elements are duplicated in bulk and linked through an old-to-new remap (see
+	 * FBMeshOperators::Merge), which is much faster than rebuilding the mesh with AddVertex/AddFace.
+	 * @param Outer outer of the new mesh, the transient package if null
+	 */
+	UFUNCTION(BlueprintCallable, Category="BMesh")
+	UBMesh* Clone(UObject* Outer = nullptr) const;
+
+	//Updates each element's Id field to contain its index into its container.
+	//Operators use each element's Index instead, which is always up to date and leaves Id to users
 	template <typename T>
 	void UpdateElementIds();
 	
@@ -291,6 +476,55 @@ public:
 	
 	template<>
 	TArray<UBMeshLoop*>& GetElementContainer() { return Loops; }
+
+private:
+	friend struct FBMeshDeferredRemovalScope;
+
+	void SerializePacked(FArchive& Ar);
+
+	void SerializeHandles(FArchive& Ar);
+
+	void ResetHandles();
+
+	void SerializeLayers(FArchive& Ar);
+
+	void ResetLayers();
+
+	void FlushDeferredRemovals();
+
+	int32 DeferredRemovalDepth = 0;
+
+	uint32 TopologyRevision = 0;
+
+	// Elements pending removal, they are still referenced by the containers until flushed
+	TSet<UBMeshVertex*> DeferredVertexRemovals;
+	TSet<UBMeshEdge*> DeferredEdgeRemovals;
+	TSet<UBMeshLoop*> DeferredLoopRemovals;
+	TSet<UBMeshFace*> DeferredFaceRemovals;
+
+	// Slots backing the handles to vertices and faces, they don't keep elements alive
+	TBMeshSlotTable<UBMeshVertex> VertexSlots;
+	TBMeshSlotTable<UBMeshFace> FaceSlots;
+};
+
+/**
+ * While a scope is alive, elements removed from the mesh are unlinked from the topology right away,
+ * but they are only taken out of the element containers once the outermost scope ends, with a single
+ * pass over each container. This makes each removal constant time instead of a linear search, which
+ * matters for operators that remove many elements.
+ * Inside the scope, removed elements are still present in the containers and must be skipped by
+ * code iterating over them.
+ */
+struct BMESH_API FBMeshDeferredRemovalScope
+{
+	explicit FBMeshDeferredRemovalScope(UBMesh* InMesh);
+	~FBMeshDeferredRemovalScope();
+
+	FBMeshDeferredRemovalScope(const FBMeshDeferredRemovalScope&) = delete;
+	FBMeshDeferredRemovalScope& operator=(const FBMeshDeferredRemovalScope&) = delete;
+
+private:
+	UBMesh* Mesh;
 };
 
 template <typename T>
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BMeshAttributeLayers.generated.h"
+
+UENUM(BlueprintType)
+enum class EBMeshElementType : uint8
+{
+	Vertex,
+	Edge,
+	Loop,
+	Face,
+};
+
+/**
+ * Value types of attribute layers
+ */
+UENUM(BlueprintType)
+enum class EBMeshAttributeType : uint8
+{
+	Float,
+	Int,
+	Vector,
+	Vector2D,
+	Vector4,
+	LinearColor,
+};
+
+template <typename T>
+struct TBMeshAttributeType;
+
+template <> struct TBMeshAttributeType<float> { static constexpr EBMeshAttributeType Value = EBMeshAttributeType::Float; };
+template <> struct TBMeshAttributeType<int32> { static constexpr EBMeshAttributeType Value = EBMeshAttributeType::Int; };
+template <> struct TBMeshAttributeType<FVector> { static constexpr EBMeshAttributeType Value = EBMeshAttributeType::Vector; };
+template <> struct TBMeshAttributeType<FVector2D> { static constexpr EBMeshAttributeType Value = EBMeshAttributeType::Vector2D; };
+template <> struct TBMeshAttributeType<FVector4> { static constexpr EBMeshAttributeType Value = EBMeshAttributeType::Vector4; };
+template <> struct TBMeshAttributeType<FLinearColor> { static constexpr EBMeshAttributeType Value = EBMeshAttributeType::LinearColor; };
+
+/**
+ * Set the value of element Destination to value[A] * (1 - Alpha) + value[B] * Alpha, indices being the
+ * indices of elements in their container
+ */
+struct FBMeshAttributeLerp
+{
+	int32 Destination;
+	int32 A;
+	int32 B;
+	float Alpha;
+};
+
+/**
+ * Named column of values, one per element of a container and in the same order.
+ * See FBMeshAttributeLayers.
+ */
+class BMESH_API FBMeshAttributeLayer
+{
+public:
+	FBMeshAttributeLayer(FName InName, EBMeshAttributeType InType)
+		: Name(InName), Type(InType)
+	{
+	}
+
+	virtual ~FBMeshAttributeLayer() {}
+
+	FName GetName() const { return Name; }
+
+	EBMeshAttributeType GetType() const { return Type; }
+
+	virtual int32 Num() const = 0;
+
+	/** Resize to a number of elements, new values are zero */
+	virtual void SetNum(int32 NumElements) = 0;
+
+	virtual void RemoveAt(int32 Index) = 0;
+
+	/** Replace values by Values[Sources[i]], which both reorders and compacts the layer */
+	virtual void Gather(const TArray<int32>& Sources) = 0;
+
+	virtual void Copy(int32 Destination, int32 Source) = 0;
+
+	/** Copy a value from a layer of the same type, usually of another mesh */
+	virtual void CopyFrom(const FBMeshAttributeLayer& Other, int32 Destination, int32 Source) = 0;
+
+	virtual void Lerp(int32 Destination, int32 A, int32 B, float Alpha) = 0;
+
+	virtual void LerpBatch(TArrayView<const FBMeshAttributeLerp> Lerps) = 0;
+
+	virtual void Serialize(FArchive& Ar) = 0;
+
+	static TUniquePtr<FBMeshAttributeLayer> Make(FName Name, EBMeshAttributeType Type);
+
+private:
+	FName Name;
+	EBMeshAttributeType Type;
+};
+
+template <typename T>
+class TBMeshAttributeLayer : public FBMeshAttributeLayer
+{
+public:
+	explicit TBMeshAttributeLayer(FName InName)
+		: FBMeshAttributeLayer(InName, TBMeshAttributeType<T>::Value)
+	{
+	}
+
+	TArray<T> Values;
+
+	int32 Num() const override { return Values.Num(); }
+
+	void SetNum(int32 NumElements) override
+	{
+		if (NumElements > Values.Num())
+		{
+			Values.AddZeroed(NumElements - Values.Num());
+		}
+		else
+		{
+			Values.SetNum(NumElements);
+		}
+	}
+
+	void RemoveAt(int32 Index) override { Values.RemoveAt(Index); }
+
+	void Gather(const TArray<int32>& Sources) override
+	{
+		TArray<T> Gathered;
+		Gathered.SetNumUninitialized(Sources.Num());
+		for (int32 i = 0; i < Sources.Num(); ++i)
+		{
+			Gathered[i] = Values[Sources[i]];
+		}
+		Values = MoveTemp(Gathered);
+	}
+
+	void Copy(int32 Destination, int32 Source) override { Values[Destination] = Values[Source]; }
+
+	void CopyFrom(const FBMeshAttributeLayer& Other, int32 Destination, int32 Source) override
+	{
+		check(Other.GetType() == GetType());
+		Values[Destination] = static_cast<const TBMeshAttributeLayer<T>&>(Other).Values[Source];
+	}
+
+	void Lerp(int32 Destination, int32 A, int32 B, float Alpha) override
+	{
+		Values[Destination] = FMath::Lerp(Values[A], Values[B], Alpha);
+	}
+
+	void LerpBatch(TArrayView<const FBMeshAttributeLerp> Lerps) override
+	{
+		T* Data = Values.GetData();
+		for (const FBMeshAttributeLerp& Lerp : Lerps)
+		{
+			Data[Lerp.Destination] = FMath::Lerp(Data[Lerp.A], Data[Lerp.B], Lerp.Alpha);
+		}
+	}
+
+	void Serialize(FArchive& Ar) override { Values.BulkSerialize(Ar); }
+};
+
+/**
+ * Custom attributes of the elements of one container of a mesh, stored as one contiguous array per
+ * attribute instead of as properties of an element subclass, so passes over one attribute only touch
+ * its values. Layers are indexed like the container (see UBMeshVertex::Index) and are kept in sync
+ * with it by the mesh when elements are added, removed or reordered.
+ */
+class BMESH_API FBMeshAttributeLayers
+{
+public:
+	FBMeshAttributeLayers() = default;
+	FBMeshAttributeLayers(const FBMeshAttributeLayers&) = delete;
+	FBMeshAttributeLayers& operator=(const FBMeshAttributeLayers&) = delete;
+
+	/**
+	 * Add a layer, or get the existing layer with this name if it has the same type
+	 * @retval null if a layer with this name but another type exists
+	 */
+	FBMeshAttributeLayer* Add(FName Name, EBMeshAttributeType Type, int32 NumElements);
+
+	template <typename T>
+	TBMeshAttributeLayer<T>* Add(FName Name, int32 NumElements)
+	{
+		return static_cast<TBMeshAttributeLayer<T>*>(Add(Name, TBMeshAttributeType<T>::Value, NumElements));
+	}
+
+	FBMeshAttributeLayer* Find(FName Name) const;
+
+	/** @retval null if there is no layer with this name and type */
+	template <typename T>
+	TBMeshAttributeLayer<T>* Find(FName Name) const
+	{
+		FBMeshAttributeLayer* Layer = Find(Name);
+		return Layer && Layer->GetType() == TBMeshAttributeType<T>::Value ? static_cast<TBMeshAttributeLayer<T>*>(Layer) : nullptr;
+	}
+
+	bool Remove(FName Name);
+
+	int32 Num() const { return Layers.Num(); }
+
+	bool IsEmpty() const { return Layers.Num() == 0; }
+
+	FBMeshAttributeLayer& operator[](int32 Index) const { return *Layers[Index]; }
+
+	void Reset() { Layers.Reset(); }
+
+	// Container operations, mirrored on every layer
+
+	void AddElement();
+
+	void RemoveElementAt(int32 Index);
+
+	void Gather(const TArray<int32>& Sources);
+
+	// Attribute operations on every layer, skipped for elements that aren't in the container
+
+	void Copy(int32 Destination, int32 Source);
+
+	void Lerp(int32 Destination, int32 A, int32 B, float Alpha);
+
+	/**
+	 * Apply many lerps one layer at a time, so each pass only reads the values of one layer. Lerps are
+	 * applied in order, and large batches are split across threads, so destinations must be distinct and
+	 * must not be read by other lerps of the batch.
+	 */
+	void LerpBatch(TArrayView<const FBMeshAttributeLerp> Lerps);
+
+	/**
+	 * Add the layers of another mesh's container missing from this one, and copy the values of the
+	 * other container's elements to this container's elements starting at FirstElement.
+	 * Layers with the same name but another type are skipped.
+	 */
+	void Append(const FBMeshAttributeLayers& Other, int32 FirstElement, int32 NumElements);
+
+	/**
+	 * Save or load all layers. Loaded layers whose size doesn't match the container are discarded.
+	 */
+	void Serialize(FArchive& Ar, int32 NumElements);
+
+private:
+	TArray<TUniquePtr<FBMeshAttributeLayer>> Layers;
+};
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBMesh;
+class UBMeshVertex;
+class UBMeshEdge;
+class UBMeshFace;
+
+/**
+ * Adds elements to a mesh in bulk, e.g. when importing or generating large meshes.
+ * UBMesh::AddFace finds each edge by walking the disk cycle of one of its vertices, which gets
+ * slower as vertices gain edges. The builder keeps its own hash of the edges of the mesh instead,
+ * so every edge is found in constant time. Edges already in the mesh are hashed when the builder
+ * is created, and the builder must be the only thing adding or removing edges while it's alive.
+ * Faces are built exactly like UBMesh::AddFace builds them.
+ */
+class BMESH_API FBMeshBuilder
+{
+public:
+	explicit FBMeshBuilder(UBMesh* InMesh);
+
+	/**
+	 * Reserve room for this many new elements in the mesh's containers
+	 */
+	void Reserve(int32 NumVertices, int32 NumEdges, int32 NumLoops, int32 NumFaces);
+
+	UBMeshVertex* AddVertex(const FVector& Location);
+
+	/**
+	 * Add an edge between two vertices of the mesh, or return the existing one
+	 */
+	UBMeshEdge* AddEdge(UBMeshVertex* Vertex1, UBMeshVertex* Vertex2);
+
+	UBMeshEdge* AddEdge(int32 Vertex1, int32 Vertex2);
+
+	/**
+	 * Add a face along the given vertices, consecutive vertices must be different
+	 */
+	UBMeshFace* AddFace(TArrayView<UBMeshVertex* const> FaceVertices);
+
+	/**
+	 * Add a face along the vertices at the given indices of the mesh's Vertices container
+	 */
+	UBMeshFace* AddFace(TArrayView<const int32> VertexIndices);
+
+	UBMesh* GetMesh() const { return Mesh; }
+
+private:
+	using FEdgeKey = TPair<const UBMeshVertex*, const UBMeshVertex*>;
+
+	static FEdgeKey MakeEdgeKey(const UBMeshVertex* Vertex1, const UBMeshVertex* Vertex2)
+	{
+		return Vertex1 < Vertex2 ? FEdgeKey(Vertex1, Vertex2) : FEdgeKey(Vertex2, Vertex1);
+	}
+
+	UBMesh* Mesh;
+
+	TMap<FEdgeKey, UBMeshEdge*> EdgeMap;
+
+	TArray<UBMeshVertex*, TInlineAllocator<8>> FaceVertexBuffer;
+};
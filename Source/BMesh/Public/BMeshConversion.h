@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BMesh.h"
+#include "BMeshTriangulation.h"
+
+struct FMeshDescription;
+class UStaticMesh;
+
+#if WITH_BMESH_DYNAMIC_MESH
+class UDynamicMesh;
+namespace UE
+{
+	namespace Geometry
+	{
+		class FDynamicMesh3;
+	}
+}
+#endif
+
+/**
+ * Which element attributes are copied to or from the attributes of engine mesh formats.
+ * Properties are looked up by name, first in the loop class and then in the vertex class, and are
+ * ignored if they're not found or not of the expected type.
+ */
+struct BMESH_API FBMeshConversionOptions
+{
+	// FVector2D property copied to the first UV channel
+	FName UVAttribute = TEXT("UV");
+
+	// FVector property copied to the normals, normals are left to be computed by the consumer otherwise
+	FName NormalAttribute = TEXT("Normal");
+
+	// FLinearColor property copied to the vertex colors
+	FName ColorAttribute = TEXT("Color");
+};
+
+enum class EBMeshSectionSplit : uint8
+{
+	// One buffer vertex per mesh vertex, attributes are read from the vertex class and normals are smooth
+	PerVertex,
+	// One buffer vertex per loop, attributes are read from the loop class first and normals are flat
+	PerLoop,
+};
+
+struct BMESH_API FBMeshSectionOptions : FBMeshConversionOptions
+{
+	EBMeshSectionSplit Split = EBMeshSectionSplit::PerLoop;
+
+	EBMeshTriangulationMethod TriangulationMethod = EBMeshTriangulationMethod::EarClip;
+};
+
+/**
+ * Flat vertex and index buffers, laid out as ProceduralMeshComponent::CreateMeshSection and
+ * UpdateMeshSection take them.
+ */
+struct BMESH_API FBMeshSectionBuffers
+{
+	TArray<FVector> Positions;
+	TArray<int32> Triangles;
+	TArray<FVector> Normals;
+	// Empty if the mesh has no UV attribute
+	TArray<FVector2D> UVs;
+	// Empty if the mesh has no color attribute
+	TArray<FColor> Colors;
+
+	// Index in UBMesh::Vertices of each buffer vertex, used to update positions
+	TArray<int32> SourceVertices;
+	// Mesh and topology revision the buffers were built from, to detect topology changes
+	TWeakObjectPtr<const UBMesh> SourceMesh;
+	uint32 MeshTopologyRevision = 0;
+};
+
+/**
+ * Conversion of a BMesh to the mesh structures used by the engine.
+ * Faces are triangulated with FBMeshTriangulation, and each loop becomes a vertex instance, so
+ * attributes stored on loops can be discontinuous across faces (e.g. UV seams).
+ */
+class BMESH_API FBMeshConversion
+{
+public:
+	/**
+	 * Fill a mesh description with the triangulated faces of the mesh, in a single polygon group.
+	 * The description is emptied first and the static mesh attributes are registered on it.
+	 * Loose edges and isolated vertices are not exported.
+	 */
+	static void ToMeshDescription(const UBMesh* Mesh, FMeshDescription& MeshDescription, const FBMeshConversionOptions& Options = FBMeshConversionOptions());
+
+	/**
+	 * Fill render buffers with the triangulated faces of the mesh. Normals are read from the normal
+	 * attribute if there's one, and computed from the faces otherwise.
+	 * The buffers are reused, so rebuilding them every frame doesn't reallocate.
+	 */
+	static void ToMeshSection(const UBMesh* Mesh, FBMeshSectionBuffers& Buffers, const FBMeshSectionOptions& Options = FBMeshSectionOptions());
+
+	/**
+	 * Rewrite only the positions of buffers built by ToMeshSection, for meshes whose vertices moved
+	 * but whose topology didn't change. Normals are left untouched.
+	 * @return false if the buffers were built from another mesh, or if elements were added, removed or
+	 * reordered since (see UBMesh::GetTopologyRevision), in which case the buffers must be rebuilt
+	 */
+	static bool UpdateMeshSectionPositions(const UBMesh* Mesh, FBMeshSectionBuffers& Buffers);
+
+	/**
+	 * Create a mesh from the polygons of a mesh description. Vertex instances are welded back to the
+	 * vertex they belong to and each polygon corner becomes a loop, so per instance attributes are
+	 * copied to loop properties. Vertex properties get the attributes of the first instance of each
+	 * vertex. Polygons with repeated consecutive vertices are skipped.
+	 * Topology is built with FBMeshBuilder, and attributes are copied in parallel afterwards.
+	 */
+	static UBMesh* FromMeshDescription(const FMeshDescription& MeshDescription, UObject* Outer = GetTransientPackage(), UBMesh::FMakeParams Params = UBMesh::FMakeParams(), const FBMeshConversionOptions& Options = FBMeshConversionOptions());
+
+#if WITH_EDITOR
+	/**
+	 * Create a mesh from the source model of a static mesh LOD. Cooked static meshes only keep render
+	 * data, which has split vertices and no polygons, so this is only available in the editor.
+	 * @return nullptr if the static mesh has no mesh description for that LOD
+	 */
+	static UBMesh* FromStaticMesh(UStaticMesh* StaticMesh, int32 LODIndex = 0, UObject* Outer = GetTransientPackage(), UBMesh::FMakeParams Params = UBMesh::FMakeParams(), const FBMeshConversionOptions& Options = FBMeshConversionOptions());
+#endif
+
+#if WITH_BMESH_DYNAMIC_MESH
+	/**
+	 * Fill a dynamic mesh with the triangulated faces of the mesh. The triangle group of each triangle
+	 * is the index of its face. Triangles that would make the dynamic mesh non manifold are skipped.
+	 */
+	static void ToDynamicMesh(const UBMesh* Mesh, UE::Geometry::FDynamicMesh3& DynamicMesh, const FBMeshConversionOptions& Options = FBMeshConversionOptions());
+
+	/**
+	 * Replace the mesh of a dynamic mesh object, see the overload above.
+	 */
+	static void ToDynamicMesh(const UBMesh* Mesh, UDynamicMesh* DynamicMesh, const FBMeshConversionOptions& Options = FBMeshConversionOptions());
+#endif
+};
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Delaunay triangulation of a set of 2D points, by sweeping a convex hull (Sinclair's s-hull, as
+ * done in Delaunator): points are added in order of their distance to the center of a seed triangle,
+ * each one is joined to the hull edges it sees, and new triangles are legalized by edge flips.
+ * Orientation tests are exact, in-circle tests use double precision.
+ */
+struct BMESH_API FBMeshDelaunay
+{
+	// Counterclockwise triangles, as indices into the points
+	TArray<FIntVector> Triangles;
+
+	// Points on the convex hull, counterclockwise
+	TArray<int32> Hull;
+
+	/**
+	 * Triangulate the points. Duplicate points are skipped, and there is no triangle if there are less
+	 * than 3 points or if they are all collinear.
+	 */
+	static FBMeshDelaunay Build(TArrayView<const FVector2D> Points);
+
+	/**
+	 * Whether the points a, b and c are in counterclockwise order, exact even for nearly collinear points
+	 * @retval positive if counterclockwise, negative if clockwise, 0 if collinear
+	 */
+	static int32 Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C);
+
+	/**
+	 * Center of the circle through the three points, which must not be collinear
+	 */
+	static FVector2D Circumcenter(const FVector2D& A, const FVector2D& B, const FVector2D& C);
+};
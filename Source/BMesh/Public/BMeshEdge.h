@@ -91,6 +91,13 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category="Bmesh Edge")
 	UBMeshLoop* Loop;
 
+	// Position in the mesh's Edges, kept up to date by the mesh (see UBMesh::AddToContainer),
+	// INDEX_NONE when not in a mesh. Unlike Id it's not an attribute and isn't meant to be written
+	int32 Index = INDEX_NONE;
+
+	UFUNCTION(BlueprintPure)
+	int32 GetIndex() const { return Index; }
+
 	static UBMeshEdge* MakeEdge(TSubclassOf<UBMeshEdge> EdgeClass, UBMeshVertex* Vertex1, UBMeshVertex* Vertex2);
 
 	/**
@@ -129,6 +136,16 @@ public:
 	 */
 	void SetPrev(const UBMeshVertex* v, UBMeshEdge* other);
 
+	/**
+	 * Insert the edge in the linked list of edges around v, which must be one of its vertices.
+	 */
+	void AppendToDisk(UBMeshVertex* v);
+
+	/**
+	 * Remove the edge from the linked list of edges around v, which must be one of its vertices.
+	 */
+	void RemoveFromDisk(UBMeshVertex* v);
+
 	/**
 	 * Return all faces that use this edge as a side.
 	 */
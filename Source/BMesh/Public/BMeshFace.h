@@ -57,6 +57,16 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category="Bmesh Face")
 	UBMeshLoop* FirstLoop; // navigate list using next
 
+	// Position in the mesh's Faces, kept up to date by the mesh (see UBMesh::AddToContainer),
+	// INDEX_NONE when not in a mesh. Unlike Id it's not an attribute and isn't meant to be written
+	int32 Index = INDEX_NONE;
+
+	UFUNCTION(BlueprintPure)
+	int32 GetIndex() const { return Index; }
+
+	// Slot of the handles to this face, managed by the mesh (see FBMeshFaceHandle)
+	int32 Slot = INDEX_NONE;
+
 	/**
     * Get the list of vertices used by the face, ordered.
     */
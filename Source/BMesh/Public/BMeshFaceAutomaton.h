@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+
+#include "BMesh.h"
+#include "BMeshFace.h"
+
+/**
+ * Which faces are considered neighbors of each other when building a FBMeshFaceAdjacency
+ */
+enum class EBMeshFaceAdjacency : uint8
+{
+	// Faces that share at least one edge (von Neumann neighborhood on a quad grid)
+	Edge,
+	// Faces that share at least one vertex (Moore neighborhood on a quad grid)
+	Vertex,
+};
+
+/**
+ * Face to face adjacency table in compressed sparse row form.
+ * The neighbors of face i are Neighbors[Offsets[i]] ... Neighbors[Offsets[i + 1] - 1],
+ * where i is the index of the face in UBMesh::Faces at the time the table was built.
+ * The table is a snapshot of the topology, so it must be rebuilt after faces are added or removed.
+ */
+struct BMESH_API FBMeshFaceAdjacency
+{
+	TArray<int32> Offsets;
+	TArray<int32> Neighbors;
+
+	/**
+	 * Build the adjacency of all faces in the mesh, in parallel.
+	 */
+	static FBMeshFaceAdjacency Build(UBMesh* Mesh, EBMeshFaceAdjacency Mode = EBMeshFaceAdjacency::Edge);
+
+	int32 Num() const
+	{
+		return Offsets.Num() > 0 ? Offsets.Num() - 1 : 0;
+	}
+
+	TArrayView<const int32> GetNeighbors(int32 FaceIndex) const
+	{
+		return TArrayView<const int32>(Neighbors.GetData() + Offsets[FaceIndex], Offsets[FaceIndex + 1] - Offsets[FaceIndex]);
+	}
+};
+
+/**
+ * Double buffered per face state, used to run cellular automata (spread, growth, influence maps...)
+ * over the faces of a mesh without touching the face objects themselves.
+ *
+ * The state is stored in a flat array indexed like the adjacency table. Each step reads the current
+ * buffer and writes the other one, so every face can be evaluated in parallel. The kernel is any
+ * callable with the signature:
+ *
+ *     StateType Kernel(int32 FaceIndex, const StateType& Current, TArrayView<const int32> Neighbors, TArrayView<const StateType> State)
+ *
+ * and it must only read from the views it receives (or other read only data), never write shared state.
+ *
+ * State made of several fields is best split into one automaton per field (struct of arrays), so each
+ * kernel only touches the data it needs. Coupled fields can be updated together by calling Evaluate on
+ * each of them, with kernels reading the other fields through GetCurrent(), and then SwapBuffers on all of them.
+ */
+template <typename StateType>
+class TBMeshFaceAutomaton
+{
+public:
+	/**
+	 * The adjacency table is referenced, not copied, and must outlive the automaton
+	 */
+	explicit TBMeshFaceAutomaton(const FBMeshFaceAdjacency& InAdjacency, const StateType& InitialValue = StateType())
+		: Adjacency(InAdjacency)
+	{
+		Buffers[0].Init(InitialValue, Adjacency.Num());
+		Buffers[1].Init(InitialValue, Adjacency.Num());
+	}
+
+	int32 Num() const
+	{
+		return Buffers[CurrentBuffer].Num();
+	}
+
+	TArrayView<const StateType> GetCurrent() const
+	{
+		return Buffers[CurrentBuffer];
+	}
+
+	/**
+	 * Write access to the current state, used to set up initial conditions between steps
+	 */
+	TArrayView<StateType> GetCurrentMutable()
+	{
+		return Buffers[CurrentBuffer];
+	}
+
+	/**
+	 * Evaluate the kernel for every face, reading the current buffer and writing the next one.
+	 * The results are not visible until SwapBuffers is called.
+	 */
+	template <typename KernelType>
+	void Evaluate(KernelType&& Kernel, bool bForceSingleThread = false)
+	{
+		check(Adjacency.Num() == Num());
+		const TArray<StateType>& Read = Buffers[CurrentBuffer];
+		TArray<StateType>& Write = Buffers[1 - CurrentBuffer];
+		const TArrayView<const StateType> ReadView = Read;
+
+		// Faces are processed in contiguous batches so the kernel can be inlined in the inner loop
+		const int32 NumFaces = Num();
+		const int32 NumBatches = FMath::DivideAndRoundUp(NumFaces, BatchSize);
+		ParallelFor(NumBatches, [&](int32 BatchIndex)
+		{
+			const int32 Start = BatchIndex * BatchSize;
+			const int32 End = FMath::Min(Start + BatchSize, NumFaces);
+			for (int32 FaceIndex = Start; FaceIndex < End; ++FaceIndex)
+			{
+				Write[FaceIndex] = Kernel(FaceIndex, Read[FaceIndex], Adjacency.GetNeighbors(FaceIndex), ReadView);
+			}
+		}, bForceSingleThread);
+	}
+
+	void SwapBuffers()
+	{
+		CurrentBuffer = 1 - CurrentBuffer;
+	}
+
+	/**
+	 * Run one simulation tick: Evaluate followed by SwapBuffers
+	 */
+	template <typename KernelType>
+	void Step(KernelType&& Kernel, bool bForceSingleThread = false)
+	{
+		Evaluate(Forward<KernelType>(Kernel), bForceSingleThread);
+		SwapBuffers();
+	}
+
+	/**
+	 * Initialize the current state from the faces of the mesh the adjacency was built from,
+	 * for example from a property of a UBMeshFace subclass.
+	 * Getter has the signature StateType(const UBMeshFace*)
+	 */
+	template <typename GetterType>
+	void Gather(const UBMesh* Mesh, GetterType&& Getter)
+	{
+		check(Mesh->Faces.Num() == Num());
+		TArray<StateType>& Current = Buffers[CurrentBuffer];
+		for (int32 FaceIndex = 0; FaceIndex < Current.Num(); ++FaceIndex)
+		{
+			Current[FaceIndex] = Getter(Mesh->Faces[FaceIndex]);
+		}
+	}
+
+	/**
+	 * Write the current state back to the faces of the mesh the adjacency was built from.
+	 * Setter has the signature void(UBMeshFace*, const StateType&)
+	 */
+	template <typename SetterType>
+	void Scatter(UBMesh* Mesh, SetterType&& Setter) const
+	{
+		check(Mesh->Faces.Num() == Num());
+		const TArray<StateType>& Current = Buffers[CurrentBuffer];
+		for (int32 FaceIndex = 0; FaceIndex < Current.Num(); ++FaceIndex)
+		{
+			Setter(Mesh->Faces[FaceIndex], Current[FaceIndex]);
+		}
+	}
+
+private:
+	static constexpr int32 BatchSize = 1024;
+
+	const FBMeshFaceAdjacency& Adjacency;
+	TArray<StateType> Buffers[2];
+	int32 CurrentBuffer = 0;
+};
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BMesh.h"
+
+/**
+ * Readers and writers for Wavefront OBJ and binary PLY files, meant to move large meshes in and out
+ * of BMesh without going through the engine's asset pipeline (e.g. from a commandlet, see
+ * UBMeshConvertCommandlet).
+ * Files are streamed through a fixed size buffer in both directions, so beside the mesh itself memory
+ * use doesn't depend on the file size, and meshes are built with FBMeshBuilder.
+ * Only positions and polygons are read or written: OBJ texture coordinates, normals, groups and
+ * materials are ignored, as are the PLY properties other than x, y, z, vertex_indices and the
+ * vertex1, vertex2 of edges.
+ * Faces with less than 3 vertices, out of range indices or repeated consecutive vertices are skipped.
+ */
+class BMESH_API FBMeshFileIO
+{
+public:
+	/**
+	 * Read a mesh from a file, picking the format from the extension (.obj or .ply)
+	 * @retval the new mesh, null if the file could not be read
+	 */
+	static UBMesh* Read(const FString& Filename, UObject* Outer = GetTransientPackage(), UBMesh::FMakeParams Params = UBMesh::FMakeParams());
+
+	/**
+	 * Write a mesh to a file, picking the format from the extension (.obj or .ply)
+	 */
+	static bool Write(const UBMesh* Mesh, const FString& Filename);
+
+	static UBMesh* ReadOBJ(const FString& Filename, UObject* Outer = GetTransientPackage(), UBMesh::FMakeParams Params = UBMesh::FMakeParams());
+
+	/**
+	 * Write vertices (v), faces (f) and edges not used by any face (l)
+	 */
+	static bool WriteOBJ(const UBMesh* Mesh, const FString& Filename);
+
+	/**
+	 * Read a binary_little_endian or binary_big_endian PLY file, ascii PLY files are not supported
+	 */
+	static UBMesh* ReadPLY(const FString& Filename, UObject* Outer = GetTransientPackage(), UBMesh::FMakeParams Params = UBMesh::FMakeParams());
+
+	/**
+	 * Write a binary PLY file, in the platform's byte order, with float vertex positions and int vertex indices.
+	 * Edges not used by any face are written as an edge element.
+	 */
+	static bool WritePLY(const UBMesh* Mesh, const FString& Filename);
+};
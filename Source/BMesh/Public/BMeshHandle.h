@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BMeshHandle.generated.h"
+
+/**
+ * Weak reference to a vertex of a mesh, see UBMesh::GetVertexHandle. A handle is a slot and the
+ * generation of that slot, it resolves in constant time and stops resolving once the vertex is
+ * removed, even if its slot is reused by another vertex. Handles stay valid when the containers
+ * are reordered and when the mesh is saved and loaded, so they can be kept in save games.
+ */
+USTRUCT(BlueprintType)
+struct BMESH_API FBMeshVertexHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category="BMesh")
+	int32 Slot = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category="BMesh")
+	int32 Generation = 0;
+
+	bool IsSet() const { return Slot != INDEX_NONE; }
+
+	bool operator==(const FBMeshVertexHandle& Other) const { return Slot == Other.Slot && Generation == Other.Generation; }
+	bool operator!=(const FBMeshVertexHandle& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FBMeshVertexHandle& Handle) { return HashCombine(::GetTypeHash(Handle.Slot), ::GetTypeHash(Handle.Generation)); }
+
+	friend FArchive& operator<<(FArchive& Ar, FBMeshVertexHandle& Handle) { return Ar << Handle.Slot << Handle.Generation; }
+};
+
+template <>
+struct TStructOpsTypeTraits<FBMeshVertexHandle> : public TStructOpsTypeTraitsBase2<FBMeshVertexHandle>
+{
+	enum { WithIdenticalViaEquality = true };
+};
+
+/**
+ * Weak reference to a face of a mesh, see UBMesh::GetFaceHandle and FBMeshVertexHandle
+ */
+USTRUCT(BlueprintType)
+struct BMESH_API FBMeshFaceHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category="BMesh")
+	int32 Slot = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category="BMesh")
+	int32 Generation = 0;
+
+	bool IsSet() const { return Slot != INDEX_NONE; }
+
+	bool operator==(const FBMeshFaceHandle& Other) const { return Slot == Other.Slot && Generation == Other.Generation; }
+	bool operator!=(const FBMeshFaceHandle& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FBMeshFaceHandle& Handle) { return HashCombine(::GetTypeHash(Handle.Slot), ::GetTypeHash(Handle.Generation)); }
+
+	friend FArchive& operator<<(FArchive& Ar, FBMeshFaceHandle& Handle) { return Ar << Handle.Slot << Handle.Generation; }
+};
+
+template <>
+struct TStructOpsTypeTraits<FBMeshFaceHandle> : public TStructOpsTypeTraitsBase2<FBMeshFaceHandle>
+{
+	enum { WithIdenticalViaEquality = true };
+};
+
+/**
+ * Slots of the elements of one container of a mesh, which back the handles to these elements.
+ * Elements take a slot when they are added to the mesh and give it back when they are removed.
+ * Freed slots are reused, and every reuse bumps the generation of the slot so that handles to the
+ * previous element don't resolve to the new one.
+ */
+template <typename T>
+class TBMeshSlotTable
+{
+public:
+	void Allocate(T* Element)
+	{
+		int32 Slot;
+		if (FreeSlots.Num() > 0)
+		{
+			Slot = FreeSlots.Pop(false);
+		}
+		else
+		{
+			Slot = Elements.Add(nullptr);
+			Generations.Add(0);
+		}
+		Elements[Slot] = Element;
+		++Generations[Slot];
+		Element->Slot = Slot;
+	}
+
+	void Release(T* Element)
+	{
+		const int32 Slot = Element->Slot;
+		if (Elements.IsValidIndex(Slot) && Elements[Slot] == Element)
+		{
+			Elements[Slot] = nullptr;
+			FreeSlots.Add(Slot);
+		}
+		Element->Slot = INDEX_NONE;
+	}
+
+	/** Generation of the slot of an element, 0 if the element has no slot */
+	int32 GetGeneration(const T* Element) const
+	{
+		return Element != nullptr && Elements.IsValidIndex(Element->Slot) && Elements[Element->Slot] == Element ? Generations[Element->Slot] : 0;
+	}
+
+	/** Element in a slot, if the slot still has the given generation */
+	T* Resolve(int32 Slot, int32 Generation) const
+	{
+		return Elements.IsValidIndex(Slot) && Generations[Slot] == Generation ? Elements[Slot] : nullptr;
+	}
+
+	/** Give each element of a container a new slot, which invalidates all existing handles */
+	void Reset(const TArray<T*>& Container)
+	{
+		// Slots are never shrunk and their generations only grow, so handles from before can't resolve again
+		const int32 NumSlots = FMath::Max(Generations.Num(), Container.Num());
+		Elements = Container;
+		Elements.SetNumZeroed(NumSlots);
+		Generations.SetNumZeroed(NumSlots);
+		FreeSlots.Reset();
+		for (int32 Slot = NumSlots - 1; Slot >= 0; --Slot)
+		{
+			++Generations[Slot];
+			if (Slot < Container.Num())
+			{
+				Container[Slot]->Slot = Slot;
+			}
+			else
+			{
+				FreeSlots.Add(Slot);
+			}
+		}
+	}
+
+	/**
+	 * Save or load the slots of the elements of a container, in the order of the container, and the
+	 * generations of all slots.
+	 * @retval false if the loaded slots don't match the container, in which case nothing is changed
+	 */
+	bool Serialize(FArchive& Ar, const TArray<T*>& Container)
+	{
+		TArray<int32> ElementSlots;
+		if (Ar.IsSaving())
+		{
+			ElementSlots.Reserve(Container.Num());
+			for (const T* Element : Container)
+			{
+				ElementSlots.Add(Element->Slot);
+			}
+		}
+		ElementSlots.BulkSerialize(Ar);
+		if (!Ar.IsLoading())
+		{
+			Generations.BulkSerialize(Ar);
+			return true;
+		}
+
+		TArray<int32> LoadedGenerations;
+		LoadedGenerations.BulkSerialize(Ar);
+		if (Ar.IsError() || ElementSlots.Num() != Container.Num())
+			return false;
+		TArray<T*> LoadedElements;
+		LoadedElements.Init(nullptr, LoadedGenerations.Num());
+		for (int32 i = 0; i < Container.Num(); ++i)
+		{
+			const int32 Slot = ElementSlots[i];
+			if (!LoadedElements.IsValidIndex(Slot) || LoadedElements[Slot] != nullptr)
+				return false;
+			LoadedElements[Slot] = Container[i];
+		}
+
+		Elements = MoveTemp(LoadedElements);
+		Generations = MoveTemp(LoadedGenerations);
+		FreeSlots.Reset();
+		for (int32 Slot = Elements.Num() - 1; Slot >= 0; --Slot)
+		{
+			if (Elements[Slot] == nullptr)
+			{
+				FreeSlots.Add(Slot);
+			}
+		}
+		for (int32 i = 0; i < Container.Num(); ++i)
+		{
+			Container[i]->Slot = ElementSlots[i];
+		}
+		return true;
+	}
+
+private:
+	TArray<T*> Elements;
+	TArray<int32> Generations;
+	TArray<int32> FreeSlots;
+};
@@ -79,8 +79,39 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Internals")
 	UBMeshLoop* Next; // around face
 
+	// Position in the mesh's Loops, kept up to date by the mesh (see UBMesh::AddToContainer),
+	// INDEX_NONE when not in a mesh. It isn't an attribute and isn't meant to be written
+	int32 Index = INDEX_NONE;
+
+	UFUNCTION(BlueprintPure, Category = "Internals")
+	int32 GetIndex() const { return Index; }
+
 	static UBMeshLoop* MakeLoop(TSubclassOf<UBMeshLoop> LoopClass, UBMeshVertex* Vertex, UBMeshEdge* Edge, UBMeshFace* Face);
 
+	/**
+	 * Make a loop that is inserted in the face of another loop, right after it, e.g. when splitting
+	 * an edge of the face. The face gains a corner, so its VertCount is incremented.
+	 */
+	static UBMeshLoop* MakeLoopAfter(TSubclassOf<UBMeshLoop> LoopClass, UBMeshVertex* Vertex, UBMeshEdge* Edge, UBMeshLoop* After);
+
+	/**
+	 * Move the loop from the radial list of its edge to the one of another edge,
+	 * e.g. when merging duplicate edges.
+	 */
+	void MoveToEdge(UBMeshEdge* e);
+
+	/**
+	 * Remove the loop from the radial linked list of its edge, leaving it without edge.
+	 */
+	void RemoveFromRadial();
+
+	/**
+	 * Remove the loop from the linked list of its face, leaving it without face.
+	 * The face loses a corner, so its VertCount is decremented. If it was the last loop the face
+	 * is left without loops, and it's up to the caller to remove it.
+	 */
+	void RemoveFromFace();
+
 protected:
 	/**
 	 * Insert the loop in the linked list of the face.
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "BMesh.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Attribute column of a mapped mesh file, values are stored contiguously with Stride bytes per element
+ */
+struct FBMeshMappedAttribute
+{
+	FName Name;
+	// C++ type of the property the column was written from
+	FString Type;
+	EBMeshElementType ElementType;
+	int32 Stride;
+	int32 Num;
+	const uint8* Data;
+};
+
+/**
+ * Read only mesh stored in a flat file whose layout matches an index based topology:
+ *  - vertex positions, as 3 floats per vertex
+ *  - face offsets into the loop arrays, faces store their loops contiguously in cycle order
+ *  - the vertex of each loop, and the edge from it to the next loop of the face
+ *  - the two vertices of each edge
+ *  - one column per plain old data attribute of the element classes
+ *
+ * The file is mapped in memory and all queries read it in place, nothing is copied or allocated
+ * per element. An editable UBMesh is only built when calling ToBMesh.
+ * Indices are only checked by Validate, which ToBMesh calls.
+ */
+class BMESH_API FBMeshMappedFile
+{
+public:
+	/**
+	 * Write a mesh in the mapped format. Attributes that are not plain old data (e.g. strings or
+	 * object references) can't be read in place, so they are left out.
+	 * @retval whether the file could be written
+	 */
+	static bool Write(const UBMesh* Mesh, const FString& Filename);
+
+	/**
+	 * Map a file written by Write. Only the header and section bounds are checked here.
+	 * @retval the mapped file, null if it could not be mapped or is not a valid mesh file
+	 */
+	static TUniquePtr<FBMeshMappedFile> Open(const FString& Filename);
+
+	~FBMeshMappedFile();
+
+	int32 NumVertices() const { return Header->NumVertices; }
+	int32 NumEdges() const { return Header->NumEdges; }
+	int32 NumLoops() const { return Header->NumLoops; }
+	int32 NumFaces() const { return Header->NumFaces; }
+
+	FVector GetPosition(int32 Vertex) const
+	{
+		const float* Position = &Positions[Vertex * 3];
+		return FVector(Position[0], Position[1], Position[2]);
+	}
+
+	// 3 floats per vertex
+	TArrayView<const float> GetPositionData() const { return Positions; }
+
+	// NumFaces + 1 entries, the loops of face i are in [FaceOffsets[i], FaceOffsets[i + 1])
+	TArrayView<const int32> GetFaceOffsets() const { return FaceOffsets; }
+
+	TArrayView<const int32> GetLoopVertices() const { return LoopVertices; }
+
+	TArrayView<const int32> GetLoopEdges() const { return LoopEdges; }
+
+	// 2 vertex indices per edge
+	TArrayView<const int32> GetEdgeVertexData() const { return EdgeVertices; }
+
+	int32 GetFaceVertCount(int32 Face) const { return FaceOffsets[Face + 1] - FaceOffsets[Face]; }
+
+	TArrayView<const int32> GetFaceVertices(int32 Face) const { return LoopVertices.Slice(FaceOffsets[Face], GetFaceVertCount(Face)); }
+
+	// Edge k joins vertex k to vertex k + 1 of the face
+	TArrayView<const int32> GetFaceEdges(int32 Face) const { return LoopEdges.Slice(FaceOffsets[Face], GetFaceVertCount(Face)); }
+
+	FIntPoint GetEdgeVertices(int32 Edge) const { return FIntPoint(EdgeVertices[Edge * 2], EdgeVertices[Edge * 2 + 1]); }
+
+	const TArray<FBMeshMappedAttribute>& GetAttributes() const { return Attributes; }
+
+	const FBMeshMappedAttribute* FindAttribute(EBMeshElementType ElementType, FName Name) const;
+
+	/**
+	 * Values of an attribute viewed in place, empty if there is no such attribute or its stride isn't the size of T
+	 */
+	template <typename T>
+	TArrayView<const T> GetAttributeValues(EBMeshElementType ElementType, FName Name) const
+	{
+		const FBMeshMappedAttribute* Attribute = FindAttribute(ElementType, Name);
+		if (!Attribute || Attribute->Stride != sizeof(T))
+			return TArrayView<const T>();
+		return TArrayView<const T>(reinterpret_cast<const T*>(Attribute->Data), Attribute->Num);
+	}
+
+	/**
+	 * Check that all indices in the file are in range, that faces and edges don't join a vertex to
+	 * itself, and that the edge of each face corner joins the vertex of the corner to the next one
+	 */
+	bool Validate() const;
+
+	/**
+	 * Build an editable mesh from the file. Attributes are copied to the properties of the element
+	 * classes that have the same name and type.
+	 * @retval the new mesh, null if the file doesn't validate
+	 */
+	UBMesh* ToBMesh(UObject* Outer = GetTransientPackage(), UBMesh::FMakeParams Params = UBMesh::FMakeParams()) const;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 NumVertices;
+		int32 NumEdges;
+		int32 NumLoops;
+		int32 NumFaces;
+		int32 NumAttributes;
+		uint32 Padding;
+		int64 PositionsOffset;
+		int64 FaceOffsetsOffset;
+		int64 LoopVerticesOffset;
+		int64 LoopEdgesOffset;
+		int64 EdgeVerticesOffset;
+		int64 AttributesOffset;
+	};
+
+	struct FAttributeHeader
+	{
+		ANSICHAR Name[64];
+		ANSICHAR Type[64];
+		uint8 ElementType;
+		uint8 Padding[3];
+		int32 Stride;
+		int64 Offset;
+	};
+
+private:
+	FBMeshMappedFile() = default;
+
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+
+	const FHeader* Header = nullptr;
+	TArrayView<const float> Positions;
+	TArrayView<const int32> FaceOffsets;
+	TArrayView<const int32> LoopVertices;
+	TArrayView<const int32> LoopEdges;
+	TArrayView<const int32> EdgeVertices;
+	TArray<FBMeshMappedAttribute> Attributes;
+};
@@ -31,11 +31,62 @@
 
 #include "UObject/Field.h"
 
+#include "BMeshTriangulation.h"
+
 class UBMeshEdge;
 class UBMesh;
 class UBMeshVertex;
+class FBMeshAttributeLayers;
 class FPrimitiveDrawInterface;
 
+/**
+ * Which elements are labeled by ComputeConnectedComponents, and how they connect to each other
+ */
+enum class EBMeshConnectivity : uint8
+{
+	// Vertices connected by an edge
+	Vertex,
+	// Edges that share a vertex
+	Edge,
+	// Faces that share an edge
+	Face,
+};
+
+/**
+ * How ExtrudeFaces and InsetFaces handle selected faces that share edges
+ */
+enum class EBMeshFaceRegionMode : uint8
+{
+	// Faces sharing edges stay connected, only the boundary of the selection gets side faces
+	Region,
+	// Each face is handled on its own
+	Individual,
+};
+
+/**
+ * What FBMeshOperators::Dual does with the vertices on the boundary of the mesh
+ */
+enum class EBMeshDualBoundary : uint8
+{
+	// Boundary vertices get no face
+	Clip,
+	// Boundary vertices get a face closed by the middles of their boundary edges and the vertex itself
+	Close,
+};
+
+/**
+ * Result of FBMeshOperators::ComputeConnectedComponents
+ */
+struct FBMeshConnectedComponents
+{
+	// Component of each element, indexed like the element's container in the mesh
+	TArray<int32> ComponentIds;
+	// Number of elements in each component
+	TArray<int32> ComponentSizes;
+
+	int32 Num() const { return ComponentSizes.Num(); }
+};
+
 /**
  * BMesh Operators are static functions manipulating BMesh objects. Their first
  * argument is the input mesh, in which they are performing changes, so it is
@@ -72,21 +123,21 @@ private:
 	class FPropertyLerp
 	{
 	public:
-		virtual void Lerp(FProperty* Property, UBMeshVertex* destination, UBMeshVertex* v1, UBMeshVertex* v2, float t) = 0;
+		virtual void Lerp(FProperty* Property, void* destination, const void* v1, const void* v2, float t) = 0;
 		virtual ~FPropertyLerp();
 	};
 
 	class FStructPropertyLerp : public FPropertyLerp
 	{
 	public:
-		void Lerp(FProperty* Property, UBMeshVertex* destination, UBMeshVertex* v1, UBMeshVertex* v2, float t) override;
+		void Lerp(FProperty* Property, void* destination, const void* v1, const void* v2, float t) override;
 	};
 
 	template <typename T>
 	class TNumericPropertyLerp : public FPropertyLerp
 	{
 	public:
-		void Lerp(FProperty* Property, UBMeshVertex* destination, UBMeshVertex* v1, UBMeshVertex* v2, float t) override
+		void Lerp(FProperty* Property, void* destination, const void* v1, const void* v2, float t) override
 		{
 			T* TypedProperty = static_cast<T*>(Property);
 			for (int i = 0; i < TypedProperty->ArrayDim; ++i)
@@ -102,13 +153,13 @@ private:
 	template <typename StructType>
 	class TSpecificStructPropertyLerp : public FPropertyLerp
 	{
-		void Lerp(FProperty* Property, UBMeshVertex* destination, UBMeshVertex* v1, UBMeshVertex* v2, float t) override
+		void Lerp(FProperty* Property, void* destination, const void* v1, const void* v2, float t) override
 		{
 			FStructProperty* TypedProperty = static_cast<FStructProperty*>(Property);
 			for (int i = 0; i < TypedProperty->ArrayDim; ++i)
 			{
-				StructType* val1 = TypedProperty->ContainerPtrToValuePtr<StructType>(v1, i);
-				StructType* val2 = TypedProperty->ContainerPtrToValuePtr<StructType>(v2, i);
+				const StructType* val1 = TypedProperty->ContainerPtrToValuePtr<StructType>(v1, i);
+				const StructType* val2 = TypedProperty->ContainerPtrToValuePtr<StructType>(v2, i);
 				StructType* result = TypedProperty->ContainerPtrToValuePtr<StructType>(destination, i);
 				*result = FMath::Lerp(*val1, *val2, t);
 			}
@@ -138,6 +189,64 @@ public:
 	}
 
 	static void RegisterDefaultTypeInterpolators();
+
+	/**
+	 * The attributes of an element class, i.e. the properties added by a subclass of UBMeshVertex,
+	 * UBMeshEdge, UBMeshLoop or UBMeshFace, along with their registered interpolators. Operators that
+	 * touch many elements compile it once instead of walking the class properties for each element.
+	 * Given the attribute layers of the elements' mesh, the values of elements in the layers are copied
+	 * and interpolated as well.
+	 */
+	struct BMESH_API FAttributeLayout
+	{
+		/**
+		 * @param ElementClass class of the elements the layout is used on
+		 * @param BaseClass base element class, whose properties are topology and are neither copied nor interpolated
+		 * @param InLayers layers of BaseClass elements of the mesh the layout is used on, all elements must belong to it
+		 */
+		FAttributeLayout(UClass* ElementClass, UClass* BaseClass, FBMeshAttributeLayers* InLayers = nullptr);
+
+		/**
+		 * Copy all attributes from source to destination, which must both be of the layout's class
+		 */
+		void Copy(UObject* Destination, const UObject* Source) const;
+
+		/**
+		 * Set all attributes that have a registered interpolator in destination to attr[A] * (1 - t) + attr[B] * t
+		 */
+		void Lerp(UObject* Destination, const UObject* A, const UObject* B, float t) const;
+
+		bool IsEmpty() const { return Attributes.Num() == 0; }
+
+		int32 Num() const { return Attributes.Num(); }
+
+		FProperty* GetProperty(int32 Index) const { return Attributes[Index].Property; }
+
+	private:
+		struct FAttribute
+		{
+			FProperty* Property;
+			FPropertyLerp* Lerp;
+		};
+		TArray<FAttribute> Attributes;
+		FBMeshAttributeLayers* Layers = nullptr;
+		int32 (*IndexOf)(const UObject* Element) = nullptr;
+	};
+
+	/**
+	 * Pairs the attributes of two element classes by name and type, so attributes can be copied between
+	 * meshes configured with different classes. Attributes missing from either class are skipped.
+	 */
+	struct BMESH_API FAttributeMapping
+	{
+		FAttributeMapping(UClass* DestinationClass, UClass* SourceClass, UClass* BaseClass);
+
+		void Copy(UObject* Destination, const UObject* Source) const;
+
+	private:
+		TArray<TPair<FProperty*, FProperty*>> Properties;
+	};
+
 	/**
 	 * Set all attributes in destination vertex to attr[v1] * (1 - t) + attr[v2] * t
 	 * Overriding attributes: all in vertex 'destination', none in others.
@@ -148,7 +257,6 @@ public:
 	 * Subdivide a mesh, without smoothing it, trying to interpolate all
 	 * available attributes as much as possible. After subdivision, all faces
 	 * are quads.
-	 * Overriding attributes: edge's id
 	 */
 	static void Subdivide(UBMesh* mesh);
 
@@ -164,6 +272,17 @@ public:
 	 */
 	static bool MergeFaces(UBMesh* Mesh, UBMeshEdge* Edge);
 
+	/**
+	 * Merge random pairs of adjacent triangles into quads, e.g. to turn a triangle grid into an
+	 * irregular quad grid. The pairs are a random maximal matching of the triangles, found in parallel,
+	 * and each merge is a DissolveEdge. The result only depends on the seed and the order of the
+	 * mesh's containers.
+	 * @param Ratio probability that each edge between two triangles is considered for merging
+	 * Overriding attributes: none, merged quads keep the attributes of their first triangle
+	 * @retval number of merged pairs
+	 */
+	static int32 MergeRandomTrianglePairs(UBMesh* Mesh, int32 Seed, float Ratio = 1.0f);
+
 	///////////////////////////////////////////////////////////////////////////
 	// [SquarifyQuads}
 
@@ -179,7 +298,6 @@ public:
 	 * Try to make quads as square as possible (may be called iteratively).
 	 * This is not a very common operation but was developed so I keep it here.
 	 * This assumes that the mesh is only made of quads.
-	 * Overriding attributes: vertex's id
 	 * Optionally read vertex attributes:
 	 *   - RestPos: a FVector telling which position attracts the vertex
 	 *   - Weight: a float telling to which extent the RestPos must be
@@ -206,15 +324,276 @@ public:
 	 */
 	static void SubdivideTriangleFan(TArrayView<class UBMeshFace* const> Faces);
 
+	///////////////////////////////////////////////////////////////////////////
+	// [Triangulate]
+
+	/**
+	 * Split faces with more than 3 corners into triangles, without adding vertices. Faces are
+	 * triangulated in parallel (see FBMeshTriangulation), then all triangles are added in bulk
+	 * through FBMeshBuilder and the original faces are removed. Existing edges are kept.
+	 * Each triangle gets a copy of the attributes of its original face, and each of its loops a copy
+	 * of the attributes of the original loop at the same corner.
+	 * Overriding attributes: none
+	 */
+	static void Triangulate(UBMesh* Mesh, TArrayView<class UBMeshFace* const> Faces, EBMeshTriangulationMethod Method = EBMeshTriangulationMethod::EarClip);
+
+	/**
+	 * Triangulate all faces of the mesh
+	 */
+	static void Triangulate(UBMesh* Mesh, EBMeshTriangulationMethod Method = EBMeshTriangulationMethod::EarClip);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Connectivity]
+
+	/**
+	 * Find the islands of the mesh, e.g. grid regions that became disconnected after removing faces.
+	 * Elements are united in parallel using a lock free union-find, and component ids are dense and
+	 * ordered by the lowest element index of each component.
+	 */
+	static FBMeshConnectedComponents ComputeConnectedComponents(UBMesh* Mesh, EBMeshConnectivity Connectivity);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [WeldVertices]
+
+	/**
+	 * Merge vertices that are closer than Tolerance to each other (merge by distance).
+	 * Vertices are bucketed in a spatial hash with cells the size of Tolerance, so each one is
+	 * only compared to the vertices in neighboring cells. Clusters are formed transitively, so a
+	 * chain of close vertices is welded together even if its ends are farther than Tolerance.
+	 * The lowest index vertex of each cluster is kept along with its attributes, and edges and
+	 * loops are rewired to it. Edges that collapse are removed, along with the corners that used
+	 * them, and edges that end up joining the same two vertices are merged. Faces that visit a
+	 * vertex twice (e.g. welded across a diagonal) are split there, and faces or parts of faces left
+	 * with less than 3 corners are removed.
+	 * @retval number of vertices removed
+	 */
+	static int32 WeldVertices(UBMesh* Mesh, float Tolerance);
+
 	///////////////////////////////////////////////////////////////////////////
 	// [Merge]
 
 	/**
-	 * Add all vertices/edges/faces from another mesh, and fix attributes if
-	 * needed.
-	 * Overriding attributes: vertex's id (of the first mesh only)
+	 * Add all vertices/edges/loops/faces from another mesh, along with their attributes.
+	 * Elements are copied in bulk: destination containers are reserved once, every link between
+	 * elements of the other mesh is remapped through its index to the copy at the same offset (so no
+	 * edge or element is ever looked up),
+	 * and attributes are copied through layouts compiled once per element class. If the two meshes use
+	 * different element classes, attributes are matched by name and type.
+	 * Overriding attributes: none
 	 */
-	static void Merge(UBMesh* mesh, UBMesh* other);
+	static void Merge(UBMesh* Mesh, UBMesh* Other);
+
+	/**
+	 * Add all elements of several meshes at once, reserving the destination containers for all of them.
+	 * Overriding attributes: none
+	 */
+	static void Merge(UBMesh* Mesh, TArrayView<UBMesh* const> Others);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Local edits]
+	// Euler operators that relink the loops and disk cycles around the edited elements in place.
+	// They never look at the element containers: new elements are appended, and removed elements
+	// are taken out with RemoveFromContainer, so many edits should be done inside a
+	// FBMeshDeferredRemovalScope.
+
+	/**
+	 * Insert a vertex at Lerp(Vert1, Vert2, t) along an edge. The edge now joins Vert1 to the new
+	 * vertex, and a new edge joins the new vertex to Vert2. Each face using the edge gains a corner.
+	 * Overriding attributes: all in the new vertex and loops (interpolated), and the new edge (copied)
+	 * @retval the new vertex
+	 */
+	static UBMeshVertex* SplitEdge(UBMesh* Mesh, UBMeshEdge* Edge, float t = 0.5f);
+
+	/**
+	 * Split a face in two along a new edge between the vertices of two of its corners, which must not
+	 * be adjacent. The face keeps the corners from LoopA to the one before LoopB, and the new face gets
+	 * the corners from LoopB to the one before LoopA. If the vertices are already joined by an edge,
+	 * that edge is used.
+	 * Overriding attributes: all in the new face and the two new loops (copied from the face and
+	 * from the corners at the same vertices)
+	 * @retval the new face
+	 */
+	static UBMeshFace* SplitFace(UBMesh* Mesh, UBMeshLoop* LoopA, UBMeshLoop* LoopB);
+
+	/**
+	 * Rotate an edge shared by two triangles, so that it joins their opposite corners instead.
+	 * Fails if the edge isn't shared by exactly two triangles, or if their opposite corners are
+	 * already joined by an edge.
+	 * Overriding attributes: the loops of the edge (copied from the corners they move to)
+	 */
+	static bool FlipEdge(UBMesh* Mesh, UBMeshEdge* Edge);
+
+	/**
+	 * Remove an edge shared by two different faces, merging them into the first face of the edge.
+	 * Faces that share more than one edge end up using an edge twice.
+	 * Overriding attributes: none
+	 * @retval the merged face, or nullptr if the edge isn't shared by exactly two different faces
+	 */
+	static UBMeshFace* DissolveEdge(UBMesh* Mesh, UBMeshEdge* Edge);
+
+	/**
+	 * Remove a vertex, merging the faces around it into one face. A vertex with two edges is
+	 * removed by joining them into one edge. Fails on vertices with loose edges, with edges shared by
+	 * more than two faces or with more than two boundary edges, and if the two ends of the joined edge
+	 * were already joined by an edge. In the last case the faces around the vertex have been merged.
+	 * Overriding attributes: none
+	 */
+	static bool DissolveVertex(UBMesh* Mesh, UBMeshVertex* Vertex);
+
+	/**
+	 * Whether collapsing the edge keeps the mesh manifold: the only vertices adjacent to both ends
+	 * of the edge must be the opposite corners of the triangles that use it (the link condition).
+	 */
+	static bool CanCollapseEdge(const UBMeshEdge* Edge);
+
+	/**
+	 * Merge the two vertices of an edge into its first vertex, which is moved to Lerp(Vert1, Vert2, t)
+	 * and gets attributes interpolated the same way. The edge and the second vertex are removed.
+	 * Faces using the edge lose a corner, triangles using it are removed, and the edges that end up
+	 * joining the same two vertices are merged.
+	 * Only the neighborhood of the edge is visited. Removed elements are taken out of the containers
+	 * with RemoveFromContainer, so collapse many edges inside a FBMeshDeferredRemovalScope.
+	 * Overriding attributes: all in Vert1
+	 * @retval the kept vertex
+	 */
+	static UBMeshVertex* CollapseEdge(UBMesh* Mesh, UBMeshEdge* Edge, float t = 0.5f);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Decimate]
+
+	struct FDecimateParams
+	{
+		// Stop once the mesh has this many faces or less, ignored if negative
+		int32 TargetFaceCount = -1;
+		// Stop before collapsing an edge whose quadric error is larger than this, ignored if negative
+		float MaxError = -1.0f;
+		// Weight of the planes that hold boundary edges in place, 0 lets boundaries shrink
+		float BoundaryWeight = 1000.0f;
+	};
+
+	/**
+	 * Reduce the number of elements by collapsing edges, cheapest first, with quadric error metrics
+	 * (Garland & Heckbert): each vertex keeps the sum of the squared distances to the planes of its
+	 * faces, and an edge is collapsed to the point minimizing the sum of the quadrics of its vertices.
+	 * Candidate collapses are held in an indexed priority queue and only the edges around the kept
+	 * vertex are updated after each collapse. Collapses that break the link condition or flip a face
+	 * are skipped. Vertex attributes are interpolated at the collapse point with the registered
+	 * interpolators. Faces don't need to be triangles.
+	 * At least one of TargetFaceCount and MaxError must be set.
+	 * @retval number of collapsed edges
+	 */
+	static int32 Decimate(UBMesh* Mesh, const FDecimateParams& Params);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Remesh]
+
+	struct FRemeshParams
+	{
+		// Edge length to aim for, the mean edge length of the mesh if not positive
+		float TargetEdgeLength = -1.0f;
+		int32 Iterations = 5;
+		// Fraction of the way to the center of their neighbors vertices move in each iteration
+		float RelaxationStrength = 0.5f;
+	};
+
+	/**
+	 * Make edge lengths uniform (Botsch & Kobbelt): the mesh is triangulated, then each iteration splits
+	 * edges longer than 4/3 of the target length, collapses edges shorter than 4/5 of it, flips edges
+	 * to bring valences closer to 6 (4 on boundaries), and moves vertices toward the center of their
+	 * neighbors in their tangent plane. Edge selection, valences and relaxation are computed in
+	 * parallel, edits are applied serially. Vertices on boundaries and non-manifold edges never move,
+	 * and vertices aren't projected back onto the original surface, so curved surfaces shrink a bit.
+	 */
+	static void Remesh(UBMesh* Mesh, const FRemeshParams& Params);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Extrude and inset]
+	// Both operators replace the selected faces by copies along new vertices and join the boundary of
+	// each region to its copy with quads. All new elements are added in bulk with FBMeshBuilder.
+
+	/**
+	 * Move faces along their normals, building side walls between them and where they were.
+	 * Vertices shared by faces of a region move along their average normal.
+	 * Overriding attributes: all in the new elements (copied from the faces, corners and vertices
+	 * they come from)
+	 * @retval the moved faces, in the order they were given
+	 */
+	static TArray<UBMeshFace*> ExtrudeFaces(UBMesh* Mesh, TArrayView<UBMeshFace* const> Faces, float Distance, EBMeshFaceRegionMode Mode = EBMeshFaceRegionMode::Region);
+
+	/**
+	 * Shrink faces within their plane, moving the boundary of each region inwards by Thickness and
+	 * filling the gap with a ring of quads. Vertices inside a region don't move.
+	 * Overriding attributes: all in the new elements (copied from the faces, corners and vertices
+	 * they come from)
+	 * @retval the inner faces, in the order they were given
+	 */
+	static TArray<UBMeshFace*> InsetFaces(UBMesh* Mesh, TArrayView<UBMeshFace* const> Faces, float Thickness, EBMeshFaceRegionMode Mode = EBMeshFaceRegionMode::Region);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Dual]
+
+	/**
+	 * Make the dual of a mesh, in a new mesh with the same element classes: each face becomes a vertex
+	 * at its center, and each vertex becomes a face along the centers of the faces around it, in
+	 * order. Vertices whose faces don't form a single fan (non-manifold or inconsistently oriented)
+	 * get no face. The fans are walked in parallel and the dual is built in bulk.
+	 * Overriding attributes: in the dual, vertices get the attributes of their face and faces get the
+	 * attributes of their vertex, paired by name. Boundary edge middles interpolate vertex attributes.
+	 * @retval the dual mesh, with the same outer as the mesh
+	 */
+	static UBMesh* Dual(UBMesh* Mesh, EBMeshDualBoundary Boundary = EBMeshDualBoundary::Clip);
+
+	///////////////////////////////////////////////////////////////////////////
+	// [Delaunay]
+
+	/**
+	 * Add the Delaunay triangulation of 2D points to a mesh, in the XY plane, see FBMeshDelaunay.
+	 * Points get vertices in order, except duplicates skipped by the triangulation, so every vertex
+	 * is used by a triangle.
+	 * Overriding attributes: vertex's id (index of its point), face's id (index of its triangle)
+	 * @retval false if nothing was added, because there are less than 3 points or they are collinear
+	 */
+	static bool Delaunay(UBMesh* Mesh, TArrayView<const FVector2D> Points);
+
+	/**
+	 * Add the Voronoi diagram of 2D points to a mesh, in the XY plane: the dual of their Delaunay
+	 * triangulation, with vertices at the circumcenters of the triangles. Cells of points on the convex
+	 * hull are unbounded and are left out.
+	 * Overriding attributes: face's id (index of its point), vertex's id (index of its Delaunay triangle)
+	 * @retval false if no cell was added
+	 */
+	static bool Voronoi(UBMesh* Mesh, TArrayView<const FVector2D> Points);
+
+	// [Lattices]
+	// Regular grids are generated straight into the mesh's containers: the index of every element
+	// follows from its position in the grid, so no edge has to be looked up while building faces.
+
+	/**
+	 * Add a grid of NumX by NumY square cells to a mesh, in the XY plane and centered on the origin.
+	 * Faces are counterclockwise seen from +Z.
+	 * Overriding attributes: vertex's id (row-major index in the grid), face's id (row-major index in the grid)
+	 * @retval false if nothing was added, because the grid is empty
+	 */
+	static bool SquareGrid(UBMesh* Mesh, int32 NumX, int32 NumY, float CellSize = 1.0f);
+
+	/**
+	 * Add a rectangular patch of equilateral triangles to a mesh, in the XY plane and centered on the origin.
+	 * Rows of vertices are NumX edges long and every other row is shifted by half an edge, so there
+	 * are NumY rows of triangles. Faces are counterclockwise seen from +Z.
+	 * Overriding attributes: vertex's id (index in the grid), face's id (index in the grid)
+	 * @retval false if nothing was added, because the grid is empty
+	 */
+	static bool TriangleGrid(UBMesh* Mesh, int32 NumX, int32 NumY, float CellSize = 1.0f);
+
+	/**
+	 * Add a regular hexagon made of equilateral triangles to a mesh, in the XY plane and centered on
+	 * the origin, with Subdivisions edges along each side (6 * Subdivisions^2 triangles).
+	 * This is the same as subdividing a hexagon of 6 triangles, without building it face by face.
+	 * Faces are counterclockwise seen from +Z.
+	 * Overriding attributes: vertex's id (index in the grid), face's id (index in the grid)
+	 * @retval false if nothing was added, because there are no subdivisions
+	 */
+	static bool HexagonGrid(UBMesh* Mesh, int32 Subdivisions, float CellSize = 1.0f);
 
 	///////////////////////////////////////////////////////////////////////////
 	///
@@ -229,19 +608,33 @@ public:
 	static void DrawPrimitives(TFunction<void(FVector, FVector, FColor)> DrawLine, UBMesh* mesh);
 
 	/**
-	 * Sorts all vertices in the mesh so their indices match their coordinates sorted in XYZ order
+	 * Sorts all vertices in the mesh so their indices match their coordinates sorted by Z, then Y, then X.
+	 * Vertices at the same location keep their order
 	 */
 	static void SortVertices(UBMesh* Mesh);
 
 	/**
-	 * Changes FirstLoop member of each face to point to the vertex with the lowest iid
+	 * Changes FirstLoop member of each face to point to the vertex with the lowest index
 	 */ 
 	static void SortFaceLoops(UBMesh* Mesh);
 
 	/**
-	 * Sorts faces based on their centers
+	 * Sorts faces based on their centers, in the same order as SortVertices
 	 */ 
 	static void SortFacesByCenters(UBMesh* Mesh);
 
+	/**
+	 * Sorts faces by the index of the vertex of their first loop. Faces with the same first vertex
+	 * keep their order. Face ids are left untouched
+	 */
 	static void SortFacesByFirstLoopId(UBMesh* Mesh);
+
+	/**
+	 * Reorders all containers of the mesh so that elements close to each other in space are close in
+	 * memory, which makes later passes over the mesh more cache friendly. Vertices and faces are sorted
+	 * along a Morton (Z-order) curve through their locations and centers, edges follow their first vertex
+	 * in the new order and the loops of each face are stored together, starting at its first loop.
+	 * Only the order of the containers and the indices of elements change, ids are left untouched.
+	 */
+	static void SortSpatially(UBMesh* Mesh);
 };
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBMesh;
+class UBMeshVertex;
+class UBMeshFace;
+
+/**
+ * Result of FBMeshSpatialIndex::Raycast
+ */
+struct FBMeshRayHit
+{
+	UBMeshFace* Face = nullptr;
+	FVector Location = FVector::ZeroVector;
+	float Distance = 0.0f;
+};
+
+/**
+ * Bounding volume hierarchies over the vertex locations and face bounds of a mesh, to answer
+ * nearest point, radius, box overlap and raycast queries without scanning the whole mesh.
+ *
+ * The index keeps a snapshot of the mesh's vertex and face lists:
+ * - after vertices are only moved (e.g. by SquarifyQuads) call Refit, which updates the bounds
+ *   of the existing hierarchy in parallel without rebuilding it.
+ * - after elements are added or removed call Build again.
+ *
+ * Faces are assumed to be planar (or close to it) for nearest point and ray queries, but they may be concave.
+ */
+class BMESH_API FBMeshSpatialIndex
+{
+public:
+	FBMeshSpatialIndex() = default;
+
+	explicit FBMeshSpatialIndex(const UBMesh* Mesh)
+	{
+		Build(Mesh);
+	}
+
+	void Build(const UBMesh* Mesh);
+
+	/**
+	 * Update the hierarchy to match the current vertex locations, keeping its structure.
+	 * Query performance may degrade if vertices moved far from their original positions,
+	 * in which case it's better to Build again.
+	 */
+	void Refit();
+
+	void Reset();
+
+	/**
+	 * @retval the vertex closest to Point, or null if there is none closer than MaxDistance
+	 */
+	UBMeshVertex* FindNearestVertex(const FVector& Point, float MaxDistance = BIG_NUMBER) const;
+
+	/**
+	 * @retval the face with the closest surface to Point, or null if there is none closer than MaxDistance
+	 */
+	UBMeshFace* FindNearestFace(const FVector& Point, float MaxDistance = BIG_NUMBER, FVector* OutClosestPoint = nullptr) const;
+
+	void FindVerticesInRadius(const FVector& Center, float Radius, TArray<UBMeshVertex*>& OutVertices) const;
+
+	/**
+	 * Find the faces whose surface is at most Radius away from Center
+	 */
+	void FindFacesInRadius(const FVector& Center, float Radius, TArray<UBMeshFace*>& OutFaces) const;
+
+	void FindVerticesInBox(const FBox& Box, TArray<UBMeshVertex*>& OutVertices) const;
+
+	/**
+	 * Find the faces whose bounding box overlaps Box
+	 */
+	void FindFacesInBox(const FBox& Box, TArray<UBMeshFace*>& OutFaces) const;
+
+	/**
+	 * Find the first face hit by the ray, from either side
+	 */
+	bool Raycast(const FVector& Start, const FVector& Direction, float MaxDistance, FBMeshRayHit& OutHit) const;
+
+private:
+	struct FNode
+	{
+		FBox Bounds;
+		// First child for inner nodes (the second one always follows it), first primitive for leaves
+		int32 Index;
+		// Number of primitives in leaves, 0 for inner nodes
+		int32 Count;
+	};
+
+	/**
+	 * Hierarchy over a set of primitives, referenced by index. Children are always stored after
+	 * their parent, so refitting only needs a reverse pass over the nodes.
+	 */
+	struct FTree
+	{
+		TArray<FNode> Nodes;
+		TArray<int32> Primitives;
+
+		void Build(TArrayView<const FVector> Centers);
+		template <typename BoundsGetterType>
+		void Refit(BoundsGetterType&& GetBounds);
+		template <typename VisitorType>
+		void ForEachOverlappingLeaf(const FBox& Box, VisitorType&& Visit) const;
+	};
+
+	FTree VertexTree;
+	FTree FaceTree;
+
+	TArray<UBMeshVertex*> Vertices;
+	TArray<UBMeshFace*> Faces;
+
+	// Cached so queries don't have to go through the element objects to cull primitives
+	TArray<FVector> VertexLocations;
+	TArray<FBox> FaceBounds;
+
+	void UpdatePrimitiveBounds();
+};
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 -- Daniel Amthauer
+ * 
+ * Based on BMesh for Unity by Élie Michel (c) 2020, original copyright info included below
+ * as specified by the original license terms. Those terms also apply to this version.
+ */
+
+/*
+ * Copyright (c) 2020 -- Élie Michel <elie@exppad.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBMesh;
+class UBMeshLoop;
+class UBMeshFace;
+
+enum class EBMeshTriangulationMethod : uint8
+{
+	// Handles concave faces, see FBMeshTriangulation::TriangulatePolygon
+	EarClip,
+	// Fan around the first loop of each face, faster but only correct for convex faces
+	Fan,
+};
+
+/**
+ * Triangulation of all the faces of a mesh, with the face corners laid out contiguously, which is
+ * what conversions to engine mesh formats need.
+ * Triangles of a face only reference that face's loops, and keep the face's winding.
+ */
+struct BMESH_API FBMeshTriangulation
+{
+	// Loops of all faces, face after face, each face in cycle order starting from its first loop
+	TArray<UBMeshLoop*> Loops;
+
+	// The loops of face i are in [LoopOffsets[i], LoopOffsets[i + 1]), NumFaces + 1 entries
+	TArray<int32> LoopOffsets;
+
+	// The triangles of face i are in [TriangleOffsets[i], TriangleOffsets[i + 1]), NumFaces + 1 entries
+	TArray<int32> TriangleOffsets;
+
+	// Indices into Loops, faces with N loops get N - 2 triangles
+	TArray<FIntVector> Triangles;
+
+	int32 NumFaces() const { return LoopOffsets.Num() - 1; }
+
+	/**
+	 * Triangulate all faces of a mesh. The output is allocated up front from the faces' VertCount and
+	 * faces are then triangulated in parallel, each one writing to its own range.
+	 */
+	static FBMeshTriangulation Build(const UBMesh* Mesh, EBMeshTriangulationMethod Method = EBMeshTriangulationMethod::EarClip);
+
+	/**
+	 * Triangulate some faces, face i of the triangulation is Faces[i]
+	 */
+	static FBMeshTriangulation Build(TArrayView<UBMeshFace* const> Faces, EBMeshTriangulationMethod Method = EBMeshTriangulationMethod::EarClip);
+
+	/**
+	 * Triangulate a polygon by ear clipping, after projecting it on the plane of its Newell normal, so
+	 * concave polygons and slightly non planar ones are handled. If no ear can be found (e.g. the
+	 * polygon self intersects or is degenerate) the rest of the polygon is triangulated as a fan.
+	 * @param Polygon corner positions, in winding order
+	 * @param OutTriangles Polygon.Num() - 2 triangles, as indices into Polygon
+	 */
+	static void TriangulatePolygon(TArrayView<const FVector> Polygon, TArrayView<FIntVector> OutTriangles);
+};
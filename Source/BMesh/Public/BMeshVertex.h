@@ -60,6 +60,16 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	UBMeshEdge* Edge;
 
+	// Position in the mesh's Vertices, kept up to date by the mesh (see UBMesh::AddToContainer),
+	// INDEX_NONE when not in a mesh. Unlike Id it's not an attribute and isn't meant to be written
+	int32 Index = INDEX_NONE;
+
+	UFUNCTION(BlueprintPure, Category = "BMesh|Vertex")
+	int32 GetIndex() const { return Index; }
+
+	// Slot of the handles to this vertex, managed by the mesh (see FBMeshVertexHandle)
+	int32 Slot = INDEX_NONE;
+
 	/**
      * List all edges reaching this vertex.
      */
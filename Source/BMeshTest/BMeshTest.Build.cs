@@ -70,6 +70,8 @@ public class BMeshTest : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"BMesh",
+				"MeshDescription",
+				"StaticMeshDescription",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
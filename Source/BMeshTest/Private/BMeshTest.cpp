@@ -32,9 +32,21 @@
 
 #include "PrimitiveSceneProxy.h"
 #include "SceneManagement.h"
+#include "MeshDescription.h"
+#include "Serialization/ObjectWriter.h"
+#include "Serialization/ObjectReader.h"
+#include "Misc/FileHelper.h"
 
 #include "BMeshCore.h"
 #include "BMeshOperators.h"
+#include "BMeshFaceAutomaton.h"
+#include "BMeshSpatialIndex.h"
+#include "BMeshDelaunay.h"
+#include "BMeshMappedFile.h"
+#include "BMeshFileIO.h"
+#include "BMeshTriangulation.h"
+#include "BMeshConversion.h"
+#include "BMeshCustomVersion.h"
 
 // Sets default values for this component's properties
 UBMeshTestComponent::UBMeshTestComponent()
@@ -351,6 +363,1757 @@ void UBMeshTestComponent::CustomClassLerpTest()
 	MarkRenderStateDirty();
 }
 
+void UBMeshTestComponent::FaceAutomatonTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	// Enough faces for the automaton to evaluate several batches in parallel
+	FBMeshOperators::SquareGrid(TestBMesh, 48, 48);
+	const int32 NumFaces = TestBMesh->Faces.Num();
+
+	// Edge neighbors straight from the topology, as the serial reference
+	TArray<TArray<int32>> ReferenceNeighbors;
+	ReferenceNeighbors.SetNum(NumFaces);
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			for (const UBMeshFace* Neighbor : Loop->Edge->NeighborFacesRange())
+			{
+				if (Neighbor != Face)
+					ReferenceNeighbors[Face->Index].AddUnique(Neighbor->Index);
+			}
+		}
+	}
+
+	const FBMeshFaceAdjacency Adjacency = FBMeshFaceAdjacency::Build(TestBMesh, EBMeshFaceAdjacency::Edge);
+	ensureMsgf(Adjacency.Num() == NumFaces && Adjacency.Offsets.Num() == NumFaces + 1, TEXT("one row per face"));
+	for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+	{
+		const TArrayView<const int32> Neighbors = Adjacency.GetNeighbors(FaceIndex);
+		bool bSameNeighbors = Neighbors.Num() == ReferenceNeighbors[FaceIndex].Num();
+		for (const int32 Neighbor : Neighbors)
+		{
+			bSameNeighbors &= ReferenceNeighbors[FaceIndex].Contains(Neighbor);
+		}
+		if (!ensureMsgf(bSameNeighbors, TEXT("adjacency row of face %d matches its edge neighbors"), FaceIndex))
+			break;
+	}
+
+	// Spread from one face: a face is reached once it or one of its neighbors was reached
+	auto Spread = [](int32 FaceIndex, const uint8& Current, TArrayView<const int32> Neighbors, TArrayView<const uint8> State) -> uint8
+	{
+		uint8 Reached = Current;
+		for (const int32 Neighbor : Neighbors)
+		{
+			Reached |= State[Neighbor];
+		}
+		return Reached;
+	};
+	TBMeshFaceAutomaton<uint8> Automaton(Adjacency, 0);
+	TArray<uint8> Reference;
+	Reference.Init(0, NumFaces);
+	// Seed near the middle of the grid so the spread doesn't reach its border
+	FVector GridCenter = FVector::ZeroVector;
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		GridCenter += Face->Center() / NumFaces;
+	}
+	int32 Seed = 0;
+	for (int32 FaceIndex = 1; FaceIndex < NumFaces; ++FaceIndex)
+	{
+		if (FVector::DistSquared(TestBMesh->Faces[FaceIndex]->Center(), GridCenter) < FVector::DistSquared(TestBMesh->Faces[Seed]->Center(), GridCenter))
+			Seed = FaceIndex;
+	}
+	Automaton.GetCurrentMutable()[Seed] = 1;
+	Reference[Seed] = 1;
+
+	const int32 NumSteps = 10;
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		const TArray<uint8> Before(Automaton.GetCurrent());
+		const uint8* CurrentData = Automaton.GetCurrent().GetData();
+		Automaton.Evaluate(Spread);
+		ensureMsgf(Automaton.GetCurrent().GetData() == CurrentData && TArray<uint8>(Automaton.GetCurrent()) == Before, TEXT("current buffer isn't written during a step"));
+		Automaton.SwapBuffers();
+		ensureMsgf(Automaton.GetCurrent().GetData() != CurrentData, TEXT("swapping exposes the other buffer"));
+
+		TArray<uint8> Next = Reference;
+		for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+		{
+			for (const int32 Neighbor : ReferenceNeighbors[FaceIndex])
+			{
+				Next[FaceIndex] |= Reference[Neighbor];
+			}
+		}
+		Reference = MoveTemp(Next);
+		if (!ensureMsgf(TArray<uint8>(Automaton.GetCurrent()) == Reference, TEXT("automaton matches the serial reference after step %d"), Step + 1))
+			break;
+	}
+
+	// After N steps exactly the faces within N edge steps of the seed are reached, a diamond on the grid
+	int32 NumReached = 0;
+	for (const uint8 Reached : Automaton.GetCurrent())
+	{
+		NumReached += Reached;
+	}
+	ensureMsgf(NumReached == 2 * NumSteps * (NumSteps + 1) + 1, TEXT("spread covers a diamond (found count: %d)"), NumReached);
+
+	UE_LOG(LogTemp, Log, TEXT("Face automaton test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::ConnectedComponentsTest()
+{
+	TestBMesh = UBMesh::Make(this);
+
+	UBMeshVertex* v0 = TestBMesh->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = TestBMesh->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = TestBMesh->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = TestBMesh->AddVertex(FVector(1, 0, -1));
+	TestBMesh->AddFace(v0, v1, v2);
+	TestBMesh->AddFace(v2, v1, v3);
+
+	UBMeshVertex* v4 = TestBMesh->AddVertex(FVector(3, 0, -1));
+	UBMeshVertex* v5 = TestBMesh->AddVertex(FVector(3, 0, 1));
+	UBMeshVertex* v6 = TestBMesh->AddVertex(FVector(4, 0, 0));
+	TestBMesh->AddFace(v4, v5, v6);
+
+	FBMeshConnectedComponents VertexComponents = FBMeshOperators::ComputeConnectedComponents(TestBMesh, EBMeshConnectivity::Vertex);
+	ensureMsgf(VertexComponents.Num() == 2, TEXT("vertex component count (found count: %d)"), VertexComponents.Num());
+	ensureMsgf(VertexComponents.ComponentIds.Num() == 7, TEXT("one vertex component id per vertex"));
+	ensureMsgf(VertexComponents.ComponentSizes[0] == 4 && VertexComponents.ComponentSizes[1] == 3, TEXT("vertex component sizes"));
+	ensureMsgf(VertexComponents.ComponentIds[0] == 0 && VertexComponents.ComponentIds[6] == 1, TEXT("vertex component ids"));
+
+	FBMeshConnectedComponents EdgeComponents = FBMeshOperators::ComputeConnectedComponents(TestBMesh, EBMeshConnectivity::Edge);
+	ensureMsgf(EdgeComponents.Num() == 2, TEXT("edge component count (found count: %d)"), EdgeComponents.Num());
+	ensureMsgf(EdgeComponents.ComponentSizes[0] == 5 && EdgeComponents.ComponentSizes[1] == 3, TEXT("edge component sizes"));
+
+	FBMeshConnectedComponents FaceComponents = FBMeshOperators::ComputeConnectedComponents(TestBMesh, EBMeshConnectivity::Face);
+	ensureMsgf(FaceComponents.Num() == 2, TEXT("face component count (found count: %d)"), FaceComponents.Num());
+	ensureMsgf(FaceComponents.ComponentSizes[0] == 2 && FaceComponents.ComponentSizes[1] == 1, TEXT("face component sizes"));
+
+	// Removing the shared edge removes both faces that used it, along with the edges only they used,
+	// so the first four vertices end up isolated
+	TestBMesh->RemoveEdge(TestBMesh->FindEdge(v1, v2));
+	FaceComponents = FBMeshOperators::ComputeConnectedComponents(TestBMesh, EBMeshConnectivity::Face);
+	ensureMsgf(FaceComponents.Num() == 1, TEXT("face component count after removing edge (found count: %d)"), FaceComponents.Num());
+	VertexComponents = FBMeshOperators::ComputeConnectedComponents(TestBMesh, EBMeshConnectivity::Vertex);
+	ensureMsgf(VertexComponents.Num() == 5, TEXT("vertex component count after removing edge (found count: %d)"), VertexComponents.Num());
+
+	UE_LOG(LogTemp, Log, TEXT("Connected components test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::SpatialIndexTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	// 160 x 160 grid in the XY plane, centered on the origin
+	FBMeshOperators::SquareGrid(TestBMesh, 16, 16, 10.0f);
+
+	// A vertical ray starting right above a grid line lies on the slab planes of the cells along it
+	{
+		const FBMeshSpatialIndex Index(TestBMesh);
+		FBMeshRayHit Hit;
+		ensureMsgf(Index.Raycast(FVector(-50, -75, 10), FVector(0, 0, -1), 100, Hit) && FMath::IsNearlyEqual(Hit.Distance, 10.0f, 0.001f),
+			TEXT("axis aligned ray starting on a slab plane hits the grid"));
+		ensureMsgf(!Index.Raycast(FVector(-50, -75, 10), FVector(0, 0, 1), 100, Hit), TEXT("ray going away from the grid misses it"));
+	}
+
+	// Jitter the inner vertices so cells are no longer axis aligned
+	FRandomStream Random(28);
+	for (UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		if (FMath::Abs(Vertex->Location.X) < 79 && FMath::Abs(Vertex->Location.Y) < 79)
+			Vertex->Location += FVector(Random.FRandRange(-2, 2), Random.FRandRange(-2, 2), 0);
+	}
+
+	auto SameElements = [](const auto& A, const auto& B)
+	{
+		if (A.Num() != B.Num())
+			return false;
+		for (const auto* Element : A)
+		{
+			if (!B.Contains(Element))
+				return false;
+		}
+		return true;
+	};
+
+	// Answers of the index against a scan of the mesh's current locations
+	auto CheckQueries = [&](const FBMeshSpatialIndex& Index, const TCHAR* Label)
+	{
+		FRandomStream Queries(2800);
+		for (int32 i = 0; i < 64; ++i)
+		{
+			const FVector Point(Queries.FRandRange(-100, 100), Queries.FRandRange(-100, 100), Queries.FRandRange(-20, 20));
+			const float Radius = Queries.FRandRange(1, 30);
+			const FBox Box = FBox::BuildAABB(Point, FVector(Queries.FRandRange(1, 20), Queries.FRandRange(1, 20), 25));
+
+			double NearestDistSquared = BIG_NUMBER;
+			TArray<UBMeshVertex*> ExpectedInRadius;
+			TArray<UBMeshVertex*> ExpectedVerticesInBox;
+			for (UBMeshVertex* Vertex : TestBMesh->Vertices)
+			{
+				const double DistSquared = FVector::DistSquared(Vertex->Location, Point);
+				NearestDistSquared = FMath::Min(NearestDistSquared, DistSquared);
+				if (DistSquared <= Radius * Radius)
+					ExpectedInRadius.Add(Vertex);
+				if (Box.IsInsideOrOn(Vertex->Location))
+					ExpectedVerticesInBox.Add(Vertex);
+			}
+			TArray<UBMeshFace*> ExpectedFacesInBox;
+			for (UBMeshFace* Face : TestBMesh->Faces)
+			{
+				FBox FaceBox(ForceInit);
+				for (const UBMeshVertex* Vertex : Face->Vertices())
+				{
+					FaceBox += Vertex->Location;
+				}
+				if (FaceBox.Intersect(Box))
+					ExpectedFacesInBox.Add(Face);
+			}
+
+			const UBMeshVertex* Nearest = Index.FindNearestVertex(Point);
+			if (!ensureMsgf(Nearest && FMath::IsNearlyEqual((float)FVector::DistSquared(Nearest->Location, Point), (float)NearestDistSquared, 0.1f), TEXT("nearest vertex matches a scan (%s)"), Label))
+				return;
+			TArray<UBMeshVertex*> InRadius;
+			Index.FindVerticesInRadius(Point, Radius, InRadius);
+			if (!ensureMsgf(SameElements(InRadius, ExpectedInRadius), TEXT("vertices in radius match a scan (%s)"), Label))
+				return;
+			TArray<UBMeshVertex*> VerticesInBox;
+			Index.FindVerticesInBox(Box, VerticesInBox);
+			if (!ensureMsgf(SameElements(VerticesInBox, ExpectedVerticesInBox), TEXT("vertices in box match a scan (%s)"), Label))
+				return;
+			TArray<UBMeshFace*> FacesInBox;
+			Index.FindFacesInBox(Box, FacesInBox);
+			if (!ensureMsgf(SameElements(FacesInBox, ExpectedFacesInBox), TEXT("faces in box match a scan (%s)"), Label))
+				return;
+
+			// The grid is planar and covers the inner region, so both the nearest surface and ray hits are known
+			const FVector Inner(Queries.FRandRange(-60, 60), Queries.FRandRange(-60, 60), Queries.FRandRange(1, 20));
+			FVector ClosestPoint;
+			const UBMeshFace* NearestFace = Index.FindNearestFace(Inner, BIG_NUMBER, &ClosestPoint);
+			if (!ensureMsgf(NearestFace && ClosestPoint.Equals(FVector(Inner.X, Inner.Y, 0), 0.01f), TEXT("nearest face is right below the point (%s)"), Label))
+				return;
+			const FVector Direction(Queries.FRandRange(-0.5f, 0.5f), Queries.FRandRange(-0.5f, 0.5f), -1);
+			const FVector Target = Inner + Direction * Inner.Z;
+			FBMeshRayHit Hit;
+			if (!ensureMsgf(Index.Raycast(Inner, Direction, 1000, Hit) && Hit.Location.Equals(Target, 0.01f), TEXT("ray hits the grid where it crosses its plane (%s)"), Label))
+				return;
+			if (!ensureMsgf(!Index.Raycast(Inner, Direction, Hit.Distance * 0.9f, Hit), TEXT("ray stops at its max distance (%s)"), Label))
+				return;
+		}
+	};
+
+	FBMeshSpatialIndex Index(TestBMesh);
+	CheckQueries(Index, TEXT("build"));
+
+	// Moving vertices only needs a refit, which must answer like a new hierarchy
+	FBMeshOperators::FSquarifyQuadsParams Params;
+	Params.bNormalIsUp = true;
+	Params.Iterations = 4;
+	FBMeshOperators::SquarifyQuads(TestBMesh, Params);
+	for (UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		Vertex->Location.Z = 0;
+	}
+	Index.Refit();
+	CheckQueries(Index, TEXT("refit"));
+	const FBMeshSpatialIndex Rebuilt(TestBMesh);
+	CheckQueries(Rebuilt, TEXT("rebuild"));
+
+	FRandomStream Probes(2801);
+	for (int32 i = 0; i < 64; ++i)
+	{
+		const FVector Point(Probes.FRandRange(-60, 60), Probes.FRandRange(-60, 60), Probes.FRandRange(1, 20));
+		FBMeshRayHit RefitHit, RebuiltHit;
+		Index.Raycast(Point, FVector(0, 0, -1), 100, RefitHit);
+		Rebuilt.Raycast(Point, FVector(0, 0, -1), 100, RebuiltHit);
+		if (!ensureMsgf(RefitHit.Face && RefitHit.Face == RebuiltHit.Face, TEXT("refit and rebuilt hierarchies hit the same face")))
+			break;
+		if (!ensureMsgf(Index.FindNearestFace(Point) == Rebuilt.FindNearestFace(Point), TEXT("refit and rebuilt hierarchies find the same nearest face")))
+			break;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Spatial index test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::WeldVerticesTest()
+{
+	TestBMesh = UBMesh::Make(this);
+
+	// Two separate triangles whose shared side was generated twice
+	UBMeshVertex* v0 = TestBMesh->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = TestBMesh->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = TestBMesh->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = TestBMesh->AddVertex(FVector(1.0001f, 0, 1));
+	UBMeshVertex* v4 = TestBMesh->AddVertex(FVector(-1, 0, 1.0001f));
+	UBMeshVertex* v5 = TestBMesh->AddVertex(FVector(1, 0, -1));
+	TestBMesh->AddFace(v0, v1, v2);
+	TestBMesh->AddFace(v3, v4, v5);
+
+	const int32 NumWelded = FBMeshOperators::WeldVertices(TestBMesh, 0.01f);
+	ensureMsgf(NumWelded == 2, TEXT("welded vertex count (found count: %d)"), NumWelded);
+	ensureMsgf(TestBMesh->Vertices.Num() == 4, TEXT("vert count after welding"));
+	ensureMsgf(TestBMesh->Loops.Num() == 6, TEXT("loop count after welding"));
+	ensureMsgf(TestBMesh->Edges.Num() == 5, TEXT("edge count after welding"));
+	ensureMsgf(TestBMesh->Faces.Num() == 2, TEXT("face count after welding"));
+	ensureMsgf(v1->NeighborFaces().Num() == 2, TEXT("v1 has two neighbor faces after welding"));
+
+	UBMeshEdge* Shared = TestBMesh->FindEdge(v1, v2);
+	ensureMsgf(Shared != nullptr && Shared->NeighborFaces().Num() == 2, TEXT("shared edge is used by both faces"));
+	for (UBMeshLoop* l : TestBMesh->Loops)
+	{
+		ensureMsgf(l->Edge->ContainsVertex(l->Vert), TEXT("loop vertex is in loop edge"));
+		ensureMsgf(l->Edge->ContainsVertex(l->Next->Vert), TEXT("next loop vertex is in loop edge"));
+		ensureMsgf(l->RadialNext->RadialPrev == l, TEXT("loop has consistent radial next"));
+	}
+
+	// Welding the whole shared side into one point collapses both triangles
+	v2->Location = v1->Location;
+	FBMeshOperators::WeldVertices(TestBMesh, 0.01f);
+	ensureMsgf(TestBMesh->Vertices.Num() == 3, TEXT("vert count after collapsing"));
+	ensureMsgf(TestBMesh->Faces.Num() == 0, TEXT("face count after collapsing"));
+	ensureMsgf(TestBMesh->Loops.Num() == 0, TEXT("loop count after collapsing"));
+	ensureMsgf(TestBMesh->Edges.Num() == 0, TEXT("edges of the collapsed faces are removed with them"));
+
+	auto CheckNoRepeatedVertex = [this]()
+	{
+		for (const UBMeshFace* Face : TestBMesh->Faces)
+		{
+			TSet<const UBMeshVertex*> FaceVertices;
+			for (const UBMeshLoop* Loop : Face->Loops())
+			{
+				bool bAlreadyInFace = false;
+				FaceVertices.Add(Loop->Vert, &bAlreadyInFace);
+				ensureMsgf(!bAlreadyInFace, TEXT("no face repeats a vertex after welding"));
+				ensureMsgf(Loop->Face == Face && Loop->Next->Prev == Loop && Loop->Edge->ContainsVertex(Loop->Next->Vert), TEXT("welded face is consistent"));
+			}
+			ensureMsgf(FaceVertices.Num() == Face->VertCount, TEXT("welded face vertex count"));
+		}
+	};
+
+	// Welding a quad across its diagonal leaves two sided parts only, so the face is removed
+	TestBMesh = UBMesh::Make(this);
+	TestBMesh->AddFace({
+		TestBMesh->AddVertex(FVector(0, 0, 0)),
+		TestBMesh->AddVertex(FVector(1, 0, 0)),
+		TestBMesh->AddVertex(FVector(0.001f, 0.001f, 0)),
+		TestBMesh->AddVertex(FVector(0, 1, 0)),
+	});
+	ensureMsgf(FBMeshOperators::WeldVertices(TestBMesh, 0.01f) == 1, TEXT("diagonal corners are welded"));
+	CheckNoRepeatedVertex();
+	ensureMsgf(TestBMesh->Vertices.Num() == 3 && TestBMesh->Faces.Num() == 0 && TestBMesh->Loops.Num() == 0 && TestBMesh->Edges.Num() == 0, TEXT("quad welded across its diagonal is removed"));
+
+	// Welding a hexagon across its middle splits it into two triangles
+	TestBMesh = UBMesh::Make(this);
+	TestBMesh->AddFace({
+		TestBMesh->AddVertex(FVector(0, 0, 0)),
+		TestBMesh->AddVertex(FVector(1, -1, 0)),
+		TestBMesh->AddVertex(FVector(1, 1, 0)),
+		TestBMesh->AddVertex(FVector(0.001f, 0, 0)),
+		TestBMesh->AddVertex(FVector(-1, 1, 0)),
+		TestBMesh->AddVertex(FVector(-1, -1, 0)),
+	});
+	ensureMsgf(FBMeshOperators::WeldVertices(TestBMesh, 0.01f) == 1, TEXT("opposite corners are welded"));
+	CheckNoRepeatedVertex();
+	ensureMsgf(TestBMesh->Vertices.Num() == 5 && TestBMesh->Edges.Num() == 6 && TestBMesh->Loops.Num() == 6 && TestBMesh->Faces.Num() == 2, TEXT("hexagon welded across its middle becomes two triangles"));
+
+	UE_LOG(LogTemp, Log, TEXT("Weld vertices test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::MergeTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	UBMesh* Quad = UBMesh::Make(this, Params);
+	UBMeshVertex* v0 = Quad->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = Quad->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = Quad->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = Quad->AddVertex(FVector(1, 0, -1));
+	Cast<UBMeshVertex_Test>(v2)->Color = FLinearColor::Red;
+	Quad->AddFace(v0, v1, v2, v3);
+
+	UBMesh* Triangle = UBMesh::Make(this);
+	Triangle->AddFace(Triangle->AddVertex(FVector(2, 0, -1)), Triangle->AddVertex(FVector(2, 0, 1)), Triangle->AddVertex(FVector(3, 0, 0)));
+
+	TestBMesh = UBMesh::Make(this, Params);
+	UBMesh* Others[] = { Quad, Triangle };
+	FBMeshOperators::Merge(TestBMesh, Others);
+
+	ensureMsgf(TestBMesh->Vertices.Num() == 7, TEXT("vert count after merging"));
+	ensureMsgf(TestBMesh->Edges.Num() == 7, TEXT("edge count after merging"));
+	ensureMsgf(TestBMesh->Loops.Num() == 7, TEXT("loop count after merging"));
+	ensureMsgf(TestBMesh->Faces.Num() == 2, TEXT("face count after merging"));
+	ensureMsgf(Quad->Vertices.Num() == 4 && Triangle->Vertices.Num() == 3, TEXT("merged meshes are not modified"));
+	ensureMsgf(Cast<UBMeshVertex_Test>(TestBMesh->Vertices[2])->Color == FLinearColor::Red, TEXT("vertex attribute is copied"));
+	ensureMsgf(TestBMesh->Vertices[2]->Location == v2->Location, TEXT("vertex location is copied"));
+
+	for (UBMeshLoop* l : TestBMesh->Loops)
+	{
+		ensureMsgf(TestBMesh->Faces.Contains(l->Face), TEXT("loop face belongs to the merged mesh"));
+		ensureMsgf(TestBMesh->Edges.Contains(l->Edge), TEXT("loop edge belongs to the merged mesh"));
+		ensureMsgf(l->Edge->ContainsVertex(l->Vert), TEXT("loop vertex is in loop edge"));
+		ensureMsgf(l->Next->Prev == l, TEXT("loop has consistent next"));
+	}
+	for (UBMeshEdge* e : TestBMesh->Edges)
+	{
+		ensureMsgf(TestBMesh->Vertices.Contains(e->Vert1) && TestBMesh->Vertices.Contains(e->Vert2), TEXT("edge vertices belong to the merged mesh"));
+	}
+	ensureMsgf(TestBMesh->FindEdge(TestBMesh->Vertices[0], TestBMesh->Vertices[1]) != nullptr, TEXT("disk cycles are copied"));
+
+	UE_LOG(LogTemp, Log, TEXT("Merge test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::CloneTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	UBMesh* Base = UBMesh::Make(this, Params);
+	UBMeshVertex* v0 = Base->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = Base->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = Base->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = Base->AddVertex(FVector(1, 0, -1));
+	Cast<UBMeshVertex_Test>(v1)->Color = FLinearColor::Green;
+	Base->AddFace(v0, v1, v2);
+	Base->AddFace(v2, v1, v3);
+
+	TestBMesh = Base->Clone(this);
+	ensureMsgf(TestBMesh != Base && TestBMesh->GetOuter() == this, TEXT("clone is a new mesh"));
+	ensureMsgf(TestBMesh->VertexClass == Base->VertexClass, TEXT("clone has the same vertex class"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 4 && TestBMesh->Edges.Num() == 5 && TestBMesh->Loops.Num() == 6 && TestBMesh->Faces.Num() == 2, TEXT("clone element counts"));
+	ensureMsgf(Cast<UBMeshVertex_Test>(TestBMesh->Vertices[1])->Color == FLinearColor::Green, TEXT("vertex attribute is cloned"));
+
+	UBMeshEdge* Shared = TestBMesh->FindEdge(TestBMesh->Vertices[1], TestBMesh->Vertices[2]);
+	ensureMsgf(Shared != nullptr && Shared->NeighborFaces().Num() == 2, TEXT("radial cycles are cloned"));
+
+	// Editing the clone leaves the base untouched
+	TestBMesh->RemoveFace(TestBMesh->Faces[0]);
+	ensureMsgf(Base->Faces.Num() == 2 && v1->NeighborFaces().Num() == 2, TEXT("base is not affected by the clone"));
+
+	// Cloning a large mesh against rebuilding it element by element, which looks up every edge
+	UBMesh* Large = UBMesh::Make(this);
+	FBMeshOperators::SquareGrid(Large, 200, 200);
+
+	double StartTime = FPlatformTime::Seconds();
+	UBMesh* LargeClone = Large->Clone(this);
+	const double CloneTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	UBMesh* Rebuilt = UBMesh::Make(this);
+	for (const UBMeshVertex* Vertex : Large->Vertices)
+	{
+		Rebuilt->AddVertex(Vertex->Location);
+	}
+	TArray<UBMeshVertex*> FaceVertices;
+	for (const UBMeshFace* Face : Large->Faces)
+	{
+		FaceVertices.Reset();
+		for (const UBMeshVertex* Vertex : Face->Vertices())
+		{
+			FaceVertices.Add(Rebuilt->Vertices[Vertex->Index]);
+		}
+		Rebuilt->AddFace(FaceVertices);
+	}
+	const double RebuildTime = FPlatformTime::Seconds() - StartTime;
+
+	ensureMsgf(LargeClone->Vertices.Num() == Rebuilt->Vertices.Num() && LargeClone->Edges.Num() == Rebuilt->Edges.Num()
+		&& LargeClone->Loops.Num() == Rebuilt->Loops.Num() && LargeClone->Faces.Num() == Rebuilt->Faces.Num(), TEXT("clone has the same element counts as a rebuild"));
+	for (int32 FaceIndex = 0; FaceIndex < Large->Faces.Num(); ++FaceIndex)
+	{
+		const UBMeshLoop* CloneLoop = LargeClone->Faces[FaceIndex]->FirstLoop;
+		const UBMeshLoop* RebuiltLoop = Rebuilt->Faces[FaceIndex]->FirstLoop;
+		bool bSameFace = LargeClone->Faces[FaceIndex]->VertCount == Rebuilt->Faces[FaceIndex]->VertCount;
+		for (int32 Corner = 0; bSameFace && Corner < Rebuilt->Faces[FaceIndex]->VertCount; ++Corner)
+		{
+			bSameFace = CloneLoop->Vert->Index == RebuiltLoop->Vert->Index && CloneLoop->Edge->NeighborFaces().Num() == RebuiltLoop->Edge->NeighborFaces().Num();
+			CloneLoop = CloneLoop->Next;
+			RebuiltLoop = RebuiltLoop->Next;
+		}
+		if (!ensureMsgf(bSameFace, TEXT("cloned face %d matches the rebuilt one"), FaceIndex))
+			break;
+	}
+	UE_LOG(LogTemp, Log, TEXT("Cloning %d faces took %.2f ms, rebuilding them with AddVertex/AddFace took %.2f ms"),
+		Large->Faces.Num(), CloneTime * 1000.0, RebuildTime * 1000.0);
+
+	UE_LOG(LogTemp, Log, TEXT("Clone test passed."));
+
+	MarkRenderStateDirty();
+}
+
+namespace
+{
+	/**
+	 * Memory archives that save and load meshes like a package does, so UBMesh::Serialize takes its
+	 * packed path. Element pointers are written as raw pointers, as in any FObjectWriter.
+	 */
+	class FPackageLikeWriter : public FObjectWriter
+	{
+	public:
+		explicit FPackageLikeWriter(TArray<uint8>& InBytes)
+			: FObjectWriter(InBytes)
+		{
+			SetIsPersistent(true);
+			SetWantBinaryPropertySerialization(false);
+		}
+	};
+
+	class FPackageLikeReader : public FObjectReader
+	{
+	public:
+		explicit FPackageLikeReader(TArray<uint8>& InBytes)
+			: FObjectReader(InBytes)
+		{
+			SetIsPersistent(true);
+			SetWantBinaryPropertySerialization(false);
+		}
+	};
+
+	template <typename T>
+	int32 IndexOrNone(const T* Element)
+	{
+		return Element ? Element->Index : INDEX_NONE;
+	}
+
+	/**
+	 * Whether two meshes have the same elements in the same order, linked the same way
+	 */
+	bool HasSameTopology(const UBMesh* A, const UBMesh* B)
+	{
+		if (A->Vertices.Num() != B->Vertices.Num() || A->Edges.Num() != B->Edges.Num()
+			|| A->Loops.Num() != B->Loops.Num() || A->Faces.Num() != B->Faces.Num())
+			return false;
+		for (int32 i = 0; i < A->Vertices.Num(); ++i)
+		{
+			const UBMeshVertex* VertexA = A->Vertices[i];
+			const UBMeshVertex* VertexB = B->Vertices[i];
+			if (VertexA->Id != VertexB->Id || VertexA->Location != VertexB->Location || IndexOrNone(VertexA->Edge) != IndexOrNone(VertexB->Edge))
+				return false;
+		}
+		for (int32 i = 0; i < A->Edges.Num(); ++i)
+		{
+			const UBMeshEdge* EdgeA = A->Edges[i];
+			const UBMeshEdge* EdgeB = B->Edges[i];
+			if (EdgeA->Id != EdgeB->Id || IndexOrNone(EdgeA->Vert1) != IndexOrNone(EdgeB->Vert1) || IndexOrNone(EdgeA->Vert2) != IndexOrNone(EdgeB->Vert2)
+				|| IndexOrNone(EdgeA->Next1) != IndexOrNone(EdgeB->Next1) || IndexOrNone(EdgeA->Next2) != IndexOrNone(EdgeB->Next2)
+				|| IndexOrNone(EdgeA->Prev1) != IndexOrNone(EdgeB->Prev1) || IndexOrNone(EdgeA->Prev2) != IndexOrNone(EdgeB->Prev2)
+				|| IndexOrNone(EdgeA->Loop) != IndexOrNone(EdgeB->Loop))
+				return false;
+		}
+		for (int32 i = 0; i < A->Loops.Num(); ++i)
+		{
+			const UBMeshLoop* LoopA = A->Loops[i];
+			const UBMeshLoop* LoopB = B->Loops[i];
+			if (IndexOrNone(LoopA->Vert) != IndexOrNone(LoopB->Vert) || IndexOrNone(LoopA->Edge) != IndexOrNone(LoopB->Edge)
+				|| IndexOrNone(LoopA->Face) != IndexOrNone(LoopB->Face) || IndexOrNone(LoopA->RadialPrev) != IndexOrNone(LoopB->RadialPrev)
+				|| IndexOrNone(LoopA->RadialNext) != IndexOrNone(LoopB->RadialNext) || IndexOrNone(LoopA->Prev) != IndexOrNone(LoopB->Prev)
+				|| IndexOrNone(LoopA->Next) != IndexOrNone(LoopB->Next))
+				return false;
+		}
+		for (int32 i = 0; i < A->Faces.Num(); ++i)
+		{
+			const UBMeshFace* FaceA = A->Faces[i];
+			const UBMeshFace* FaceB = B->Faces[i];
+			if (FaceA->Id != FaceB->Id || FaceA->VertCount != FaceB->VertCount || IndexOrNone(FaceA->FirstLoop) != IndexOrNone(FaceB->FirstLoop))
+				return false;
+		}
+		return true;
+	}
+}
+
+void UBMeshTestComponent::SerializationTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	UBMesh* Source = UBMesh::Make(this, Params);
+	FBMeshOperators::SquareGrid(Source, 3, 2);
+	Source->AddEdge(Source->AddVertex(FVector(10, 0, 0)), Source->AddVertex(FVector(11, 0, 0)));
+	for (UBMeshVertex* Vertex : Source->Vertices)
+	{
+		Cast<UBMeshVertex_Test>(Vertex)->Color = FLinearColor(Vertex->Location.X, Vertex->Location.Y, 0);
+	}
+	Source->Edges[4]->Id = 42;
+
+	// Saved like a package: packed topology and attribute columns
+	TArray<uint8> Bytes;
+	FPackageLikeWriter Writer(Bytes);
+	Source->Serialize(Writer);
+	ensureMsgf(!Writer.IsError() && Writer.CustomVer(FBMeshCustomVersion::GUID) == FBMeshCustomVersion::LatestVersion, TEXT("mesh is saved with the latest version"));
+
+	UBMesh* Loaded = UBMesh::Make(this);
+	{
+		FPackageLikeReader Reader(Bytes);
+		Reader.SetCustomVersions(Writer.GetCustomVersions());
+		Loaded->Serialize(Reader);
+		ensureMsgf(!Reader.IsError() && Reader.AtEnd(), TEXT("packed mesh is loaded entirely"));
+	}
+	ensureMsgf(Loaded->VertexClass == Source->VertexClass, TEXT("loaded mesh has the saved vertex class"));
+	ensureMsgf(HasSameTopology(Source, Loaded), TEXT("packed topology and ids are restored"));
+	bool bSameColors = Loaded->Vertices.Num() == Source->Vertices.Num();
+	for (int32 i = 0; bSameColors && i < Source->Vertices.Num(); ++i)
+	{
+		const UBMeshVertex_Test* Vertex = Cast<UBMeshVertex_Test>(Loaded->Vertices[i]);
+		bSameColors = Vertex && Vertex->Color == Cast<UBMeshVertex_Test>(Source->Vertices[i])->Color && Vertex->GetOuter() == Loaded;
+	}
+	ensureMsgf(bSameColors, TEXT("attribute columns are restored on new elements"));
+
+	// Assets saved before the packed format store the elements through their tagged properties
+	TArray<uint8> LegacyBytes;
+	{
+		FPackageLikeWriter LegacyWriter(LegacyBytes);
+		// Not persistent, so the mesh only writes its tagged properties
+		LegacyWriter.SetIsPersistent(false);
+		Source->Serialize(LegacyWriter);
+	}
+	UBMesh* Legacy = UBMesh::Make(this);
+	{
+		FPackageLikeReader Reader(LegacyBytes);
+		Reader.SetCustomVersion(FBMeshCustomVersion::GUID, FBMeshCustomVersion::BeforeCustomVersionWasAdded, TEXT("BMeshVer"));
+		Legacy->Serialize(Reader);
+		ensureMsgf(!Reader.IsError(), TEXT("legacy mesh is loaded"));
+	}
+	ensureMsgf(HasSameTopology(Source, Legacy), TEXT("legacy topology is loaded from tagged properties"));
+	ensureMsgf(Legacy->Vertices.Num() > 0 && Legacy->Vertices.Last()->Index == Legacy->Vertices.Num() - 1, TEXT("legacy load restores element indices"));
+
+	// Truncated data is rejected instead of building a broken mesh
+	Bytes.SetNum(Bytes.Num() / 2);
+	UBMesh* Truncated = UBMesh::Make(this);
+	{
+		FPackageLikeReader Reader(Bytes);
+		Reader.SetCustomVersions(Writer.GetCustomVersions());
+		Truncated->Serialize(Reader);
+		ensureMsgf(Reader.IsError(), TEXT("truncated mesh fails to load"));
+	}
+
+	TestBMesh = Loaded;
+	UE_LOG(LogTemp, Log, TEXT("Serialization test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::MappedFileTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	UBMesh* Source = UBMesh::Make(this, Params);
+	UBMeshVertex* v0 = Source->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = Source->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = Source->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = Source->AddVertex(FVector(1, 0, -1));
+	Cast<UBMeshVertex_Test>(v3)->Color = FLinearColor::Blue;
+	Source->AddFace(v0, v1, v2);
+	Source->AddFace(v2, v1, v3);
+
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("BMeshTest/MappedFileTest.bmesh");
+	ensureMsgf(FBMeshMappedFile::Write(Source, Filename), TEXT("mapped file is written"));
+
+	TUniquePtr<FBMeshMappedFile> File = FBMeshMappedFile::Open(Filename);
+	if (!ensureMsgf(File.IsValid(), TEXT("mapped file is opened")))
+		return;
+	ensureMsgf(File->NumVertices() == 4 && File->NumEdges() == 5 && File->NumLoops() == 6 && File->NumFaces() == 2, TEXT("mapped element counts"));
+	ensureMsgf(File->GetPosition(2) == v2->Location, TEXT("mapped vertex position"));
+	ensureMsgf(File->GetFaceVertCount(1) == 3, TEXT("mapped face vert count"));
+	ensureMsgf(File->Validate(), TEXT("mapped file validates"));
+
+	TArrayView<const FLinearColor> Colors = File->GetAttributeValues<FLinearColor>(EBMeshElementType::Vertex, TEXT("Color"));
+	ensureMsgf(Colors.Num() == 4 && Colors[3] == FLinearColor::Blue, TEXT("mapped vertex attribute is read in place"));
+
+	TestBMesh = File->ToBMesh(this, Params);
+	ensureMsgf(TestBMesh->Vertices.Num() == 4 && TestBMesh->Edges.Num() == 5 && TestBMesh->Loops.Num() == 6 && TestBMesh->Faces.Num() == 2, TEXT("converted element counts"));
+	ensureMsgf(Cast<UBMeshVertex_Test>(TestBMesh->Vertices[3])->Color == FLinearColor::Blue, TEXT("converted vertex attribute"));
+	ensureMsgf(TestBMesh->FindEdge(TestBMesh->Vertices[1], TestBMesh->Vertices[2])->NeighborFaces().Num() == 2, TEXT("converted faces share their edge"));
+
+	// Swap two corner edges in place: they stay in range, but don't join the vertices of their corner
+	TArray<int32> LoopEdges(File->GetLoopEdges());
+	File.Reset();
+	TArray<uint8> Bytes;
+	ensureMsgf(FFileHelper::LoadFileToArray(Bytes, *Filename), TEXT("mapped file is loaded as bytes"));
+	const int32 LoopEdgesSize = LoopEdges.Num() * sizeof(int32);
+	int32 LoopEdgesOffset = INDEX_NONE;
+	for (int32 Offset = 0; Offset + LoopEdgesSize <= Bytes.Num(); ++Offset)
+	{
+		if (FMemory::Memcmp(Bytes.GetData() + Offset, LoopEdges.GetData(), LoopEdgesSize) == 0)
+		{
+			LoopEdgesOffset = Offset;
+			break;
+		}
+	}
+	if (ensureMsgf(LoopEdgesOffset != INDEX_NONE && LoopEdges[0] != LoopEdges[1], TEXT("loop edges are found in the file")))
+	{
+		Swap(LoopEdges[0], LoopEdges[1]);
+		FMemory::Memcpy(Bytes.GetData() + LoopEdgesOffset, LoopEdges.GetData(), LoopEdgesSize);
+		ensureMsgf(FFileHelper::SaveArrayToFile(Bytes, *Filename), TEXT("corrupt mapped file is written"));
+		File = FBMeshMappedFile::Open(Filename);
+		ensureMsgf(File.IsValid() && !File->Validate() && File->ToBMesh(this, Params) == nullptr, TEXT("corner edges that don't join their vertices are rejected"));
+		File.Reset();
+	}
+	IFileManager::Get().Delete(*Filename);
+
+	UE_LOG(LogTemp, Log, TEXT("Mapped file test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::FileIOTest()
+{
+	UBMesh* Source = UBMesh::Make(this);
+	UBMeshVertex* v0 = Source->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = Source->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = Source->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = Source->AddVertex(FVector(1, 0, -1));
+	UBMeshVertex* v4 = Source->AddVertex(FVector(2.5f, 0, 0.125f));
+	Source->AddFace(v0, v1, v2, v3);
+	Source->AddEdge(v3, v4);
+
+	for (const TCHAR* Extension : { TEXT("obj"), TEXT("ply") })
+	{
+		const FString Filename = FPaths::ProjectSavedDir() / TEXT("BMeshTest/FileIOTest.") + Extension;
+		ensureMsgf(FBMeshFileIO::Write(Source, Filename), TEXT("%s file is written"), Extension);
+		TestBMesh = FBMeshFileIO::Read(Filename, this);
+		IFileManager::Get().Delete(*Filename);
+		if (!ensureMsgf(TestBMesh != nullptr, TEXT("%s file is read"), Extension))
+			continue;
+
+		ensureMsgf(TestBMesh->Vertices.Num() == 5, TEXT("%s vert count"), Extension);
+		ensureMsgf(TestBMesh->Edges.Num() == 5, TEXT("%s edge count"), Extension);
+		ensureMsgf(TestBMesh->Faces.Num() == 1 && TestBMesh->Faces[0]->VertCount == 4, TEXT("%s face count"), Extension);
+		ensureMsgf(TestBMesh->Vertices[4]->Location == v4->Location, TEXT("%s vertex location"), Extension);
+		ensureMsgf(TestBMesh->FindEdge(TestBMesh->Vertices[3], TestBMesh->Vertices[4]) != nullptr, TEXT("%s loose edge"), Extension);
+	}
+
+	// Element counts of a corrupt header are far more than the file holds, which must fail on read
+	// instead of reserving them
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("BMeshTest/FileIOTest.ply");
+	const FString Header = TEXT("ply\nformat binary_little_endian 1.0\nelement vertex 3000000000\nproperty float x\nproperty float y\nproperty float z\n")
+		TEXT("element face 2000000000\nproperty list uchar int vertex_indices\nend_header\n");
+	FFileHelper::SaveStringToFile(Header + TEXT("0123456789ab"), *Filename);
+	ensureMsgf(FBMeshFileIO::Read(Filename, this) == nullptr, TEXT("ply with implausible element counts is rejected"));
+	IFileManager::Get().Delete(*Filename);
+
+	UE_LOG(LogTemp, Log, TEXT("File IO test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::ConversionTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	// L shaped face, concave at v4, next to a triangle
+	UBMeshVertex* v0 = TestBMesh->AddVertex(FVector(0, 0, 0));
+	UBMeshVertex* v1 = TestBMesh->AddVertex(FVector(2, 0, 0));
+	UBMeshVertex* v2 = TestBMesh->AddVertex(FVector(2, 0, 1));
+	UBMeshVertex* v3 = TestBMesh->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v4 = TestBMesh->AddVertex(FVector(1, 0, 2));
+	UBMeshVertex* v5 = TestBMesh->AddVertex(FVector(0, 0, 2));
+	UBMeshVertex* v6 = TestBMesh->AddVertex(FVector(3, 0, 0));
+	TestBMesh->AddFace({ v0, v1, v2, v3, v4, v5 });
+	TestBMesh->AddFace(v1, v6, v2);
+
+	const FBMeshTriangulation Triangulation = FBMeshTriangulation::Build(TestBMesh);
+	ensureMsgf(Triangulation.Loops.Num() == 9 && Triangulation.Triangles.Num() == 5, TEXT("triangulation counts"));
+	double Area = 0;
+	for (int32 i = Triangulation.TriangleOffsets[0]; i < Triangulation.TriangleOffsets[1]; ++i)
+	{
+		const FIntVector& Triangle = Triangulation.Triangles[i];
+		const FVector A = Triangulation.Loops[Triangle.X]->Vert->Location;
+		const FVector B = Triangulation.Loops[Triangle.Y]->Vert->Location;
+		const FVector C = Triangulation.Loops[Triangle.Z]->Vert->Location;
+		Area += ((B - A) ^ (C - A)).Size() * 0.5;
+	}
+	ensureMsgf(FMath::IsNearlyEqual(Area, 3.0), TEXT("concave face triangles cover the face exactly"));
+
+	FMeshDescription MeshDescription;
+	FBMeshConversion::ToMeshDescription(TestBMesh, MeshDescription);
+	ensureMsgf(MeshDescription.Vertices().Num() == 7, TEXT("mesh description vertex count"));
+	ensureMsgf(MeshDescription.VertexInstances().Num() == 9, TEXT("one vertex instance per loop"));
+	ensureMsgf(MeshDescription.Triangles().Num() == 5, TEXT("mesh description triangle count"));
+
+	UE_LOG(LogTemp, Log, TEXT("Conversion test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::MeshSectionTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	TestBMesh = UBMesh::Make(this, Params);
+	UBMeshVertex* v0 = TestBMesh->AddVertex(FVector(0, 0, 0));
+	UBMeshVertex* v1 = TestBMesh->AddVertex(FVector(1, 0, 0));
+	UBMeshVertex* v2 = TestBMesh->AddVertex(FVector(1, 1, 0));
+	UBMeshVertex* v3 = TestBMesh->AddVertex(FVector(0, 1, 0));
+	UBMeshVertex* v4 = TestBMesh->AddVertex(FVector(2, 0, 0));
+	Cast<UBMeshVertex_Test>(v2)->Color = FLinearColor::Red;
+	TestBMesh->AddFace(v0, v1, v2, v3);
+	TestBMesh->AddFace(v1, v4, v2);
+
+	FBMeshSectionBuffers Buffers;
+	FBMeshSectionOptions Options;
+	FBMeshConversion::ToMeshSection(TestBMesh, Buffers, Options);
+	ensureMsgf(Buffers.Positions.Num() == 7 && Buffers.Normals.Num() == 7, TEXT("per loop split has one vertex per loop"));
+	ensureMsgf(Buffers.Triangles.Num() == 9, TEXT("3 triangles"));
+	ensureMsgf(Buffers.Colors.Num() == 7 && Buffers.UVs.Num() == 0, TEXT("vertex colors are read from the vertex class"));
+	ensureMsgf(FMath::Abs(Buffers.Normals[0].Z) > 0.99f, TEXT("flat normal of a face in the XY plane"));
+
+	Options.Split = EBMeshSectionSplit::PerVertex;
+	Options.TriangulationMethod = EBMeshTriangulationMethod::Fan;
+	FBMeshConversion::ToMeshSection(TestBMesh, Buffers, Options);
+	ensureMsgf(Buffers.Positions.Num() == 5 && Buffers.Triangles.Num() == 9, TEXT("per vertex split has one vertex per mesh vertex"));
+	ensureMsgf(Buffers.Colors[2] == FLinearColor::Red.ToFColor(true), TEXT("vertex color"));
+
+	v4->Location.Z = 1;
+	ensureMsgf(FBMeshConversion::UpdateMeshSectionPositions(TestBMesh, Buffers) && Buffers.Positions[4] == v4->Location, TEXT("positions are updated"));
+	FBMeshOperators::SortVertices(TestBMesh);
+	ensureMsgf(!FBMeshConversion::UpdateMeshSectionPositions(TestBMesh, Buffers), TEXT("reordering vertices with the same counts is detected"));
+	FBMeshConversion::ToMeshSection(TestBMesh, Buffers, Options);
+	v4->Location.Z = 2;
+	ensureMsgf(FBMeshConversion::UpdateMeshSectionPositions(TestBMesh, Buffers) && Buffers.Positions[v4->Index] == v4->Location, TEXT("positions are updated after a rebuild"));
+	UBMesh* OtherMesh = TestBMesh->Clone(this);
+	ensureMsgf(!FBMeshConversion::UpdateMeshSectionPositions(OtherMesh, Buffers), TEXT("buffers of another mesh are rejected"));
+	TestBMesh->AddVertex(FVector(3, 0, 0));
+	ensureMsgf(!FBMeshConversion::UpdateMeshSectionPositions(TestBMesh, Buffers), TEXT("topology changes are detected"));
+
+	UE_LOG(LogTemp, Log, TEXT("Mesh section test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::ImportTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	UBMesh* Source = UBMesh::Make(this, Params);
+	UBMeshVertex* v0 = Source->AddVertex(FVector(-1, 0, -1));
+	UBMeshVertex* v1 = Source->AddVertex(FVector(-1, 0, 1));
+	UBMeshVertex* v2 = Source->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v3 = Source->AddVertex(FVector(1, 0, -1));
+	UBMeshVertex* v4 = Source->AddVertex(FVector(2, 0, 0));
+	Cast<UBMeshVertex_Test>(v2)->Color = FLinearColor::Blue;
+	Source->AddFace(v0, v1, v2, v3);
+	Source->AddFace(v3, v2, v4);
+
+	FMeshDescription MeshDescription;
+	FBMeshConversion::ToMeshDescription(Source, MeshDescription);
+	TestBMesh = FBMeshConversion::FromMeshDescription(MeshDescription, this, Params);
+
+	// The export triangulates the quad, the import welds its vertex instances back together
+	ensureMsgf(TestBMesh->Vertices.Num() == 5, TEXT("vertex instances are welded"));
+	ensureMsgf(TestBMesh->Faces.Num() == 3 && TestBMesh->Loops.Num() == 9, TEXT("one face per triangle"));
+	ensureMsgf(TestBMesh->Edges.Num() == 7, TEXT("edges are shared between faces"));
+	ensureMsgf(TestBMesh->Vertices[4]->Location == v4->Location, TEXT("vertex location"));
+	ensureMsgf(Cast<UBMeshVertex_Test>(TestBMesh->Vertices[2])->Color == FLinearColor::Blue, TEXT("vertex color is imported"));
+
+	UE_LOG(LogTemp, Log, TEXT("Import test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::TriangulateTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.LoopClass = UBMeshLoop_Test::StaticClass();
+	TestBMesh = UBMesh::Make(this, Params);
+	// L shaped face, concave at v4, next to a quad
+	UBMeshVertex* v0 = TestBMesh->AddVertex(FVector(0, 0, 0));
+	UBMeshVertex* v1 = TestBMesh->AddVertex(FVector(2, 0, 0));
+	UBMeshVertex* v2 = TestBMesh->AddVertex(FVector(2, 0, 1));
+	UBMeshVertex* v3 = TestBMesh->AddVertex(FVector(1, 0, 1));
+	UBMeshVertex* v4 = TestBMesh->AddVertex(FVector(1, 0, 2));
+	UBMeshVertex* v5 = TestBMesh->AddVertex(FVector(0, 0, 2));
+	UBMeshVertex* v6 = TestBMesh->AddVertex(FVector(3, 0, 0));
+	UBMeshVertex* v7 = TestBMesh->AddVertex(FVector(3, 0, 1));
+	TestBMesh->AddFace({ v0, v1, v2, v3, v4, v5 })->Id = 1;
+	TestBMesh->AddFace(v1, v6, v7, v2)->Id = 2;
+	for (UBMeshLoop* Loop : TestBMesh->Loops)
+	{
+		Cast<UBMeshLoop_Test>(Loop)->UV = FVector2D(Loop->Vert->Location.X, Loop->Vert->Location.Z);
+	}
+
+	FBMeshOperators::Triangulate(TestBMesh);
+	ensureMsgf(TestBMesh->Vertices.Num() == 8, TEXT("no vertex is added"));
+	ensureMsgf(TestBMesh->Faces.Num() == 6 && TestBMesh->Loops.Num() == 18, TEXT("faces are split into N - 2 triangles"));
+	ensureMsgf(TestBMesh->Edges.Num() == 13, TEXT("original edges are kept and diagonals added"));
+
+	double Area = 0;
+	int32 NumFromLShape = 0;
+	for (UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 3, TEXT("all faces are triangles"));
+		const TArray<UBMeshVertex*> Verts = Face->NeighborVertices();
+		Area += ((Verts[1]->Location - Verts[0]->Location) ^ (Verts[2]->Location - Verts[0]->Location)).Size() * 0.5;
+		NumFromLShape += Face->Id == 1 ? 1 : 0;
+	}
+	ensureMsgf(FMath::IsNearlyEqual(Area, 4.0), TEXT("triangles cover the original faces exactly"));
+	ensureMsgf(NumFromLShape == 4, TEXT("face attributes are copied"));
+	for (UBMeshLoop* Loop : TestBMesh->Loops)
+	{
+		const FVector2D UV = Cast<UBMeshLoop_Test>(Loop)->UV;
+		ensureMsgf(UV == FVector2D(Loop->Vert->Location.X, Loop->Vert->Location.Z), TEXT("loop attributes are copied"));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Triangulate test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::DecimateTest()
+{
+	// Flat 8x8 grid of triangulated quads
+	constexpr int32 GridSize = 8;
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	TestBMesh = UBMesh::Make(this, Params);
+	FBMeshOperators::SquareGrid(TestBMesh, GridSize, GridSize);
+	// The grid is centered on the origin, colors go from 0 to 1 along X
+	auto ColorOf = [](const FVector& Location) { return float(Location.X + GridSize / 2) / GridSize; };
+	for (UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		Cast<UBMeshVertex_Test>(Vertex)->Color = FLinearColor(ColorOf(Vertex->Location), 0, 0);
+	}
+	FBMeshOperators::Triangulate(TestBMesh);
+	ensureMsgf(TestBMesh->Faces.Num() == GridSize * GridSize * 2, TEXT("grid face count"));
+
+	// Collapsing edges of a flat region has no error
+	FBMeshOperators::FDecimateParams DecimateParams;
+	DecimateParams.MaxError = KINDA_SMALL_NUMBER;
+	const int32 NumCollapsed = FBMeshOperators::Decimate(TestBMesh, DecimateParams);
+	ensureMsgf(NumCollapsed > 0 && TestBMesh->Faces.Num() < GridSize * GridSize * 2, TEXT("flat grid is simplified"));
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		ensureMsgf(FMath::IsNearlyZero(Vertex->Location.Z), TEXT("vertices stay on the plane"));
+		ensureMsgf(FMath::IsNearlyEqual(Cast<UBMeshVertex_Test>(Vertex)->Color.R, ColorOf(Vertex->Location), 0.01f), TEXT("attributes are interpolated at the collapse point"));
+		ensureMsgf(Vertex->Edge != nullptr, TEXT("no vertex is left isolated"));
+	}
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 3, TEXT("faces stay triangles"));
+	}
+	// The boundary constraint keeps the corners of the grid
+	ensureMsgf(TestBMesh->Vertices.ContainsByPredicate([](const UBMeshVertex* Vertex) { return Vertex->Location == FVector(GridSize / 2, GridSize / 2, 0); }), TEXT("corners are kept"));
+
+	DecimateParams.MaxError = -1;
+	DecimateParams.TargetFaceCount = 4;
+	FBMeshOperators::Decimate(TestBMesh, DecimateParams);
+	ensureMsgf(TestBMesh->Faces.Num() <= DecimateParams.TargetFaceCount, TEXT("face count target is reached"));
+
+	UE_LOG(LogTemp, Log, TEXT("Decimate test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::LocalEditsTest()
+{
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	TestBMesh = UBMesh::Make(this, Params);
+	UBMeshVertex* v0 = TestBMesh->AddVertex(FVector(0, 0, 0));
+	UBMeshVertex* v1 = TestBMesh->AddVertex(FVector(1, 0, 0));
+	UBMeshVertex* v2 = TestBMesh->AddVertex(FVector(1, 1, 0));
+	UBMeshVertex* v3 = TestBMesh->AddVertex(FVector(0, 1, 0));
+	Cast<UBMeshVertex_Test>(v1)->Color = FLinearColor(1, 0, 0);
+	UBMeshFace* Quad = TestBMesh->AddFace(v0, v1, v2, v3);
+
+	// Cut the quad along its 0-2 diagonal
+	UBMeshLoop* Loop0 = Quad->FirstLoop;
+	UBMeshLoop* Loop2 = Loop0->Next->Next;
+	UBMeshFace* Other = FBMeshOperators::SplitFace(TestBMesh, Loop0, Loop2);
+	ensureMsgf(Other && Quad->VertCount == 3 && Other->VertCount == 3, TEXT("face is split in two triangles"));
+	UBMeshEdge* Diagonal = TestBMesh->FindEdge(v0, v2);
+	ensureMsgf(Diagonal && Diagonal->Loop && Diagonal->Loop->RadialNext != Diagonal->Loop, TEXT("diagonal is shared by both triangles"));
+	ensureMsgf(TestBMesh->Edges.Num() == 5 && TestBMesh->Loops.Num() == 6, TEXT("split face element counts"));
+
+	// Flip it onto the 1-3 diagonal
+	ensureMsgf(FBMeshOperators::FlipEdge(TestBMesh, Diagonal), TEXT("diagonal can be flipped"));
+	ensureMsgf(Diagonal->ContainsVertex(v1) && Diagonal->ContainsVertex(v3), TEXT("flipped diagonal joins the other corners"));
+	ensureMsgf(TestBMesh->FindEdge(v0, v2) == nullptr, TEXT("old diagonal is gone"));
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 3, TEXT("flipped faces stay triangles"));
+		const UBMeshLoop* Loop = Face->FirstLoop;
+		const FVector Normal = (Loop->Next->Vert->Location - Loop->Vert->Location) ^ (Loop->Prev->Vert->Location - Loop->Vert->Location);
+		ensureMsgf(Normal.Z > 0, TEXT("flipped faces keep their orientation"));
+	}
+
+	// Split a border edge, and dissolve the new vertex
+	UBMeshVertex* Middle = FBMeshOperators::SplitEdge(TestBMesh, TestBMesh->FindEdge(v0, v1), 0.25f);
+	ensureMsgf(Middle->Location.Equals(FVector(0.25f, 0, 0)), TEXT("split vertex is interpolated"));
+	ensureMsgf(FMath::IsNearlyEqual(Cast<UBMeshVertex_Test>(Middle)->Color.R, 0.25f), TEXT("split vertex attributes are interpolated"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 5 && TestBMesh->Edges.Num() == 6 && TestBMesh->Loops.Num() == 7, TEXT("split edge element counts"));
+	ensureMsgf(FBMeshOperators::DissolveVertex(TestBMesh, Middle), TEXT("split vertex can be dissolved"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 4 && TestBMesh->Edges.Num() == 5 && TestBMesh->Loops.Num() == 6, TEXT("dissolve vertex element counts"));
+	ensureMsgf(TestBMesh->FindEdge(v0, v1) != nullptr, TEXT("edges around the dissolved vertex are joined"));
+
+	// Merge the triangles back into a quad
+	UBMeshFace* Merged = FBMeshOperators::DissolveEdge(TestBMesh, Diagonal);
+	ensureMsgf(Merged && Merged->VertCount == 4, TEXT("triangles are merged into a quad"));
+	ensureMsgf(TestBMesh->Faces.Num() == 1 && TestBMesh->Edges.Num() == 4 && TestBMesh->Loops.Num() == 4, TEXT("dissolve edge element counts"));
+	for (const UBMeshLoop* Loop : Merged->Loops())
+	{
+		ensureMsgf(Loop->Face == Merged && Loop->Next->Prev == Loop && Loop->Edge->ContainsVertex(Loop->Next->Vert), TEXT("merged face is consistent"));
+	}
+
+	// Collapse a spoke of a fan of 4 triangles, which removes the 2 triangles using it
+	TestBMesh = UBMesh::Make(this, Params);
+	UBMeshVertex* Center = TestBMesh->AddVertex(FVector(0.5f, 0.5f, 0));
+	UBMeshVertex* Corners[4] = {
+		TestBMesh->AddVertex(FVector(0, 0, 0)),
+		TestBMesh->AddVertex(FVector(1, 0, 0)),
+		TestBMesh->AddVertex(FVector(1, 1, 0)),
+		TestBMesh->AddVertex(FVector(0, 1, 0)),
+	};
+	for (int32 i = 0; i < 4; ++i)
+	{
+		TestBMesh->AddFace(Center, Corners[i], Corners[(i + 1) % 4]);
+	}
+	UBMeshEdge* Spoke = TestBMesh->FindEdge(Center, Corners[0]);
+	ensureMsgf(FBMeshOperators::CanCollapseEdge(Spoke), TEXT("spoke of a fan passes the link condition"));
+	UBMeshVertex* ExpectedKept = Spoke->Vert1;
+	const FVector ExpectedLocation = (Spoke->Vert1->Location + Spoke->Vert2->Location) * 0.5f;
+	UBMeshVertex* Kept = FBMeshOperators::CollapseEdge(TestBMesh, Spoke);
+	ensureMsgf(Kept == ExpectedKept && Kept->Location.Equals(ExpectedLocation), TEXT("first vertex is kept at the middle of the edge"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 4 && TestBMesh->Edges.Num() == 5 && TestBMesh->Faces.Num() == 2 && TestBMesh->Loops.Num() == 6, TEXT("collapse edge element counts"));
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 3, TEXT("remaining faces stay triangles"));
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			ensureMsgf(Loop->Vert != Loop->Next->Vert && Loop->Edge->ContainsVertex(Loop->Next->Vert), TEXT("collapsed faces are consistent"));
+		}
+	}
+
+	// Three triangles around an apex: collapsing a base edge would make the two other triangles identical
+	TestBMesh = UBMesh::Make(this, Params);
+	UBMeshVertex* a = TestBMesh->AddVertex(FVector(0, 0, 0));
+	UBMeshVertex* b = TestBMesh->AddVertex(FVector(1, 0, 0));
+	UBMeshVertex* Apex = TestBMesh->AddVertex(FVector(0.5f, 0.5f, 1));
+	UBMeshVertex* d = TestBMesh->AddVertex(FVector(0.5f, 1, 0));
+	TestBMesh->AddFace(a, b, Apex);
+	TestBMesh->AddFace(a, Apex, d);
+	TestBMesh->AddFace(Apex, b, d);
+	ensureMsgf(!FBMeshOperators::CanCollapseEdge(TestBMesh->FindEdge(a, b)), TEXT("edge whose ends share a neighbor outside its triangles fails the link condition"));
+
+	UE_LOG(LogTemp, Log, TEXT("Local edits test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::MergeRandomTrianglePairsTest()
+{
+	// Triangulated 6x6 grid
+	constexpr int32 GridSize = 6;
+	auto MakeGrid = [this]()
+	{
+		UBMesh* Mesh = UBMesh::Make(this, UBMesh::FMakeParams());
+		FBMeshOperators::SquareGrid(Mesh, GridSize, GridSize);
+		FBMeshOperators::Triangulate(Mesh);
+		return Mesh;
+	};
+
+	TestBMesh = MakeGrid();
+	const int32 NumMerged = FBMeshOperators::MergeRandomTrianglePairs(TestBMesh, 42);
+	ensureMsgf(NumMerged > 0 && TestBMesh->Faces.Num() == GridSize * GridSize * 2 - NumMerged, TEXT("triangle pairs are merged"));
+	int32 NumQuads = 0;
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 3 || Face->VertCount == 4, TEXT("faces are triangles or quads"));
+		NumQuads += Face->VertCount == 4 ? 1 : 0;
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			ensureMsgf(Loop->Face == Face && Loop->Next->Prev == Loop && Loop->Edge->ContainsVertex(Loop->Next->Vert), TEXT("merged faces are consistent"));
+		}
+	}
+	ensureMsgf(NumQuads == NumMerged, TEXT("each merge makes a quad"));
+	// The matching is maximal: no two triangles left are adjacent
+	for (const UBMeshEdge* Edge : TestBMesh->Edges)
+	{
+		const UBMeshLoop* Loop = Edge->Loop;
+		if (Loop && Loop->RadialNext != Loop)
+		{
+			ensureMsgf(Loop->Face->VertCount == 4 || Loop->RadialNext->Face->VertCount == 4, TEXT("no mergeable pair is left"));
+		}
+	}
+
+	// Same seed, same result
+	UBMesh* Other = MakeGrid();
+	ensureMsgf(FBMeshOperators::MergeRandomTrianglePairs(Other, 42) == NumMerged, TEXT("merging is deterministic"));
+	for (int32 i = 0; i < TestBMesh->Faces.Num(); ++i)
+	{
+		ensureMsgf(TestBMesh->Faces[i]->VertCount == Other->Faces[i]->VertCount, TEXT("merging is deterministic"));
+	}
+
+	// A zero ratio merges nothing
+	Other = MakeGrid();
+	ensureMsgf(FBMeshOperators::MergeRandomTrianglePairs(Other, 42, 0.0f) == 0, TEXT("zero ratio merges nothing"));
+
+	UE_LOG(LogTemp, Log, TEXT("Merge random triangle pairs test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::RemeshTest()
+{
+	// Flat grid whose columns get wider along X
+	constexpr int32 GridSize = 6;
+	TestBMesh = UBMesh::Make(this, UBMesh::FMakeParams());
+	for (int32 y = 0; y <= GridSize; ++y)
+	{
+		for (int32 x = 0; x <= GridSize; ++x)
+		{
+			TestBMesh->AddVertex(FVector(x * x / float(GridSize), y, 0));
+		}
+	}
+	for (int32 y = 0; y < GridSize; ++y)
+	{
+		for (int32 x = 0; x < GridSize; ++x)
+		{
+			const int32 i = y * (GridSize + 1) + x;
+			TestBMesh->AddFace(i, i + 1, i + GridSize + 2, i + GridSize + 1);
+		}
+	}
+
+	FBMeshOperators::FRemeshParams Params;
+	Params.TargetEdgeLength = 0.5f;
+	FBMeshOperators::Remesh(TestBMesh, Params);
+
+	int32 NumBadEdges = 0;
+	for (const UBMeshEdge* Edge : TestBMesh->Edges)
+	{
+		// The last relaxation can stretch edges a bit past the split threshold
+		const double Length = FVector::Dist(Edge->Vert1->Location, Edge->Vert2->Location);
+		ensureMsgf(Length <= Params.TargetEdgeLength * 2, TEXT("no edge is left too long"));
+		NumBadEdges += Length < Params.TargetEdgeLength * 0.5f ? 1 : 0;
+		ensureMsgf(Edge->Loop != nullptr, TEXT("no edge is left loose"));
+	}
+	ensureMsgf(NumBadEdges < TestBMesh->Edges.Num() / 10, TEXT("edges are close to the target length"));
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		ensureMsgf(FMath::IsNearlyZero(Vertex->Location.Z) && Vertex->Location.X >= -KINDA_SMALL_NUMBER && Vertex->Location.X <= GridSize + KINDA_SMALL_NUMBER
+			&& Vertex->Location.Y >= -KINDA_SMALL_NUMBER && Vertex->Location.Y <= GridSize + KINDA_SMALL_NUMBER, TEXT("vertices stay inside the grid"));
+	}
+	double Area = 0;
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 3, TEXT("remeshed faces are triangles"));
+		const UBMeshLoop* Loop = Face->FirstLoop;
+		const FVector Normal = (Loop->Next->Vert->Location - Loop->Vert->Location) ^ (Loop->Prev->Vert->Location - Loop->Vert->Location);
+		ensureMsgf(Normal.Z > 0, TEXT("remeshed faces keep their orientation"));
+		Area += Normal.Z * 0.5;
+	}
+	ensureMsgf(FMath::IsNearlyEqual(Area, double(GridSize * GridSize), 0.01), TEXT("remeshing keeps the area of a flat mesh"));
+
+	UE_LOG(LogTemp, Log, TEXT("Remesh test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::ExtrudeInsetTest()
+{
+	// Row of three unit quads
+	auto MakeRow = [this]()
+	{
+		UBMesh::FMakeParams Params;
+		Params.VertexClass = UBMeshVertex_Test::StaticClass();
+		UBMesh* Mesh = UBMesh::Make(this, Params);
+		for (int32 y = 0; y <= 1; ++y)
+		{
+			for (int32 x = 0; x <= 3; ++x)
+			{
+				UBMeshVertex* Vertex = Mesh->AddVertex(FVector(x, y, 0));
+				Cast<UBMeshVertex_Test>(Vertex)->Color = FLinearColor(x, y, 0);
+			}
+		}
+		for (int32 x = 0; x < 3; ++x)
+		{
+			Mesh->AddFace(x, x + 1, x + 5, x + 4);
+		}
+		return Mesh;
+	};
+
+	// Region extrude of the whole row: caps on top, walls around the row only
+	TestBMesh = MakeRow();
+	TArray<UBMeshFace*> Caps = FBMeshOperators::ExtrudeFaces(TestBMesh, TestBMesh->Faces, 2.0f);
+	ensureMsgf(Caps.Num() == 3, TEXT("one cap per extruded face"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 16 && TestBMesh->Faces.Num() == 11 && TestBMesh->Edges.Num() == 26, TEXT("region extrude element counts"));
+	for (const UBMeshFace* Cap : Caps)
+	{
+		for (const UBMeshVertex* Vertex : Cap->Vertices())
+		{
+			ensureMsgf(FMath::IsNearlyEqual(Vertex->Location.Z, 2.0f), TEXT("caps are moved along the normal"));
+			ensureMsgf(Cast<UBMeshVertex_Test>(Vertex)->Color == FLinearColor(Vertex->Location.X, Vertex->Location.Y, 0), TEXT("new vertices copy their source's attributes"));
+		}
+	}
+	for (const UBMeshEdge* Edge : TestBMesh->Edges)
+	{
+		const UBMeshLoop* Loop = Edge->Loop;
+		ensureMsgf(Loop != nullptr, TEXT("no edge is left loose"));
+		ensureMsgf(Loop->RadialNext == Loop || Loop->RadialNext->Vert != Loop->Vert, TEXT("extruded faces are consistently oriented"));
+	}
+
+	// Individual extrude of the middle face
+	TestBMesh = MakeRow();
+	Caps = FBMeshOperators::ExtrudeFaces(TestBMesh, TArray<UBMeshFace*>{ TestBMesh->Faces[1] }, 1.0f, EBMeshFaceRegionMode::Individual);
+	ensureMsgf(TestBMesh->Vertices.Num() == 12 && TestBMesh->Faces.Num() == 7, TEXT("individual extrude element counts"));
+
+	// Individual inset of two adjacent faces
+	TestBMesh = MakeRow();
+	TArray<UBMeshFace*> Inner = FBMeshOperators::InsetFaces(TestBMesh, TArray<UBMeshFace*>{ TestBMesh->Faces[0], TestBMesh->Faces[1] }, 0.25f, EBMeshFaceRegionMode::Individual);
+	ensureMsgf(Inner.Num() == 2 && TestBMesh->Vertices.Num() == 16 && TestBMesh->Faces.Num() == 11, TEXT("individual inset element counts"));
+	for (const UBMeshFace* Face : Inner)
+	{
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			ensureMsgf(FMath::IsNearlyEqual(FVector::Dist(Loop->Vert->Location, Loop->Next->Vert->Location), 0.5f, 0.001f), TEXT("inset edges move inwards by the thickness"));
+		}
+	}
+
+	// Region inset of the same faces keeps the vertices inside the region
+	TestBMesh = MakeRow();
+	Inner = FBMeshOperators::InsetFaces(TestBMesh, TArray<UBMeshFace*>{ TestBMesh->Faces[0], TestBMesh->Faces[1] }, 0.25f);
+	ensureMsgf(TestBMesh->Vertices.Num() == 14 && TestBMesh->Faces.Num() == 9, TEXT("region inset element counts"));
+	double Area = 0;
+	for (const UBMeshFace* Face : Inner)
+	{
+		const UBMeshLoop* Loop = Face->FirstLoop;
+		Area += ((Loop->Next->Vert->Location - Loop->Vert->Location) ^ (Loop->Prev->Vert->Location - Loop->Vert->Location)).Z;
+	}
+	ensureMsgf(FMath::IsNearlyEqual(Area, 1.5 * 0.5, 0.001), TEXT("region inset shrinks the region as a whole"));
+
+	UE_LOG(LogTemp, Log, TEXT("Extrude and inset test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::DualTest()
+{
+	// 3x3 grid of quads, faces colored by the X of their center
+	constexpr int32 GridSize = 3;
+	UBMesh::FMakeParams Params;
+	Params.VertexClass = UBMeshVertex_Test::StaticClass();
+	Params.FaceClass = UBMeshFace_Test::StaticClass();
+	UBMesh* Grid = UBMesh::Make(this, Params);
+	FBMeshOperators::SquareGrid(Grid, GridSize, GridSize);
+	for (UBMeshFace* Face : Grid->Faces)
+	{
+		Cast<UBMeshFace_Test>(Face)->Color = FLinearColor(float(Face->Center().X), 0, 0);
+	}
+
+	// Clipped: only the 4 interior vertices get a face
+	TestBMesh = FBMeshOperators::Dual(Grid);
+	ensureMsgf(TestBMesh->Vertices.Num() == GridSize * GridSize && TestBMesh->Faces.Num() == 4, TEXT("clipped dual element counts"));
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		ensureMsgf(FMath::IsNearlyEqual(Vertex->Location.X, Cast<UBMeshVertex_Test>(Vertex)->Color.R), TEXT("face attributes carry over to dual vertices"));
+	}
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		ensureMsgf(Face->VertCount == 4, TEXT("interior vertices of a quad grid become quads"));
+		const UBMeshLoop* Loop = Face->FirstLoop;
+		const FVector Normal = (Loop->Next->Vert->Location - Loop->Vert->Location) ^ (Loop->Prev->Vert->Location - Loop->Vert->Location);
+		ensureMsgf(FMath::IsNearlyEqual(Normal.Z, 1.0f), TEXT("dual faces have the orientation of the mesh"));
+	}
+
+	// Closed: every vertex gets a face, and the dual covers the whole grid
+	TestBMesh = FBMeshOperators::Dual(Grid, EBMeshDualBoundary::Close);
+	ensureMsgf(TestBMesh->Faces.Num() == (GridSize + 1) * (GridSize + 1), TEXT("closed dual face count"));
+	ensureMsgf(TestBMesh->Vertices.Num() == GridSize * GridSize + GridSize * 4 * 2, TEXT("closed dual vertex count"));
+	double Area = 0;
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		// Shoelace formula, the cells aren't all parallelograms
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			Area += (Loop->Vert->Location ^ Loop->Next->Vert->Location).Z * 0.5;
+		}
+	}
+	ensureMsgf(FMath::IsNearlyEqual(Area, double(GridSize * GridSize), 0.001), TEXT("closed dual covers the mesh"));
+	for (const UBMeshEdge* Edge : TestBMesh->Edges)
+	{
+		const UBMeshLoop* Loop = Edge->Loop;
+		ensureMsgf(Loop && (Loop->RadialNext == Loop || (Loop->RadialNext->RadialNext == Loop && Loop->RadialNext->Vert != Loop->Vert)), TEXT("closed dual is a consistent manifold"));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Dual test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::DelaunayVoronoiTest()
+{
+	constexpr int32 NumPoints = 200;
+	FRandomStream Random(7);
+	TArray<FVector2D> Points;
+	for (int32 i = 0; i < NumPoints; ++i)
+	{
+		Points.Add(FVector2D(Random.FRandRange(0, 10), Random.FRandRange(0, 10)));
+	}
+
+	TestBMesh = UBMesh::Make(this);
+	ensureMsgf(FBMeshOperators::Delaunay(TestBMesh, Points), TEXT("points are triangulated"));
+	int32 NumHullEdges = 0;
+	for (const UBMeshEdge* Edge : TestBMesh->Edges)
+	{
+		NumHullEdges += Edge->Loop->RadialNext == Edge->Loop ? 1 : 0;
+	}
+	ensureMsgf(TestBMesh->Vertices.Num() == NumPoints && TestBMesh->Faces.Num() == 2 * NumPoints - NumHullEdges - 2, TEXT("Delaunay triangle count"));
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		const UBMeshLoop* Loop = Face->FirstLoop;
+		const FVector2D A(Loop->Vert->Location), B(Loop->Next->Vert->Location), C(Loop->Prev->Vert->Location);
+		ensureMsgf(Face->VertCount == 3 && FBMeshDelaunay::Orient2D(A, B, C) > 0, TEXT("triangles are counterclockwise"));
+		const FVector2D Center = FBMeshDelaunay::Circumcenter(A, B, C);
+		const double RadiusSquared = FVector2D::DistSquared(Center, A);
+		for (const FVector2D& Point : Points)
+		{
+			ensureMsgf(FVector2D::DistSquared(Center, Point) >= RadiusSquared * (1 - 1e-6), TEXT("circumcircles are empty"));
+		}
+	}
+
+	// Exact duplicates are skipped without leaving loose vertices
+	const int32 NumFaces = TestBMesh->Faces.Num();
+	TArray<FVector2D> WithDuplicates = Points;
+	WithDuplicates.Add(Points[3]);
+	WithDuplicates.Add(Points[10]);
+	WithDuplicates.Add(Points[3]);
+	TestBMesh = UBMesh::Make(this);
+	ensureMsgf(FBMeshOperators::Delaunay(TestBMesh, WithDuplicates), TEXT("points with duplicates are triangulated"));
+	ensureMsgf(TestBMesh->Vertices.Num() == NumPoints && TestBMesh->Faces.Num() == NumFaces, TEXT("duplicates get no vertex"));
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		ensureMsgf(Vertex->Edge != nullptr, TEXT("no loose vertex is left"));
+		ensureMsgf(FVector2D(Vertex->Location) == WithDuplicates[Vertex->Id], TEXT("vertex id is the index of its point"));
+	}
+
+	TArray<FVector2D> Collinear = { FVector2D(0, 0), FVector2D(1, 1), FVector2D(2, 2) };
+	ensureMsgf(!FBMeshOperators::Delaunay(UBMesh::Make(this), Collinear), TEXT("collinear points aren't triangulated"));
+	ensureMsgf(FBMeshDelaunay::Orient2D(FVector2D(0.1, 0.1), FVector2D(0.2, 0.2), FVector2D(0.3, 0.3)) == 0, TEXT("orientation is exact"));
+
+	TestBMesh = UBMesh::Make(this);
+	ensureMsgf(FBMeshOperators::Voronoi(TestBMesh, Points), TEXT("Voronoi cells are made"));
+	ensureMsgf(TestBMesh->Faces.Num() == NumPoints - NumHullEdges, TEXT("every point off the hull gets a cell"));
+	for (const UBMeshFace* Cell : TestBMesh->Faces)
+	{
+		// The cell is convex and contains its point
+		const FVector2D& Site = Points[Cell->Id];
+		for (const UBMeshLoop* Loop : Cell->Loops())
+		{
+			ensureMsgf(FBMeshDelaunay::Orient2D(FVector2D(Loop->Vert->Location), FVector2D(Loop->Next->Vert->Location), Site) >= 0, TEXT("cells contain their point"));
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Delaunay and Voronoi test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::LatticeTest()
+{
+	auto CheckTopology = [](UBMesh* Mesh, int32 FaceSize)
+	{
+		for (const UBMeshEdge* Edge : Mesh->Edges)
+		{
+			ensureMsgf(Mesh->FindEdge(Edge->Vert1, Edge->Vert2) == Edge, TEXT("edges are in the disks of their vertices"));
+			ensureMsgf(Edge->Next(Edge->Vert1)->Prev(Edge->Vert1) == Edge && Edge->Next(Edge->Vert2)->Prev(Edge->Vert2) == Edge, TEXT("disks are linked both ways"));
+			ensureMsgf(Edge->Loop && Edge->Loop->Edge == Edge && Edge->Loop->RadialNext->RadialNext == Edge->Loop, TEXT("edges have one or two loops"));
+		}
+		for (const UBMeshLoop* Loop : Mesh->Loops)
+		{
+			ensureMsgf(Loop->Next->Prev == Loop && Loop->RadialNext->RadialPrev == Loop && Loop->Next->Face == Loop->Face, TEXT("loops are linked both ways"));
+			ensureMsgf(Loop->Edge->ContainsVertex(Loop->Vert) && Loop->Edge->ContainsVertex(Loop->Next->Vert), TEXT("loop edges go to the next corner"));
+		}
+		for (const UBMeshFace* Face : Mesh->Faces)
+		{
+			const FVector A = Face->FirstLoop->Vert->Location;
+			const FVector B = Face->FirstLoop->Next->Vert->Location;
+			const FVector C = Face->FirstLoop->Next->Next->Vert->Location;
+			int32 NumCorners = 0;
+			for (const UBMeshLoop* Loop : Face->Loops())
+			{
+				++NumCorners;
+			}
+			ensureMsgf(Face->VertCount == FaceSize && NumCorners == FaceSize, TEXT("face corner count"));
+			ensureMsgf(FVector::CrossProduct(B - A, C - A).Z > 0, TEXT("faces are counterclockwise"));
+		}
+		ensureMsgf(Mesh->Vertices.Num() - Mesh->Edges.Num() + Mesh->Faces.Num() == 1, TEXT("lattices are disks"));
+	};
+
+	TestBMesh = UBMesh::Make(this);
+	ensureMsgf(FBMeshOperators::SquareGrid(TestBMesh, 5, 3, 2.0f), TEXT("square grid is made"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 24 && TestBMesh->Edges.Num() == 38 && TestBMesh->Faces.Num() == 15, TEXT("square grid counts"));
+	ensureMsgf(TestBMesh->Vertices[0]->Location.Equals(FVector(-5, -3, 0)), TEXT("square grid is centered"));
+	CheckTopology(TestBMesh, 4);
+
+	TestBMesh = UBMesh::Make(this);
+	ensureMsgf(FBMeshOperators::TriangleGrid(TestBMesh, 4, 3), TEXT("triangle grid is made"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 20 && TestBMesh->Faces.Num() == 3 * 2 * 4, TEXT("triangle grid counts"));
+	for (const UBMeshEdge* Edge : TestBMesh->Edges)
+	{
+		ensureMsgf(FMath::IsNearlyEqual(FVector::Dist(Edge->Vert1->Location, Edge->Vert2->Location), 1.0f, 1e-4f), TEXT("triangles are equilateral"));
+	}
+	CheckTopology(TestBMesh, 3);
+
+	ensureMsgf(!FBMeshOperators::HexagonGrid(UBMesh::Make(this), 0), TEXT("empty hexagon isn't made"));
+	constexpr int32 N = 4;
+	TestBMesh = UBMesh::Make(this);
+	ensureMsgf(FBMeshOperators::HexagonGrid(TestBMesh, N), TEXT("hexagon is made"));
+	ensureMsgf(TestBMesh->Vertices.Num() == 3 * N * (N + 1) + 1 && TestBMesh->Edges.Num() == 3 * N * (3 * N + 1) && TestBMesh->Faces.Num() == 6 * N * N, TEXT("hexagon counts"));
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		ensureMsgf(Vertex->Location.Size() <= N + 1e-4f, TEXT("hexagon fits its circumcircle"));
+	}
+	CheckTopology(TestBMesh, 3);
+
+	// Lattices are appended to what is already in the mesh
+	ensureMsgf(FBMeshOperators::HexagonGrid(TestBMesh, 1), TEXT("second hexagon is made"));
+	ensureMsgf(TestBMesh->Faces.Num() == 6 * N * N + 6 && TestBMesh->Faces.Last()->Id == 5, TEXT("second hexagon is appended"));
+	ensureMsgf(TestBMesh->Faces.Last()->FirstLoop->Vert->GetOuter() == TestBMesh && TestBMesh->Vertices.Last()->Edge != nullptr, TEXT("second hexagon is linked"));
+
+	UE_LOG(LogTemp, Log, TEXT("Lattice test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::SortTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	FBMeshOperators::SquareGrid(TestBMesh, 8, 8);
+	FRandomStream Random(3);
+	auto Shuffle = [&Random](auto& Elements)
+	{
+		for (int32 i = Elements.Num() - 1; i > 0; --i)
+		{
+			Elements.Swap(i, Random.RandRange(0, i));
+		}
+	};
+	Shuffle(TestBMesh->Vertices);
+	Shuffle(TestBMesh->Edges);
+	Shuffle(TestBMesh->Loops);
+	Shuffle(TestBMesh->Faces);
+	TestBMesh->UpdateElementIndices();
+
+	// Grid vertices share coordinates, which needs a proper lexicographic order
+	auto IsSorted = [](const FVector& A, const FVector& B)
+	{
+		return A.Z != B.Z ? A.Z < B.Z : A.Y != B.Y ? A.Y < B.Y : A.X <= B.X;
+	};
+	FBMeshOperators::SortVertices(TestBMesh);
+	for (int32 i = 1; i < TestBMesh->Vertices.Num(); ++i)
+	{
+		ensureMsgf(IsSorted(TestBMesh->Vertices[i - 1]->Location, TestBMesh->Vertices[i]->Location), TEXT("vertices are sorted"));
+	}
+	FBMeshOperators::SortFacesByCenters(TestBMesh);
+	for (int32 i = 1; i < TestBMesh->Faces.Num(); ++i)
+	{
+		ensureMsgf(IsSorted(TestBMesh->Faces[i - 1]->Center(), TestBMesh->Faces[i]->Center()), TEXT("faces are sorted"));
+	}
+
+	auto IndexVertices = [this]()
+	{
+		TMap<const UBMeshVertex*, int32> Indices;
+		for (int32 i = 0; i < TestBMesh->Vertices.Num(); ++i)
+		{
+			Indices.Add(TestBMesh->Vertices[i], i);
+		}
+		return Indices;
+	};
+	auto MeanEdgeSpan = [this](const TMap<const UBMeshVertex*, int32>& Indices)
+	{
+		int64 Span = 0;
+		for (const UBMeshEdge* Edge : TestBMesh->Edges)
+		{
+			Span += FMath::Abs(Indices[Edge->Vert1] - Indices[Edge->Vert2]);
+		}
+		return double(Span) / TestBMesh->Edges.Num();
+	};
+	Shuffle(TestBMesh->Vertices);
+	TestBMesh->UpdateElementIndices();
+	const double ShuffledSpan = MeanEdgeSpan(IndexVertices());
+	TArray<int32> ExpectedIds;
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		ExpectedIds.Add(Vertex->Id);
+	}
+	ExpectedIds.Sort();
+
+	FBMeshOperators::SortSpatially(TestBMesh);
+	const TMap<const UBMeshVertex*, int32> VertexIndices = IndexVertices();
+	ensureMsgf(MeanEdgeSpan(VertexIndices) < ShuffledSpan / 2, TEXT("neighbor vertices are close in memory"));
+	TArray<int32> SortedIds;
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		SortedIds.Add(Vertex->Id);
+	}
+	SortedIds.Sort();
+	ensureMsgf(SortedIds == ExpectedIds, TEXT("vertices are only reordered"));
+
+	for (int32 i = 1; i < TestBMesh->Edges.Num(); ++i)
+	{
+		const UBMeshEdge* A = TestBMesh->Edges[i - 1];
+		const UBMeshEdge* B = TestBMesh->Edges[i];
+		ensureMsgf(FMath::Min(VertexIndices[A->Vert1], VertexIndices[A->Vert2]) <= FMath::Min(VertexIndices[B->Vert1], VertexIndices[B->Vert2]), TEXT("edges follow their first vertex"));
+	}
+	int32 Corner = 0;
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		for (const UBMeshLoop* Loop : Face->Loops())
+		{
+			ensureMsgf(TestBMesh->Loops[Corner++] == Loop, TEXT("loops of each face are stored together"));
+		}
+	}
+	ensureMsgf(Corner == TestBMesh->Loops.Num(), TEXT("every loop is kept"));
+
+	UE_LOG(LogTemp, Log, TEXT("Sort test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::IndexTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	FBMeshOperators::SquareGrid(TestBMesh, 4, 4);
+	auto CheckIndices = [this](const TCHAR* Step)
+	{
+		auto CheckContainer = [Step](const auto& Elements, const TCHAR* Name)
+		{
+			for (int32 i = 0; i < Elements.Num(); ++i)
+			{
+				ensureMsgf(Elements[i]->Index == i, TEXT("%s index matches its position after %s"), Name, Step);
+			}
+		};
+		CheckContainer(TestBMesh->Vertices, TEXT("vertex"));
+		CheckContainer(TestBMesh->Edges, TEXT("edge"));
+		CheckContainer(TestBMesh->Loops, TEXT("loop"));
+		CheckContainer(TestBMesh->Faces, TEXT("face"));
+	};
+	CheckIndices(TEXT("building a grid"));
+
+	// Ids belong to the user and must survive operators
+	for (UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		Vertex->Id = 42;
+	}
+	TArray<UBMeshVertex*> OriginalVertices = TestBMesh->Vertices;
+
+	UBMeshFace* RemovedFace = TestBMesh->Faces[5];
+	TestBMesh->RemoveFace(RemovedFace);
+	ensureMsgf(RemovedFace->Index == INDEX_NONE, TEXT("removed face has no index"));
+	CheckIndices(TEXT("removing a face"));
+
+	UBMeshVertex* RemovedVertex = OriginalVertices[0];
+	{
+		FBMeshDeferredRemovalScope RemovalScope(TestBMesh);
+		TestBMesh->RemoveVertex(RemovedVertex);
+		ensureMsgf(RemovedVertex->Index == 0, TEXT("removal is deferred until the scope ends"));
+	}
+	ensureMsgf(RemovedVertex->Index == INDEX_NONE, TEXT("removed vertex has no index"));
+	OriginalVertices.Remove(RemovedVertex);
+	CheckIndices(TEXT("deferred removals"));
+
+	FBMeshOperators::Subdivide(TestBMesh);
+	CheckIndices(TEXT("subdividing"));
+	FBMeshOperators::Merge(TestBMesh, TestBMesh->Clone());
+	CheckIndices(TEXT("merging"));
+	const FBMeshConnectedComponents Components = FBMeshOperators::ComputeConnectedComponents(TestBMesh, EBMeshConnectivity::Face);
+	ensureMsgf(Components.Num() == 2, TEXT("merged copy is its own component"));
+	FBMeshOperators::SortSpatially(TestBMesh);
+	CheckIndices(TEXT("sorting"));
+
+	for (UBMeshFace* Face : TestBMesh->Faces)
+	{
+		Face->Id = 7;
+	}
+	FBMeshOperators::SortFacesByFirstLoopId(TestBMesh);
+	CheckIndices(TEXT("sorting faces by first vertex"));
+	for (int32 i = 0; i < TestBMesh->Faces.Num(); ++i)
+	{
+		ensureMsgf(TestBMesh->Faces[i]->Id == 7, TEXT("sorting faces leaves their ids"));
+		ensureMsgf(i == 0 || TestBMesh->Faces[i - 1]->FirstLoop->Vert->Index <= TestBMesh->Faces[i]->FirstLoop->Vert->Index, TEXT("faces are sorted by the index of their first vertex"));
+	}
+
+	for (const UBMeshVertex* Vertex : OriginalVertices)
+	{
+		ensureMsgf(Vertex->Id == 42 && TestBMesh->Vertices[Vertex->Index] == Vertex, TEXT("ids are left to the user"));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Index test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::HandleTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	FBMeshOperators::SquareGrid(TestBMesh, 4, 4);
+
+	UBMeshFace* Cell = TestBMesh->Faces[6];
+	const FBMeshFaceHandle CellHandle = TestBMesh->GetFaceHandle(Cell);
+	UBMeshVertex* Corner = Cell->FirstLoop->Vert;
+	const FBMeshVertexHandle CornerHandle = TestBMesh->GetVertexHandle(Corner);
+	ensureMsgf(CellHandle.IsSet() && CornerHandle.IsSet(), TEXT("elements of the mesh have handles"));
+	ensureMsgf(TestBMesh->ResolveFaceHandle(CellHandle) == Cell, TEXT("face handle resolves"));
+	ensureMsgf(TestBMesh->ResolveVertexHandle(CornerHandle) == Corner, TEXT("vertex handle resolves"));
+	ensureMsgf(!TestBMesh->GetFaceHandle(nullptr).IsSet(), TEXT("null has no handle"));
+
+	TMap<FBMeshFaceHandle, int32> Visits;
+	Visits.Add(CellHandle, 1);
+	ensureMsgf(Visits.Contains(TestBMesh->GetFaceHandle(Cell)), TEXT("handles can be map keys"));
+
+	// Handles don't depend on the order of the containers
+	TestBMesh->RemoveFace(TestBMesh->Faces[0]);
+	FBMeshOperators::SortSpatially(TestBMesh);
+	ensureMsgf(TestBMesh->ResolveFaceHandle(CellHandle) == Cell, TEXT("face handle survives removals and sorting"));
+	ensureMsgf(TestBMesh->GetFaceHandle(Cell) == CellHandle, TEXT("face keeps its handle"));
+
+	// Removed elements don't resolve anymore, even once their slots are reused
+	TArray<UBMeshVertex*> CellVertices = Cell->NeighborVertices();
+	TestBMesh->RemoveFace(Cell);
+	ensureMsgf(TestBMesh->ResolveFaceHandle(CellHandle) == nullptr, TEXT("removed face doesn't resolve"));
+	UBMeshFace* NewCell = TestBMesh->AddFace(CellVertices);
+	const FBMeshFaceHandle NewCellHandle = TestBMesh->GetFaceHandle(NewCell);
+	ensureMsgf(NewCellHandle != CellHandle, TEXT("new face gets a new handle"));
+	ensureMsgf(TestBMesh->ResolveFaceHandle(CellHandle) == nullptr, TEXT("reused slot doesn't resolve old handles"));
+	ensureMsgf(TestBMesh->ResolveFaceHandle(NewCellHandle) == NewCell, TEXT("new face handle resolves"));
+
+	{
+		FBMeshDeferredRemovalScope RemovalScope(TestBMesh);
+		TestBMesh->RemoveVertex(Corner);
+		ensureMsgf(TestBMesh->ResolveVertexHandle(CornerHandle) == nullptr, TEXT("handles are stale as soon as removal is deferred"));
+	}
+	ensureMsgf(TestBMesh->ResolveVertexHandle(CornerHandle) == nullptr, TEXT("removed vertex doesn't resolve"));
+	ensureMsgf(TestBMesh->ResolveFaceHandle(NewCellHandle) == nullptr, TEXT("faces removed with a vertex don't resolve"));
+
+	UE_LOG(LogTemp, Log, TEXT("Handle test passed."));
+
+	MarkRenderStateDirty();
+}
+
+void UBMeshTestComponent::AttributeLayerTest()
+{
+	TestBMesh = UBMesh::Make(this);
+	FBMeshOperators::SquareGrid(TestBMesh, 4, 4);
+
+	// Every vertex stores its own location, which is linear, so it must still match after interpolation
+	TArrayView<FVector> Rest = TestBMesh->AddVertexAttribute<FVector>("Rest");
+	ensureMsgf(Rest.Num() == TestBMesh->Vertices.Num(), TEXT("layer has a value per vertex"));
+	for (const UBMeshVertex* Vertex : TestBMesh->Vertices)
+	{
+		Rest[Vertex->Index] = Vertex->Location;
+	}
+	TArrayView<FLinearColor> Color = TestBMesh->AddVertexAttribute<FLinearColor>("Color");
+	ensureMsgf(Color.Num() == TestBMesh->Vertices.Num() && Color[0] == FLinearColor(0, 0, 0, 0), TEXT("new layer is zeroed"));
+	ensureMsgf(TestBMesh->AddVertexAttribute<FVector>("Rest").Num() == TestBMesh->Vertices.Num(), TEXT("adding an existing layer returns it"));
+	ensureMsgf(TestBMesh->AddVertexAttribute<float>("Rest").Num() == 0, TEXT("layer with another type can't be added"));
+	ensureMsgf(TestBMesh->FindAttribute<float>(EBMeshElementType::Vertex, "Rest").Num() == 0, TEXT("layer isn't found with another type"));
+
+	auto CheckRest = [](const UBMesh* Mesh, const TCHAR* Step)
+	{
+		const TArray<FVector> Values = Mesh->GetVectorAttribute(EBMeshElementType::Vertex, "Rest");
+		if (!ensureMsgf(Values.Num() == Mesh->Vertices.Num(), TEXT("layer keeps a value per vertex after %s"), Step))
+			return;
+		for (const UBMeshVertex* Vertex : Mesh->Vertices)
+		{
+			if (!ensureMsgf(Values[Vertex->Index].Equals(Vertex->Location, 0.01f), TEXT("value follows its vertex after %s"), Step))
+				return;
+		}
+	};
+
+	TestBMesh->RemoveVertex(TestBMesh->Vertices[3]);
+	CheckRest(TestBMesh, TEXT("removal"));
+	{
+		FBMeshDeferredRemovalScope RemovalScope(TestBMesh);
+		TestBMesh->RemoveVertex(TestBMesh->Vertices[0]);
+		TestBMesh->RemoveVertex(TestBMesh->Vertices[10]);
+	}
+	CheckRest(TestBMesh, TEXT("deferred removal"));
+	FBMeshOperators::SortSpatially(TestBMesh);
+	CheckRest(TestBMesh, TEXT("sorting"));
+	FBMeshOperators::Subdivide(TestBMesh);
+	CheckRest(TestBMesh, TEXT("subdivision"));
+
+	UBMesh* Copy = TestBMesh->Clone(this);
+	CheckRest(Copy, TEXT("cloning"));
+	ensureMsgf(Copy->HasAttributeLayer(EBMeshElementType::Vertex, "Color"), TEXT("clone has all layers"));
+
+	// Layers are saved with the mesh and restored on load
+	TArray<uint8> Bytes;
+	FPackageLikeWriter Writer(Bytes);
+	TestBMesh->Serialize(Writer);
+	UBMesh* Loaded = UBMesh::Make(this);
+	{
+		FPackageLikeReader Reader(Bytes);
+		Reader.SetCustomVersions(Writer.GetCustomVersions());
+		Loaded->Serialize(Reader);
+		ensureMsgf(!Reader.IsError() && Reader.AtEnd(), TEXT("mesh with layers is loaded entirely"));
+	}
+	CheckRest(Loaded, TEXT("loading"));
+	ensureMsgf(Loaded->HasAttributeLayer(EBMeshElementType::Vertex, "Color"), TEXT("loaded mesh has all layers"));
+
+	// A layer whose size doesn't match its elements is discarded on load, and the next layers are still read
+	FBMeshAttributeLayers SavedLayers;
+	SavedLayers.Add<int32>("Short", 3);
+	TBMeshAttributeLayer<float>* Heights = SavedLayers.Add<float>("Height", 4);
+	Heights->Values = { 0.0f, 0.5f, 1.0f, 1.5f };
+	TArray<uint8> LayerBytes;
+	{
+		FPackageLikeWriter LayerWriter(LayerBytes);
+		SavedLayers.Serialize(LayerWriter, 4);
+	}
+	FBMeshAttributeLayers LoadedLayers;
+	{
+		FPackageLikeReader Reader(LayerBytes);
+		LoadedLayers.Serialize(Reader, 4);
+		ensureMsgf(!Reader.IsError() && Reader.AtEnd(), TEXT("mismatched layer is skipped without an error"));
+	}
+	ensureMsgf(LoadedLayers.Num() == 1 && LoadedLayers.Find("Short") == nullptr, TEXT("mismatched layer is discarded"));
+	const TBMeshAttributeLayer<float>* LoadedHeights = LoadedLayers.Find<float>("Height");
+	ensureMsgf(LoadedHeights && LoadedHeights->Values == Heights->Values, TEXT("layer after a discarded one is restored"));
+
+	// Enough edges that the lerps of subdivision are split in batches across threads (see LerpBatchSize)
+	UBMesh* Large = UBMesh::Make(this);
+	FBMeshOperators::SquareGrid(Large, 64, 64);
+	ensureMsgf(Large->Edges.Num() > 4096, TEXT("large grid has more edges than a lerp batch"));
+	TArrayView<FVector> LargeRest = Large->AddVertexAttribute<FVector>("Rest");
+	for (const UBMeshVertex* Vertex : Large->Vertices)
+	{
+		LargeRest[Vertex->Index] = Vertex->Location;
+	}
+	FBMeshOperators::Subdivide(Large);
+	CheckRest(Large, TEXT("subdividing a large grid"));
+
+	// Face layers from Blueprint
+	ensureMsgf(TestBMesh->AddAttributeLayer(EBMeshElementType::Face, "Material", EBMeshAttributeType::Int), TEXT("face layer is added"));
+	TArray<int32> Materials;
+	Materials.SetNumUninitialized(TestBMesh->Faces.Num());
+	for (int32 FaceIndex = 0; FaceIndex < Materials.Num(); ++FaceIndex)
+	{
+		Materials[FaceIndex] = TestBMesh->Faces[FaceIndex]->Id;
+	}
+	ensureMsgf(TestBMesh->SetIntAttribute(EBMeshElementType::Face, "Material", Materials), TEXT("face values are set"));
+	ensureMsgf(!TestBMesh->SetIntAttribute(EBMeshElementType::Face, "Material", TArray<int32>()), TEXT("values must match the faces"));
+	ensureMsgf(!TestBMesh->SetFloatAttribute(EBMeshElementType::Face, "Material", TArray<float>()), TEXT("values must match the layer type"));
+	FBMeshOperators::SortFacesByCenters(TestBMesh);
+	const TArray<int32> SortedMaterials = TestBMesh->GetIntAttribute(EBMeshElementType::Face, "Material");
+	for (const UBMeshFace* Face : TestBMesh->Faces)
+	{
+		if (!ensureMsgf(SortedMaterials[Face->Index] == Face->Id, TEXT("face value follows its face")))
+			break;
+	}
+	ensureMsgf(TestBMesh->RemoveAttributeLayer(EBMeshElementType::Face, "Material"), TEXT("layer is removed"));
+	ensureMsgf(!TestBMesh->HasAttributeLayer(EBMeshElementType::Face, "Material"), TEXT("removed layer is gone"));
+	ensureMsgf(TestBMesh->GetIntAttribute(EBMeshElementType::Face, "Material").Num() == 0, TEXT("removed layer has no values"));
+
+	UE_LOG(LogTemp, Log, TEXT("Attribute layer test passed."));
+
+	MarkRenderStateDirty();
+}
+
 FBoxSphereBounds UBMeshTestComponent::CalcBounds(const FTransform& LocalToWorld) const
 {
 	FBox BoundingBox(ForceInit);
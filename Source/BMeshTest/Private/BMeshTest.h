@@ -32,6 +32,8 @@
 #include "CoreMinimal.h"
 #include "Components/PrimitiveComponent.h"
 #include "BMeshVertex.h"
+#include "BMeshLoop.h"
+#include "BMeshFace.h"
 #include "BMeshTest.generated.h"
 
 class UBMesh;
@@ -46,6 +48,26 @@ public:
 	FLinearColor Color;
 };
 
+UCLASS()
+class UBMeshLoop_Test : public UBMeshLoop
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	FVector2D UV;
+};
+
+UCLASS()
+class UBMeshFace_Test : public UBMeshFace
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	FLinearColor Color;
+};
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class UBMeshTestComponent : public UPrimitiveComponent
 {
@@ -80,6 +102,81 @@ public:
 
 	UFUNCTION(CallInEditor, Category = "Tests")
 	void CustomClassLerpTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void FaceAutomatonTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void ConnectedComponentsTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void SpatialIndexTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void WeldVerticesTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void MergeTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void CloneTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void SerializationTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void MappedFileTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void FileIOTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void ConversionTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void MeshSectionTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void ImportTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void TriangulateTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void DecimateTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void LocalEditsTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void MergeRandomTrianglePairsTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void RemeshTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void ExtrudeInsetTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void DualTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void DelaunayVoronoiTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void LatticeTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void SortTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void IndexTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void HandleTest();
+
+	UFUNCTION(CallInEditor, Category = "Tests")
+	void AttributeLayerTest();
 	
 	FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const;
 